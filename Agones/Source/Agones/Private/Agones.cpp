@@ -1,22 +1,29 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 
 #include "IAgones.h"
-
-#if ENABLE_AGONES
-#include "grpc/support/time.h"
-#include "grpc++/grpc++.h"
-#include "sdk.h"
-#endif
+#include "AgonesSidecar.h"
+#include "AgonesGrpcSidecar.h"
+#include "AgonesWorker.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 
 class FAgones : public IAgones
 {
-#if ENABLE_AGONES
+	TUniquePtr<FAgonesWorker> Worker;
 
-	agones::SDK* AgonesSDK;
-#endif
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+	/** IAgones implementation */
+	virtual void Connect(const FAgonesCompleteDelegate& OnComplete) override;
+	virtual void Ready(const FAgonesCompleteDelegate& OnComplete) override;
+	virtual void Health(const FAgonesCompleteDelegate& OnComplete) override;
+	virtual void Shutdown(const FAgonesCompleteDelegate& OnComplete) override;
+	virtual void SetSidecar(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar) override;
+
+	void Enqueue(EAgonesCommand InType, const FAgonesCompleteDelegate& OnComplete);
+	static TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> CreateSidecar();
 };
 
 IMPLEMENT_MODULE( FAgones, Agones)
@@ -26,24 +33,69 @@ IMPLEMENT_MODULE( FAgones, Agones)
 void FAgones::StartupModule()
 {
 #if ENABLE_AGONES
-	
 	grpc::string out = grpc::Version();
 	FString ver = FString(ANSI_TO_TCHAR(out.c_str()));
-	UE_LOG(LogTemp, Warning, TEXT("FGRPC::StartupModule Version: %s "), *ver);
-	AgonesSDK = new agones::SDK();
+	UE_LOG(LogAgones, Log, TEXT("FGRPC::StartupModule Version: %s "), *ver);
 #endif
+	Worker = MakeUnique<FAgonesWorker>(CreateSidecar());
 }
 
 
 void FAgones::ShutdownModule()
 {
-#if ENABLE_AGONES
-	//if (AgonesSDK)
-	//{
-	//	delete AgonesSDK;
-	//	AgonesSDK = nullptr;
-	//}
-#endif
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	Worker.Reset();
+}
+
+TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> FAgones::CreateSidecar()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+#if ENABLE_AGONES
+	if (!FParse::Param(CommandLine, TEXT("AgonesFake")))
+	{
+		return MakeShareable(new FAgonesGrpcSidecar());
+	}
+#endif
+	float Latency = 0;
+	FParse::Value(CommandLine, TEXT("AgonesFakeLatency="), Latency);
+	const bool bFail = FParse::Param(CommandLine, TEXT("AgonesFakeFail"));
+	UE_LOG(LogAgones, Log, TEXT("Using fake Agones sidecar. Latency: %f Fail: %d"), Latency, bFail);
+	return MakeShareable(new FAgonesFakeSidecar(Latency, bFail));
+}
+
+void FAgones::Enqueue(EAgonesCommand InType, const FAgonesCompleteDelegate& OnComplete)
+{
+	if (!Worker.IsValid() || !Worker->Enqueue(InType, OnComplete))
+	{
+		UE_LOG(LogAgones, Verbose, TEXT("FAgones - command %d dropped."), (int32)InType);
+	}
+}
+
+void FAgones::Connect(const FAgonesCompleteDelegate& OnComplete)
+{
+	Enqueue(EAgonesCommand::Connect, OnComplete);
+}
+
+void FAgones::Ready(const FAgonesCompleteDelegate& OnComplete)
+{
+	Enqueue(EAgonesCommand::Ready, OnComplete);
+}
+
+void FAgones::Health(const FAgonesCompleteDelegate& OnComplete)
+{
+	Enqueue(EAgonesCommand::Health, OnComplete);
+}
+
+void FAgones::Shutdown(const FAgonesCompleteDelegate& OnComplete)
+{
+	Enqueue(EAgonesCommand::Shutdown, OnComplete);
+}
+
+void FAgones::SetSidecar(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar)
+{
+	if (Worker.IsValid())
+	{
+		Worker->SetSidecar(InSidecar);
+	}
 }
@@ -0,0 +1,56 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "AgonesSidecar.h"
+
+#if ENABLE_AGONES
+#include "grpc/support/time.h"
+#include "grpc++/grpc++.h"
+#include "sdk.h"
+
+/* Real sidecar, talking to Agones SDK server trough gRPC. */
+class FAgonesGrpcSidecar : public IAgonesSidecar
+{
+	TUniquePtr<agones::SDK> SDK;
+	bool bConnected;
+
+public:
+	FAgonesGrpcSidecar()
+		: SDK(new agones::SDK())
+		, bConnected(false)
+	{}
+
+	virtual bool Connect() override
+	{
+		bConnected = SDK->Connect();
+		return bConnected;
+	}
+	virtual bool Ready() override
+	{
+		if (!bConnected)
+			return false;
+		const grpc::Status Status = SDK->Ready();
+		if (!Status.ok())
+		{
+			UE_LOG(LogAgones, Warning, TEXT("Agones Ready failed: %s"), ANSI_TO_TCHAR(Status.error_message().c_str()));
+		}
+		return Status.ok();
+	}
+	virtual bool Health() override
+	{
+		return bConnected && SDK->Health();
+	}
+	virtual bool Shutdown() override
+	{
+		if (!bConnected)
+			return false;
+		const grpc::Status Status = SDK->Shutdown();
+		if (!Status.ok())
+		{
+			UE_LOG(LogAgones, Warning, TEXT("Agones Shutdown failed: %s"), ANSI_TO_TCHAR(Status.error_message().c_str()));
+		}
+		return Status.ok();
+	}
+};
+#endif
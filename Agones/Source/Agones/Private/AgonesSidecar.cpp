@@ -0,0 +1,64 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "AgonesSidecar.h"
+#include "HAL/PlatformProcess.h"
+
+DEFINE_LOG_CATEGORY(LogAgones);
+
+FAgonesFakeSidecar::FAgonesFakeSidecar()
+	: Latency(0)
+	, bFail(false)
+{
+}
+
+FAgonesFakeSidecar::FAgonesFakeSidecar(float InLatency, bool bInFail)
+	: Latency(InLatency)
+	, bFail(bInFail)
+{
+}
+
+bool FAgonesFakeSidecar::Simulate(const TCHAR* InCall)
+{
+	if (Latency > 0)
+	{
+		FPlatformProcess::Sleep(Latency);
+	}
+	UE_LOG(LogAgones, Verbose, TEXT("FAgonesFakeSidecar::%s %s"), InCall, bFail ? TEXT("failed") : TEXT("succeeded"));
+	return !bFail;
+}
+
+bool FAgonesFakeSidecar::Connect()
+{
+	if (!Simulate(TEXT("Connect")))
+		return false;
+
+	bConnected = true;
+	return true;
+}
+
+bool FAgonesFakeSidecar::Ready()
+{
+	if (!Simulate(TEXT("Ready")) || !bConnected)
+		return false;
+
+	bReady = true;
+	return true;
+}
+
+bool FAgonesFakeSidecar::Health()
+{
+	if (!Simulate(TEXT("Health")) || !bConnected)
+		return false;
+
+	HealthCount.Increment();
+	return true;
+}
+
+bool FAgonesFakeSidecar::Shutdown()
+{
+	if (!Simulate(TEXT("Shutdown")) || !bConnected)
+		return false;
+
+	bShutdown = true;
+	return true;
+}
@@ -0,0 +1,107 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "AgonesWorker.h"
+#include "AgonesSidecar.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+
+FAgonesWorker::FAgonesWorker(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar)
+	: Sidecar(InSidecar)
+	, WorkEvent(FPlatformProcess::GetSynchEventFromPool())
+	, Thread(nullptr)
+{
+	Thread = FRunnableThread::Create(this, TEXT("AgonesWorker"), 0, TPri_BelowNormal);
+}
+
+FAgonesWorker::~FAgonesWorker()
+{
+	if (Thread)
+	{
+		//waits for call in progress, commands still in queue are dropped.
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+bool FAgonesWorker::Enqueue(EAgonesCommand InType, const FAgonesCompleteDelegate& InOnComplete)
+{
+	if (bStopping)
+		return false;
+
+	if (InType == EAgonesCommand::Health && PendingHealth.Increment() > 1)
+	{
+		PendingHealth.Decrement();
+		return false;
+	}
+	Commands.Enqueue(FAgonesCommand(InType, InOnComplete));
+	WorkEvent->Trigger();
+	return true;
+}
+
+void FAgonesWorker::SetSidecar(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar)
+{
+	FScopeLock Lock(&SidecarLock);
+	Sidecar = InSidecar;
+}
+
+uint32 FAgonesWorker::Run()
+{
+	while (!bStopping)
+	{
+		FAgonesCommand Command;
+		if (!Commands.Dequeue(Command))
+		{
+			WorkEvent->Wait();
+			continue;
+		}
+
+		const bool bSuccess = Execute(Command.Type);
+		if (Command.Type == EAgonesCommand::Health)
+		{
+			PendingHealth.Decrement();
+		}
+		if (Command.OnComplete.IsBound())
+		{
+			FAgonesCompleteDelegate OnComplete = Command.OnComplete;
+			AsyncTask(ENamedThreads::GameThread, [OnComplete, bSuccess]()
+			{
+				OnComplete.ExecuteIfBound(bSuccess);
+			});
+		}
+	}
+	return 0;
+}
+
+void FAgonesWorker::Stop()
+{
+	bStopping = true;
+	WorkEvent->Trigger();
+}
+
+bool FAgonesWorker::Execute(EAgonesCommand InType)
+{
+	//keep sidecar alive for duration of call, even if it is replaced meanwhile.
+	TSharedPtr<IAgonesSidecar, ESPMode::ThreadSafe> LocalSidecar;
+	{
+		FScopeLock Lock(&SidecarLock);
+		LocalSidecar = Sidecar;
+	}
+
+	switch (InType)
+	{
+	case EAgonesCommand::Connect:
+		return LocalSidecar->Connect();
+	case EAgonesCommand::Ready:
+		return LocalSidecar->Ready();
+	case EAgonesCommand::Health:
+		return LocalSidecar->Health();
+	case EAgonesCommand::Shutdown:
+		return LocalSidecar->Shutdown();
+	}
+	return false;
+}
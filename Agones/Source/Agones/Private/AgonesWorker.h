@@ -0,0 +1,68 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "IAgones.h"
+
+class IAgonesSidecar;
+
+enum class EAgonesCommand : uint8
+{
+	Connect,
+	Ready,
+	Health,
+	Shutdown
+};
+
+struct FAgonesCommand
+{
+	EAgonesCommand Type;
+	FAgonesCompleteDelegate OnComplete;
+
+	FAgonesCommand()
+		: Type(EAgonesCommand::Health)
+	{}
+	FAgonesCommand(EAgonesCommand InType, const FAgonesCompleteDelegate& InOnComplete)
+		: Type(InType)
+		, OnComplete(InOnComplete)
+	{}
+};
+
+/*
+	Executes blocking sidecar calls on it's own thread, in order they were queued.
+	Completion delegates are executed on game thread.
+*/
+class FAgonesWorker : public FRunnable
+{
+	TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> Sidecar;
+	/* Guards Sidecar, which can be replaced from game thread. */
+	FCriticalSection SidecarLock;
+
+	TQueue<FAgonesCommand, EQueueMode::Mpsc> Commands;
+	FEvent* WorkEvent;
+	FRunnableThread* Thread;
+	FThreadSafeBool bStopping;
+	/* Health pings waiting in queue, so slow sidecar does not pile them up. */
+	FThreadSafeCounter PendingHealth;
+
+public:
+	FAgonesWorker(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar);
+	virtual ~FAgonesWorker();
+
+	/* Returns false if command has been dropped. */
+	bool Enqueue(EAgonesCommand InType, const FAgonesCompleteDelegate& InOnComplete);
+	void SetSidecar(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar);
+
+	/* FRunnable Begin */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	/* FRunnable End */
+
+private:
+	bool Execute(EAgonesCommand InType);
+};
@@ -0,0 +1,58 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAgones, Log, All);
+
+/*
+	Connection to Agones sidecar. All calls are blocking and are only ever made from Agones worker thread.
+*/
+class AGONES_API IAgonesSidecar
+{
+public:
+	virtual ~IAgonesSidecar() {}
+
+	virtual bool Connect() = 0;
+	virtual bool Ready() = 0;
+	virtual bool Health() = 0;
+	virtual bool Shutdown() = 0;
+};
+
+/*
+	In-process stand-in for Agones sidecar, so server can be run and tested without cluster.
+	Records every call and can simulate slow or failing sidecar.
+	Enabled by -AgonesFake, -AgonesFakeLatency=<seconds> and -AgonesFakeFail on command line.
+*/
+class AGONES_API FAgonesFakeSidecar : public IAgonesSidecar
+{
+public:
+	FAgonesFakeSidecar();
+	FAgonesFakeSidecar(float InLatency, bool bInFail);
+
+	virtual bool Connect() override;
+	virtual bool Ready() override;
+	virtual bool Health() override;
+	virtual bool Shutdown() override;
+
+	inline bool IsConnected() const { return bConnected; }
+	inline bool IsReady() const { return bReady; }
+	inline bool IsShutdown() const { return bShutdown; }
+	inline int32 GetHealthCount() const { return HealthCount.GetValue(); }
+
+private:
+	/* Delay of every call in seconds, to simulate slow sidecar. */
+	float Latency;
+	/* All calls fail. */
+	bool bFail;
+
+	FThreadSafeBool bConnected;
+	FThreadSafeBool bReady;
+	FThreadSafeBool bShutdown;
+	FThreadSafeCounter HealthCount;
+
+	bool Simulate(const TCHAR* InCall);
+};
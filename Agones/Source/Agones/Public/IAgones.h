@@ -4,10 +4,16 @@
 
 #include "ModuleManager.h"
 
+class IAgonesSidecar;
+
+/* Called on game thread, when SDK call has been finished by worker thread. */
+DECLARE_DELEGATE_OneParam(FAgonesCompleteDelegate, bool /*bSuccess*/);
 
 /**
  * The public interface to this module.  In most cases, this interface is only public to sibling modules 
  * within this plugin.
+ *
+ * All SDK calls are queued and executed on dedicated worker thread, so they never block game thread.
  */
 class IAgones : public IModuleInterface
 {
@@ -34,5 +40,20 @@ public:
 	{
 		return FModuleManager::Get().IsModuleLoaded( "Agones" );
 	}
+
+	/* Handshake with sidecar. Must be finished before any other call can succeed. */
+	virtual void Connect(const FAgonesCompleteDelegate& OnComplete) = 0;
+	/* Marks game server as ready to receive connections. */
+	virtual void Ready(const FAgonesCompleteDelegate& OnComplete) = 0;
+	/* Sends health ping. Ping is dropped if previous one is still waiting for sidecar. */
+	virtual void Health(const FAgonesCompleteDelegate& OnComplete = FAgonesCompleteDelegate()) = 0;
+	/* Marks game server as ready to shutdown. */
+	virtual void Shutdown(const FAgonesCompleteDelegate& OnComplete) = 0;
+
+	/*
+		Replaces sidecar used by worker thread. Commands which are already queued are executed
+		against new sidecar. Used to run against FAgonesFakeSidecar.
+	*/
+	virtual void SetSidecar(TSharedRef<IAgonesSidecar, ESPMode::ThreadSafe> InSidecar) = 0;
 };
 
@@ -20,6 +20,7 @@
 #include "AFCueManager.h"
 #include "Effects/GABlueprintLibrary.h"
 #include "Async.h"
+#include "HAL/IConsoleManager.h"
 
 #include "AFAbilityComponent.h"
 #include "AFEffectsComponent.h"
@@ -28,6 +29,20 @@
 DEFINE_STAT(STAT_ApplyEffect);
 DEFINE_STAT(STAT_ModifyAttribute);
 
+static int32 GAFMaxAttributeNotifiesPerRPC = 32;
+static FAutoConsoleVariableRef CVarAFMaxAttributeNotifiesPerRPC(
+	TEXT("af.MaxAttributeNotifiesPerRPC"),
+	GAFMaxAttributeNotifiesPerRPC,
+	TEXT("Maximum number of attribute change records sent to owning client in single RPC."),
+	ECVF_Default);
+
+static int32 GAFMaxAttributeNotifyRPCsPerTick = 4;
+static FAutoConsoleVariableRef CVarAFMaxAttributeNotifyRPCsPerTick(
+	TEXT("af.MaxAttributeNotifyRPCsPerTick"),
+	GAFMaxAttributeNotifyRPCsPerTick,
+	TEXT("Maximum number of attribute change RPCs sent by component per tick. Remaining records are sent on next tick."),
+	ECVF_Default);
+
 
 
 void FAFReplicatedAttributeItem::PreReplicatedRemove(const struct FAFReplicatedAttributeContainer& InArraySerializer)
@@ -111,18 +126,18 @@ void UAFAbilityComponent::NotifyInstigatorTargetAttributeChanged(const FAFAttrib
 	switch (NM)
 	{
 	case NM_Standalone:
-		ClientNotifyAttributeModifier(InData);
+		OnTargetAttributeModifed.Broadcast(InData);
 		break;
 	case NM_DedicatedServer:
 		ServerOnTargetAttributeModifed.Broadcast(InData);
-		ClientNotifyAttributeModifier(InData);
+		PendingAttributeNotifies.Add(FAFAttributeChangedRecord(InData));
 		break;
 	case NM_ListenServer:
 		ServerOnTargetAttributeModifed.Broadcast(InData);
-		ClientNotifyAttributeModifier(InData);
+		PendingAttributeNotifies.Add(FAFAttributeChangedRecord(InData));
 		break;
 	case NM_Client:
-		ClientNotifyAttributeModifier(InData);
+		OnTargetAttributeModifed.Broadcast(InData);
 		break;
 	case NM_MAX:
 		break;
@@ -130,9 +145,31 @@ void UAFAbilityComponent::NotifyInstigatorTargetAttributeChanged(const FAFAttrib
 		break;
 	}
 }
-void UAFAbilityComponent::ClientNotifyAttributeModifier_Implementation(const FAFAttributeChangedData& InData)
+void UAFAbilityComponent::FlushAttributeNotifies()
+{
+	if (PendingAttributeNotifies.Num() == 0)
+		return;
+
+	//large batch would not fit into single bunch, split it and leave the rest for next tick.
+	const int32 PerRPC = FMath::Max(GAFMaxAttributeNotifiesPerRPC, 1);
+	const int32 SentNum = FMath::Min(PendingAttributeNotifies.Num(), PerRPC * FMath::Max(GAFMaxAttributeNotifyRPCsPerTick, 1));
+
+	TArray<FAFAttributeChangedRecord> Batch;
+	Batch.Reserve(FMath::Min(PerRPC, SentNum));
+	for (int32 Start = 0; Start < SentNum; Start += PerRPC)
+	{
+		Batch.Reset();
+		Batch.Append(PendingAttributeNotifies.GetData() + Start, FMath::Min(PerRPC, SentNum - Start));
+		ClientNotifyAttributeModifiers(Batch);
+	}
+	PendingAttributeNotifies.RemoveAt(0, SentNum, false);
+}
+void UAFAbilityComponent::ClientNotifyAttributeModifiers_Implementation(const TArray<FAFAttributeChangedRecord>& InRecords)
 {
-	OnTargetAttributeModifed.Broadcast(InData);
+	for (const FAFAttributeChangedRecord& Record : InRecords)
+	{
+		OnTargetAttributeModifed.Broadcast(Record.ToChangedData());
+	}
 }
 void UAFAbilityComponent::GetAttributeStructTest(FGAAttribute Name)
 {
@@ -150,17 +187,17 @@ void UAFAbilityComponent::TickComponent(float DeltaTime, enum ELevelTick TickTyp
 	{
 		DefaultAttributes->Tick(DeltaTime);
 	}
+	FlushAttributeNotifies();
 }
 
 void UAFAbilityComponent::BeginPlay()
 {
 	Super::BeginPlay();
-	//FAFEffectTimerManager::Get();
 }
 void UAFAbilityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
-	
+	PendingAttributeNotifies.Reset();
 }
 void UAFAbilityComponent::DestroyComponent(bool bPromoteChildren)
 {
@@ -241,6 +278,14 @@ void UAFAbilityComponent::GetOwnedGameplayTags(FGameplayTagContainer& TagContain
 
 
 
+void UAFAbilityComponent::ResetAttributes()
+{
+	if (!DefaultAttributes)
+		return;
+
+	DefaultAttributes->ResetAttributes(Cast<UGAAttributesBase>(DefaultAttributes->GetArchetype()));
+}
+
 void UAFAbilityComponent::InitializeComponent()
 {
 	Super::InitializeComponent();
@@ -6,15 +6,41 @@
 #include "AFCueManager.h"
 #include "GameplayTagsManager.h"
 
-#include "Engine/ObjectLibrary.h"
+#include "Engine/AssetManager.h"
+
+#include "HAL/IConsoleManager.h"
 
 #if WITH_EDITOR
 #include "Editor.h"
 #endif
 
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs CmdTestCueActorPool(
+	TEXT("af.Cues.TestActorPool"),
+	TEXT("af.Cues.TestActorPool <CueTag>. Acquires actor cue, returns it to pool and checks that next acquire reuses it."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.Num() < 1)
+			return;
+		const FGameplayTag Tag = UGameplayTagsManager::Get().RequestGameplayTag(FName(*Args[0]), false);
+		UAFCueManager::Get()->TestActorPool(World, Tag);
+	}));
+#endif //!UE_BUILD_SHIPPING
+
 UAFCueManager* UAFCueManager::ManagerInstance = nullptr;
 //UWorld* UAFCueManager::CurrentWorld = nullptr;
 
+UAFCueManager::UAFCueManager(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	CurrentWorld = nullptr;
+	MaxResidentCues = 64;
+	MaxPooledCueActors = 8;
+	LruHead = INDEX_NONE;
+	LruTail = INDEX_NONE;
+	NumResident = 0;
+}
+
 UAFCueManager* UAFCueManager::Get()
 {
 	if (ManagerInstance)
@@ -36,36 +62,37 @@ void UAFCueManager::Initialize()
 	FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UAFCueManager::HandlePreLoadMap);
 	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UAFCueManager::HandlePostLoadMap);
 
-	StaticCues = UObjectLibrary::CreateLibrary(UAFCueStatic::StaticClass(), true, GIsEditor);
-	if (GIsEditor)
+	//asset manager has already scanned StaticCue and ActorCue primary assets, nothing is searched on disk here.
+	//in editor scan may still be running, registry is built once it's done.
+	if (UAssetManager* Manager = UAssetManager::GetIfValid())
 	{
-		StaticCues->bIncludeOnlyOnDiskAssets = true;
+		Manager->CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &UAFCueManager::BuildCueRegistry));
 	}
+}
+void UAFCueManager::BuildCueRegistry()
+{
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	if (!Manager || Cues.Num() > 0)
+		return;
 
-	TArray<FString> Paths;
-	Paths.Add("/Game");
-	StaticCues->LoadBlueprintAssetDataFromPaths(Paths, true);
-
-	TArray<FAssetData> StaticCueAssets;
-	StaticCues->GetAssetDataList(StaticCueAssets);
+	TArray<FAssetData> CueAssets;
+	Manager->GetPrimaryAssetDataList(FPrimaryAssetType("StaticCue"), CueAssets);
+	Manager->GetPrimaryAssetDataList(FPrimaryAssetType("ActorCue"), CueAssets);
 
+	//both cue types store their tag under the same searchable property name.
 	FName TagProperty = GET_MEMBER_NAME_CHECKED(UAFCueStatic, EffectCueTagSearch);
 	UGameplayTagsManager& TagManager = UGameplayTagsManager::Get();
 
-	for (const FAssetData& CueAsset : StaticCueAssets)
+	for (const FAssetData& CueAsset : CueAssets)
 	{
 		const FName Tag = CueAsset.GetTagValueRef<FName>(TagProperty);
 
 		if (!Tag.IsNone())
 		{
-			const FString GeneratedClassTag = CueAsset.GetTagValueRef<FString>(FBlueprintTags::GeneratedClassPath);
-
 			FGameplayTag ReqTag = TagManager.RequestGameplayTag(Tag);
-			FSoftObjectPath AssetPath;
-			AssetPath.SetPath(FPackageName::ExportTextPathToObjectPath(*GeneratedClassTag));
 			FAFCueData CueData;
 			CueData.CueTag = ReqTag;
-			CueData.AssetId = CueAsset.GetPrimaryAssetId();
+			CueData.AssetId = Manager->GetPrimaryAssetIdForData(CueAsset);
 			Cues.Add(CueData);
 		}
 	}
@@ -80,15 +107,42 @@ void UAFCueManager::Initialize()
 void UAFCueManager::HandleOnPIEEnd(bool InVal)
 {
 	CurrentWorld = nullptr;
+	ClearCueActors();
 }
 #endif //WITH_EDITOR
 void UAFCueManager::HandlePreLoadMap(const FString& InMapName)
 {
 	CurrentWorld = nullptr;
+	ClearCueActors();
+	//events from previous map are not going to be meaningful after load.
+	for (FAFCueData& Data : Cues)
+	{
+		Data.PendingEvents.Reset();
+	}
 }
 void UAFCueManager::HandlePostLoadMap(UWorld* InWorld)
 {
 	CurrentWorld = InWorld;
+
+	TArray<FName> OldMapGroups = MoveTemp(MapGroups);
+	MapGroups.Reset();
+	if (InWorld)
+	{
+		const FString MapName = UWorld::RemovePIEPrefix(InWorld->GetMapName());
+		for (const FAFCuePreloadGroup& Group : PreloadGroups)
+		{
+			if (Group.Maps.Contains(MapName))
+			{
+				PreloadGroup(Group.GroupName);
+				MapGroups.Add(Group.GroupName);
+			}
+		}
+	}
+	//release after preloading, so cues shared between maps are not unloaded in between.
+	for (const FName& GroupName : OldMapGroups)
+	{
+		ReleaseGroup(GroupName);
+	}
 }
 
 
@@ -98,45 +152,199 @@ void UAFCueManager::HandleCue(const FGameplayTagContainer& Tags
 {
 	if (!CurrentWorld)
 		CurrentWorld = CueParams.Instigator->GetWorld();
-	
 
-	if (UAssetManager* Manager = UAssetManager::GetIfValid())
+	for (const FGameplayTag& CueTag : Tags)
 	{
-		for (const FGameplayTag& CueTag : Tags)
-		{
-			int32 Idx = CuesMap[CueTag];
-			FAFCueData Data = Cues[Idx];
+		const int32* IdxPtr = CuesMap.Find(CueTag);
+		if (!IdxPtr)
+			continue;
 
-			if (Data.CueClass)
-			{
-				HandleCueEvent(Cues[Idx].CueClass, CueParams, CueEvent);
-			}
-			else //load cue asynchronously
-			{
-				FPrimaryAssetId PrimaryAssetId = Data.AssetId;
-				FPrimaryAssetTypeInfo Info;
-				if (Manager->GetPrimaryAssetTypeInfo(PrimaryAssetId.PrimaryAssetType, Info))
-				{
-					FStreamableDelegate StreamDelegate = FStreamableDelegate::CreateUObject(this, &UAFCueManager::OnFinishedLoad, Idx, Data.AssetId, CueParams, CueEvent);
-					TSharedPtr<FStreamableHandle> Handle = Manager->LoadPrimaryAsset(PrimaryAssetId, TArray<FName>(), StreamDelegate);				
-				}
-			}
+		const int32 Idx = *IdxPtr;
+		FAFCueData& Data = Cues[Idx];
+		if (Data.CueClass)
+		{
+			TouchResident(Idx);
+			HandleCueEvent(Data.CueClass, CueParams, CueEvent);
+		}
+		else //load cue asynchronously, events are played once it's loaded.
+		{
+			Data.PendingEvents.Add(FAFPendingCueEvent(CueParams, CueEvent));
+			LoadCue(Idx);
 		}
 	}
 }
 
-void UAFCueManager::OnFinishedLoad(int32 Idx
-	, FPrimaryAssetId InPrimaryAssetId
-	, FGAEffectCueParams CueParams
-	, EAFCueEvent CueEvent)
+void UAFCueManager::LoadCue(int32 Idx)
 {
+	FAFCueData& Data = Cues[Idx];
+	//already loaded or in flight, pending events will be played by load which is already running.
+	if (Data.CueClass || Data.bLoading)
+		return;
+
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	if (!Manager)
+	{
+		Data.PendingEvents.Reset();
+		return;
+	}
+
+	FPrimaryAssetTypeInfo Info;
+	if (!Manager->GetPrimaryAssetTypeInfo(Data.AssetId.PrimaryAssetType, Info))
+	{
+		Data.PendingEvents.Reset();
+		return;
+	}
+
+	Data.bLoading = true;
+	FStreamableDelegate StreamDelegate = FStreamableDelegate::CreateUObject(this, &UAFCueManager::OnFinishedLoad, Idx);
+	TSharedPtr<FStreamableHandle> Handle = Manager->LoadPrimaryAsset(Data.AssetId, TArray<FName>(), StreamDelegate);
+	//no handle means there was nothing to load (or load could not start), finish right away.
+	if (!Handle.IsValid())
+	{
+		OnFinishedLoad(Idx);
+	}
+}
+
+void UAFCueManager::OnFinishedLoad(int32 Idx)
+{
+	FAFCueData& Data = Cues[Idx];
+	if (!Data.bLoading)
+		return;
+	Data.bLoading = false;
+
 	if (UAssetManager* Manager = UAssetManager::GetIfValid())
 	{
-		UObject* CueClass = Manager->GetPrimaryAssetObject(InPrimaryAssetId);
-		size_t classSize = sizeof(*CueClass);
+		Data.CueClass = Cast<UClass>(Manager->GetPrimaryAssetObject(Data.AssetId));
+	}
+	if (!Data.CueClass)
+	{
+		UE_LOG(AbilityFramework, Warning, TEXT("UAFCueManager: failed to load cue %s"), *Data.CueTag.ToString());
+		Data.PendingEvents.Reset();
+		return;
+	}
+
+	LinkResident(Idx);
+
+	//events are played before eviction, which can unload this cue right away when pinned cues fill the cache.
+	UClass* CueClass = Data.CueClass;
+	TArray<FAFPendingCueEvent> Events = MoveTemp(Data.PendingEvents);
+	Data.PendingEvents.Reset();
+	for (const FAFPendingCueEvent& Event : Events)
+	{
+		HandleCueEvent(CueClass, Event.CueParams, Event.CueEvent);
+	}
+	EvictResidents();
+}
 
-		Cues[Idx].CueClass = Cast<UClass>(CueClass);
-		HandleCueEvent(Cues[Idx].CueClass, CueParams, CueEvent);
+void UAFCueManager::PreloadCues(const FGameplayTagContainer& InTags)
+{
+	for (const FGameplayTag& CueTag : InTags)
+	{
+		if (const int32* Idx = CuesMap.Find(CueTag))
+		{
+			Cues[*Idx].PinCount++;
+			LoadCue(*Idx);
+		}
+	}
+}
+void UAFCueManager::ReleaseCues(const FGameplayTagContainer& InTags)
+{
+	for (const FGameplayTag& CueTag : InTags)
+	{
+		if (const int32* Idx = CuesMap.Find(CueTag))
+		{
+			FAFCueData& Data = Cues[*Idx];
+			Data.PinCount = FMath::Max(Data.PinCount - 1, 0);
+		}
+	}
+	EvictResidents();
+}
+void UAFCueManager::PreloadGroup(const FName& InGroupName)
+{
+	if (const FAFCuePreloadGroup* Group = FindGroup(InGroupName))
+	{
+		PreloadCues(Group->CueTags);
+	}
+}
+void UAFCueManager::ReleaseGroup(const FName& InGroupName)
+{
+	if (const FAFCuePreloadGroup* Group = FindGroup(InGroupName))
+	{
+		ReleaseCues(Group->CueTags);
+	}
+}
+const FAFCuePreloadGroup* UAFCueManager::FindGroup(const FName& InGroupName) const
+{
+	return PreloadGroups.FindByPredicate([&InGroupName](const FAFCuePreloadGroup& Group)
+	{
+		return Group.GroupName == InGroupName;
+	});
+}
+
+void UAFCueManager::LinkResident(int32 Idx)
+{
+	FAFCueData& Data = Cues[Idx];
+	Data.LruPrev = INDEX_NONE;
+	Data.LruNext = LruHead;
+	if (LruHead != INDEX_NONE)
+	{
+		Cues[LruHead].LruPrev = Idx;
+	}
+	LruHead = Idx;
+	if (LruTail == INDEX_NONE)
+	{
+		LruTail = Idx;
+	}
+	NumResident++;
+}
+void UAFCueManager::UnlinkResident(int32 Idx)
+{
+	FAFCueData& Data = Cues[Idx];
+	if (Data.LruPrev != INDEX_NONE)
+	{
+		Cues[Data.LruPrev].LruNext = Data.LruNext;
+	}
+	else
+	{
+		LruHead = Data.LruNext;
+	}
+	if (Data.LruNext != INDEX_NONE)
+	{
+		Cues[Data.LruNext].LruPrev = Data.LruPrev;
+	}
+	else
+	{
+		LruTail = Data.LruPrev;
+	}
+	Data.LruPrev = INDEX_NONE;
+	Data.LruNext = INDEX_NONE;
+	NumResident--;
+}
+void UAFCueManager::TouchResident(int32 Idx)
+{
+	if (LruHead == Idx)
+		return;
+	UnlinkResident(Idx);
+	LinkResident(Idx);
+}
+void UAFCueManager::EvictResidents()
+{
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	int32 Idx = LruTail;
+	while (NumResident > MaxResidentCues && Idx != INDEX_NONE)
+	{
+		FAFCueData& Data = Cues[Idx];
+		const int32 PrevIdx = Data.LruPrev;
+		if (Data.PinCount == 0)
+		{
+			UnlinkResident(Idx);
+			Data.CueClass = nullptr;
+			if (Manager)
+			{
+				Manager->UnloadPrimaryAsset(Data.AssetId);
+			}
+		}
+		Idx = PrevIdx;
 	}
 }
 
@@ -148,6 +356,9 @@ void UAFCueManager::HandleRemoveCue(const FGameplayTagContainer& Tags,
 
 void UAFCueManager::HandleCueEvent(UClass* InCueClass, const FGAEffectCueParams& InCueParams, EAFCueEvent CueEvent)
 {
+	if (!InCueClass)
+		return;
+
 	if (UAFCueStatic* StaticCue = Cast<UAFCueStatic>(InCueClass->ClassDefaultObject))
 	{
 		switch (CueEvent)
@@ -169,8 +380,144 @@ void UAFCueManager::HandleCueEvent(UClass* InCueClass, const FGAEffectCueParams&
 		}
 		
 	}
-	else if (AAFCueActor* ActorCue = Cast<AAFCueActor>(InCueClass->ClassDefaultObject))
+	else if (AAFCueActor* DefaultCue = Cast<AAFCueActor>(InCueClass->ClassDefaultObject))
+	{
+		AActor* Target = InCueParams.HitResult.GetActor();
+		const FAFCueActorKey Key(InCueParams.Instigator.Get(), Target, DefaultCue->GetCueTag());
+		TWeakObjectPtr<AAFCueActor>* Found = InstancedCues.Find(Key);
+		AAFCueActor* ActorCue = Found ? Found->Get() : nullptr;
+
+		switch (CueEvent)
+		{
+		case Activated:
+			if (!ActorCue)
+			{
+				ActorCue = AcquireCueActor(InCueClass, InCueParams);
+				if (!ActorCue)
+					break;
+				ActorCue->bInstanced = true;
+				InstancedCues.Add(Key, ActorCue);
+			}
+			ActorCue->NativeBeginCue(InCueParams.Instigator.Get(), Target, InCueParams.Causer.Get(), InCueParams.HitResult, InCueParams);
+			break;
+		case Executed:
+			if (ActorCue)
+			{
+				ActorCue->NativeOnExecuted();
+			}
+			else //one shot cue, goes back to pool when sequence ends.
+			{
+				ActorCue = AcquireCueActor(InCueClass, InCueParams);
+				if (!ActorCue)
+					break;
+				ActorCue->NativeBeginCue(InCueParams.Instigator.Get(), Target, InCueParams.Causer.Get(), InCueParams.HitResult, InCueParams);
+				ActorCue->NativeOnExecuted();
+				ActorCue->ReleaseWhenFinished();
+			}
+			break;
+		case Expire:
+		case Removed:
+			InstancedCues.Remove(Key);
+			if (ActorCue)
+			{
+				if (CueEvent == Expire)
+				{
+					ActorCue->NativeOnExpired();
+				}
+				else
+				{
+					ActorCue->NativeOnRemoved();
+				}
+				ActorCue->ReleaseWhenFinished();
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+AAFCueActor* UAFCueManager::AcquireCueActor(UClass* InCueClass, const FGAEffectCueParams& InCueParams)
+{
+	UWorld* World = CurrentWorld;
+	if (!World)
+		return nullptr;
+
+	const FVector Location = InCueParams.HitResult.Location;
+	if (FAFCueActorPool* Pool = CueActorPools.Find(InCueClass))
 	{
+		while (Pool->Actors.Num() > 0)
+		{
+			AAFCueActor* Actor = Pool->Actors.Pop(false);
+			if (IsValid(Actor) && Actor->GetWorld() == World)
+			{
+				Actor->SetActorLocation(Location);
+				Actor->OnTakenFromPool();
+				return Actor;
+			}
+		}
+	}
 
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AAFCueActor>(InCueClass, Location, FRotator::ZeroRotator, SpawnParams);
+}
+void UAFCueManager::ReleaseCueActor(AAFCueActor* InActor)
+{
+	if (!IsValid(InActor) || InActor->bInPool)
+		return;
+
+	InActor->OnReturnedToPool();
+	FAFCueActorPool& Pool = CueActorPools.FindOrAdd(InActor->GetClass());
+	if (Pool.Actors.Num() >= MaxPooledCueActors)
+	{
+		InActor->Destroy();
+		return;
+	}
+	InActor->bInPool = true;
+	Pool.Actors.Add(InActor);
+}
+void UAFCueManager::ClearCueActors()
+{
+	//actors are destroyed with their world, just forget about them.
+	CueActorPools.Reset();
+	InstancedCues.Reset();
+}
+#if !UE_BUILD_SHIPPING
+bool UAFCueManager::TestActorPool(UWorld* InWorld, const FGameplayTag& InTag)
+{
+	const int32* Idx = CuesMap.Find(InTag);
+	if (!Idx)
+	{
+		UE_LOG(AbilityFramework, Warning, TEXT("UAFCueManager: %s is not registered cue"), *InTag.ToString());
+		return false;
 	}
-}
\ No newline at end of file
+	const FAFCueData& Data = Cues[*Idx];
+	UClass* CueClass = Data.CueClass;
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	if (!CueClass && Manager)
+	{
+		CueClass = Cast<UClass>(Manager->GetPrimaryAssetPath(Data.AssetId).TryLoad());
+	}
+	if (!CueClass || !CueClass->IsChildOf(AAFCueActor::StaticClass()))
+	{
+		UE_LOG(AbilityFramework, Warning, TEXT("UAFCueManager: %s is not actor cue"), *InTag.ToString());
+		return false;
+	}
+	if (!CurrentWorld)
+	{
+		CurrentWorld = InWorld;
+	}
+
+	FGAEffectCueParams Params;
+	AAFCueActor* First = AcquireCueActor(CueClass, Params);
+	ReleaseCueActor(First);
+	AAFCueActor* Second = AcquireCueActor(CueClass, Params);
+	ReleaseCueActor(Second);
+
+	const bool bReused = First && First == Second;
+	UE_LOG(AbilityFramework, Log, TEXT("UAFCueManager: actor pool for %s %s"), *InTag.ToString()
+		, bReused ? TEXT("reused pooled actor") : TEXT("did not reuse pooled actor"));
+	return bReused;
+}
+#endif //!UE_BUILD_SHIPPING
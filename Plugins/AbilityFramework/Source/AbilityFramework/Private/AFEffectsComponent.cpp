@@ -14,6 +14,8 @@
 #include "AFCueManager.h"
 #include "Effects/GABlueprintLibrary.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("EffectArrayDirty"), STAT_EffectArrayDirty, STATGROUP_GameEffect);
+
 // Sets default values for this component's properties
 UAFEffectsComponent::UAFEffectsComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -21,7 +23,7 @@ UAFEffectsComponent::UAFEffectsComponent(const FObjectInitializer& ObjectInitial
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
-
+	bEffectArrayDirty = false;
 	// ...
 }
 
@@ -41,6 +43,17 @@ void UAFEffectsComponent::InitializeComponent()
 	GameEffectContainer.OwningComponent = this;
 }
 
+void UAFEffectsComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	if (bEffectArrayDirty)
+	{
+		INC_DWORD_STAT(STAT_EffectArrayDirty);
+		GameEffectContainer.MarkArrayDirty();
+		bEffectArrayDirty = false;
+	}
+}
+
 // Called every frame
 void UAFEffectsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
@@ -75,9 +88,8 @@ FGAEffectHandle UAFEffectsComponent::ApplyEffectToSelf(
 		Delegate->ExecuteIfBound();
 	}
 
-	FGAEffectHandle Handle = GameEffectContainer.ApplyEffect(EffectIn, Params, Modifier);
-	GameEffectContainer.MarkArrayDirty();
-	return Handle;
+	//container defers dirty mark to PreReplication, so applying many effects in one frame rebuilds array once.
+	return GameEffectContainer.ApplyEffect(EffectIn, Params, Modifier);
 }
 
 FGAEffectHandle UAFEffectsComponent::ApplyEffectToTarget(
@@ -119,10 +131,9 @@ FGAEffectHandle UAFEffectsComponent::ApplyEffectToTarget(
 }
 
 
-/* Have to to copy handle around, because timer delegates do not support references. */
-void UAFEffectsComponent::ExecuteEffect(FGAEffectHandle HandleIn
-	, FAFEffectParams Params
-	, FAFFunctionModifier Modifier)
+void UAFEffectsComponent::ExecuteEffect(const FGAEffectHandle& HandleIn
+	, const FAFEffectParams& Params
+	, const FAFFunctionModifier& Modifier)
 {
 	const FGAEffectContext& Context = Params.Context;
 	FGAEffectProperty& Property = Params.Property.GetRef();
@@ -135,7 +146,7 @@ void UAFEffectsComponent::ExecuteEffect(FGAEffectHandle HandleIn
 	const FGameplayTagContainer& ExecutionDenyTags = Property.GetSpecData()->ExecutionDenyTags;
 	if (ExecutionDenyTags.Num() > 0)
 	{
-		if (HasAny(ExecutionDenyTags))
+		if (HasAny(Property.GetSpecData()->GetExecutionDenyMask()))
 		{
 			UE_LOG(GameAttributesEffects, Log, TEXT("UAFEffectsComponent:: Effect %s not executed, execution denyied by tags: %s"), *Property.GetSpecData()->GetName(), *ExecutionDenyTags.ToString());
 			return;
@@ -175,8 +186,8 @@ void UAFEffectsComponent::PostExecuteEffect()
 
 }
 /* ExpireEffect is used to remove existing effect naturally when their time expires. */
-void UAFEffectsComponent::ExpireEffect(FGAEffectHandle HandleIn
-	, FAFEffectParams Params)
+void UAFEffectsComponent::ExpireEffect(const FGAEffectHandle& HandleIn
+	, const FAFEffectParams& Params)
 {
 	//call effect internal delegate:
 	FGAEffectProperty& InProperty = Params.GetProperty();
@@ -204,7 +215,7 @@ void UAFEffectsComponent::ExpireEffect(FGAEffectHandle HandleIn
 		}
 	}
 
-	TArray<FGAEffectHandle> handles = GameEffectContainer.RemoveEffect(Params.Property, InContext);
+	GameEffectContainer.RemoveEffectByHandle(HandleIn, InContext, Params.Property);
 }
 
 void UAFEffectsComponent::ClientExpireEffect_Implementation(FAFPredictionHandle PredictionHandle)
@@ -397,6 +408,14 @@ bool UAFEffectsComponent::IsEffectActive(const FGAEffectHandle& InHandle) const
 	return GameEffectContainer.IsEffectActive(InHandle);
 }
 
+void UAFEffectsComponent::ResetEffects()
+{
+	GameEffectContainer.ResetEffects();
+	EffectToCue.Reset();
+	AppliedTags.Reset();
+	ImmunityTags.Reset();
+}
+
 bool UAFEffectsComponent::DenyEffectApplication(const FGameplayTagContainer& InTags)
 {
 	bool bDenyApplication = false;
@@ -419,7 +438,7 @@ bool UAFEffectsComponent::HaveEffectRquiredTags(const FGameplayTagContainer& InT
 
 FGAEffect* UAFEffectsComponent::GetEffect(const FGAEffectHandle& InHandle)
 {
-	return *GameEffectContainer.ActiveEffects.Find(InHandle);
+	return GameEffectContainer.GetEffect(InHandle);
 }
 
 /*
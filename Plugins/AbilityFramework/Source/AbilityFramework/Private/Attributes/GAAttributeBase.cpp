@@ -20,7 +20,6 @@ FAFAttributeBase::FAFAttributeBase()
 	: BaseBonusValue(0)
 	, CurrentValue(0)
 {
-	Modifiers.AddDefaulted(7);
 };
 FAFAttributeBase::FAFAttributeBase(float BaseValueIn)
 	: BaseValue(BaseValueIn)
@@ -28,7 +27,6 @@ FAFAttributeBase::FAFAttributeBase(float BaseValueIn)
 	, CurrentValue(BaseValue)
 	
 {
-	Modifiers.AddDefaulted(7);
 };
 
 
@@ -37,9 +35,7 @@ void FAFAttributeBase::InitializeAttribute(UAFAbilityComponent* InComponent, con
 	CurrentValue = BaseValue;
 	CalculateBonus();
 	CurrentValue = GetFinalValue();
-	Modifiers.Empty();
-	Modifiers.AddDefaulted(7);// static_cast<int32>(EGAAttributeMod::Invalid));
-	//Modifiers.AddDefaulted(static_cast<int32>(EGAAttributeMod::Invalid));
+	Modifiers.Reset();
 	AbilityComp = InComponent;
 	SelfName = FGAAttribute(InAttributeName);
 }
@@ -61,31 +57,10 @@ void FAFAttributeBase::CopyFromOther(FAFAttributeBase* Other)
 void FAFAttributeBase::CalculateBonus()
 {
 	SCOPE_CYCLE_COUNTER(STAT_CalculateBonus);
-	float AdditiveBonus = 0;
-	float SubtractBonus = 0;
-	float MultiplyBonus = 1;
-	float DivideBonus = 1;
-	//auto ModIt = Modifiers.CreateConstIterator();
-	TMap<FGAEffectHandle, FGAEffectMod>& Additive = Modifiers[static_cast<int32>(EGAAttributeMod::Add)];
-	TMap<FGAEffectHandle, FGAEffectMod>& Subtractive = Modifiers[static_cast<int32>(EGAAttributeMod::Subtract)];
-	TMap<FGAEffectHandle, FGAEffectMod>& Multiplicative = Modifiers[static_cast<int32>(EGAAttributeMod::Multiply)];
-	TMap<FGAEffectHandle, FGAEffectMod>& Divide = Modifiers[static_cast<int32>(EGAAttributeMod::Divide)];
-	for (auto ModIt = Additive.CreateConstIterator(); ModIt; ++ModIt)
-	{
-		AdditiveBonus += ModIt->Value.Value;
-	}
-	for (auto ModIt = Subtractive.CreateConstIterator(); ModIt; ++ModIt)
-	{
-		SubtractBonus += ModIt->Value.Value;
-	}
-	for (auto ModIt = Multiplicative.CreateConstIterator(); ModIt; ++ModIt)
-	{
-		MultiplyBonus += ModIt->Value.Value;
-	}
-	for (auto ModIt = Divide.CreateConstIterator(); ModIt; ++ModIt)
-	{
-		DivideBonus += ModIt->Value.Value;
-	}
+	const float AdditiveBonus = Modifiers.Get(EGAAttributeMod::Add).Sum;
+	const float SubtractBonus = Modifiers.Get(EGAAttributeMod::Subtract).Sum;
+	const float MultiplyBonus = 1 + Modifiers.Get(EGAAttributeMod::Multiply).Sum;
+	const float DivideBonus = 1 + Modifiers.Get(EGAAttributeMod::Divide).Sum;
 
 	float OldBonus = BaseBonusValue;
 	//calculate final bonus from modifiers values.
@@ -142,11 +117,13 @@ void FAFAttributeBase::CalculateBonus()
 
 bool FAFAttributeBase::CheckIfStronger(const FGAEffectMod& InMod)
 {
-	TMap<FGAEffectHandle, FGAEffectMod>& mods = Modifiers[static_cast<int32>(InMod.AttributeMod)];
-	auto It = mods.CreateConstIterator();
-	for (; It; ++It)
+	if (!FAFAttributeModifiers::IsValidMod(InMod.AttributeMod))
+		return false;
+
+	const FAFAttributeModifierStack& mods = Modifiers.Get(InMod.AttributeMod);
+	for (float Value : mods.Values)
 	{
-		if (InMod > It->Value)
+		if (InMod.Value > Value)
 		{
 			return true;
 		}
@@ -241,15 +218,64 @@ float FAFAttributeBase::Modify(const FGAEffectMod& ModIn, const FGAEffectHandle&
 
 void FAFAttributeBase::AddBonus(const FGAEffectMod& ModIn, const FGAEffectHandle& Handle)
 {
-	TMap<FGAEffectHandle, FGAEffectMod>& mods = Modifiers[static_cast<int32>(ModIn.AttributeMod)];
-	FGAEffectMod& modsTemp = mods.FindOrAdd(Handle);
-	modsTemp = ModIn;
+	if (!FAFAttributeModifiers::IsValidMod(ModIn.AttributeMod))
+		return;
+
+	Modifiers.Get(ModIn.AttributeMod).Add(Handle, ModIn.Value);
 	CalculateBonus();
 }
 void FAFAttributeBase::RemoveBonus(const FGAEffectHandle& Handle, EGAAttributeMod InMod)
 {
-	TMap<FGAEffectHandle, FGAEffectMod>& mods = Modifiers[static_cast<int32>(InMod)];
-	mods.Remove(Handle);
-	//Modifiers.Remove(Handle);
-	CalculateBonus();
+	if (!FAFAttributeModifiers::IsValidMod(InMod))
+		return;
+
+	if (Modifiers.Get(InMod).Remove(Handle))
+	{
+		CalculateBonus();
+	}
+}
+
+void FAFAttributeModifierStack::Add(const FGAEffectHandle& InHandle, float InValue)
+{
+	if (int32* Index = IndexByHandle.Find(InHandle))
+	{
+		Sum += InValue - Values[*Index];
+		Values[*Index] = InValue;
+		return;
+	}
+	IndexByHandle.Add(InHandle, Values.Num());
+	Handles.Add(InHandle);
+	Values.Add(InValue);
+	Sum += InValue;
+}
+bool FAFAttributeModifierStack::Remove(const FGAEffectHandle& InHandle)
+{
+	int32 Index = INDEX_NONE;
+	if (!IndexByHandle.RemoveAndCopyValue(InHandle, Index))
+		return false;
+
+	Sum -= Values[Index];
+	const int32 LastIndex = Values.Num() - 1;
+	if (Index != LastIndex)
+	{
+		Handles[Index] = Handles[LastIndex];
+		Values[Index] = Values[LastIndex];
+		IndexByHandle[Handles[Index]] = Index;
+	}
+	Handles.RemoveAt(LastIndex, 1, false);
+	Values.RemoveAt(LastIndex, 1, false);
+
+	//empty stack have exactly no bonus, whatever rounding error have accumulated.
+	if (Values.Num() == 0)
+	{
+		Sum = 0;
+	}
+	return true;
+}
+void FAFAttributeModifierStack::Reset()
+{
+	Handles.Reset();
+	Values.Reset();
+	IndexByHandle.Reset();
+	Sum = 0;
 }
\ No newline at end of file
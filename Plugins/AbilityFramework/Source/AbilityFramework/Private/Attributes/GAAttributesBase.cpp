@@ -6,17 +6,293 @@
 #include "Net/UnrealNetwork.h"
 #include "GAAttributesBase.h"
 
+TMap<FObjectKey, TUniquePtr<FAFAttributeIndexTable>> FAFAttributeIndexTable::Tables;
+uint32 FAFAttributeIndexTable::NextSerial = 1;
+uint32 FAFAttributeIndexTable::Generation = 0;
+
+const FAFAttributeIndexTable& FAFAttributeIndexTable::Get(UClass* InClass)
+{
+	check(InClass);
+	TUniquePtr<FAFAttributeIndexTable>& Table = Tables.FindOrAdd(FObjectKey(InClass));
+	if (!Table.IsValid())
+	{
+		Table = MakeUnique<FAFAttributeIndexTable>();
+		Table->Serial = NextSerial++;
+		Table->Build(InClass);
+	}
+	return *Table;
+}
+
+void FAFAttributeIndexTable::Reset()
+{
+	Tables.Empty();
+	Generation++;
+}
+
+void FAFAttributeIndexTable::Build(UClass* InClass)
+{
+	for (TFieldIterator<UProperty> PropIt(InClass, EFieldIteratorFlags::IncludeSuper); PropIt; ++PropIt)
+	{
+		UProperty* Prop = *PropIt;
+		if (UStructProperty* StructProp = Cast<UStructProperty>(Prop))
+		{
+			if (!StructProp->Struct->IsChildOf(FAFAttributeBase::StaticStruct()))
+				continue;
+		}
+		else if (!Prop->IsA<UNumericProperty>())
+		{
+			continue;
+		}
+
+		const int32 Index = Properties.Add(Prop);
+		Names.Add(Prop->GetFName());
+		Offsets.Add(Prop->GetOffset_ForInternal());
+		Indexes.Add(Prop->GetFName(), Index);
+		if (Prop->IsA<UStructProperty>())
+		{
+			StructAttributes.Add(Index);
+		}
+	}
+	BuildNetFields(InClass);
+}
+
+void FAFAttributeIndexTable::BuildNetFields(UClass* InClass)
+{
+	UGAAttributesBase* Defaults = Cast<UGAAttributesBase>(InClass->GetDefaultObject());
+	if (!Defaults)
+		return;
+
+	TArray<FAFQuantizedAttribute> Attributes;
+	Defaults->GetQuantizedAttributes(Attributes);
+	for (const FAFQuantizedAttribute& Attribute : Attributes)
+	{
+		const int32 Index = Find(FGAAttribute(Attribute.Name));
+		if (Index == INDEX_NONE)
+		{
+			UE_LOG(AFAttributes, Warning, TEXT("%s: quantized attribute %s does not exist."), *InClass->GetName(), *Attribute.Name.ToString());
+			continue;
+		}
+
+		FAFQuantizedField Field;
+		Field.Attribute = Index;
+		Field.Precision = Attribute.Precision;
+		Field.Property = nullptr;
+		if (IsStructAttribute(Index))
+		{
+			//current value goes first, it's the one which changes most often.
+			const int32 StructFields[] =
+			{
+				STRUCT_OFFSET(FAFAttributeBase, CurrentValue),
+				STRUCT_OFFSET(FAFAttributeBase, BaseValue),
+				STRUCT_OFFSET(FAFAttributeBase, BaseBonusValue),
+				STRUCT_OFFSET(FAFAttributeBase, MinValue),
+				STRUCT_OFFSET(FAFAttributeBase, MaxValue),
+				STRUCT_OFFSET(FAFAttributeBase, BonusMaxValue)
+			};
+			for (int32 FieldOffset : StructFields)
+			{
+				Field.Offset = Offsets[Index] + FieldOffset;
+				NetFields.Add(Field);
+			}
+		}
+		else
+		{
+			Field.Offset = Offsets[Index];
+			Field.Property = Cast<UNumericProperty>(Properties[Index]);
+			NetFields.Add(Field);
+		}
+	}
+}
+
+namespace
+{
+	class FAFQuantizedAttributeBaseState : public INetDeltaBaseState
+	{
+	public:
+		TArray<int32> Values;
+
+		virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+		{
+			return Values == static_cast<FAFQuantizedAttributeBaseState*>(OtherState)->Values;
+		}
+	};
+
+	inline bool IsIntegerField(const FAFQuantizedField& Field)
+	{
+		return Field.Property && !Field.Property->IsFloatingPoint();
+	}
+	inline bool IsFullFloatField(const FAFQuantizedField& Field)
+	{
+		return !IsIntegerField(Field) && Field.Precision <= 0;
+	}
+
+	int32 QuantizeField(const FAFQuantizedField& Field, const uint8* InObject)
+	{
+		const void* ValuePtr = InObject + Field.Offset;
+		if (IsIntegerField(Field))
+		{
+			return static_cast<int32>(Field.Property->GetSignedIntPropertyValue(ValuePtr));
+		}
+
+		const float Value = Field.Property
+			? static_cast<float>(Field.Property->GetFloatingPointPropertyValue(ValuePtr))
+			: *static_cast<const float*>(ValuePtr);
+		if (Field.Precision <= 0)
+		{
+			int32 Bits = 0;
+			FMemory::Memcpy(&Bits, &Value, sizeof(float));
+			return Bits;
+		}
+		//keep away from int32 limits, RoundToInt is undefined there.
+		const float MaxQuantized = 1 << 30;
+		return FMath::RoundToInt(FMath::Clamp(Value / Field.Precision, -MaxQuantized, MaxQuantized));
+	}
+
+	void DequantizeField(const FAFQuantizedField& Field, int32 InQuantized, uint8* InObject)
+	{
+		void* ValuePtr = InObject + Field.Offset;
+		if (IsIntegerField(Field))
+		{
+			Field.Property->SetIntPropertyValue(ValuePtr, static_cast<int64>(InQuantized));
+			return;
+		}
+
+		float Value = 0;
+		if (Field.Precision <= 0)
+		{
+			FMemory::Memcpy(&Value, &InQuantized, sizeof(float));
+		}
+		else
+		{
+			Value = InQuantized * Field.Precision;
+		}
+
+		if (Field.Property)
+		{
+			Field.Property->SetFloatingPointPropertyValue(ValuePtr, static_cast<double>(Value));
+		}
+		else
+		{
+			*static_cast<float*>(ValuePtr) = Value;
+		}
+	}
+
+	void SerializeFieldValue(FArchive& Ar, const FAFQuantizedField& Field, int32& InOutValue)
+	{
+		if (IsFullFloatField(Field))
+		{
+			Ar << InOutValue;
+			return;
+		}
+		//zigzag encoded, so small negative values are packed as tightly as positive ones.
+		uint32 Packed = (uint32(InOutValue) << 1) ^ uint32(InOutValue >> 31);
+		Ar.SerializeIntPacked(Packed);
+		InOutValue = int32(Packed >> 1) ^ -int32(Packed & 1);
+	}
+}
+
+bool FAFQuantizedAttributeState::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	if (!Owner)
+		return false;
+
+	const TArray<FAFQuantizedField>& Fields = Owner->GetAttributeTable().NetFields;
+	uint8* Object = reinterpret_cast<uint8*>(Owner);
+
+	if (DeltaParms.Writer)
+	{
+		if (Fields.Num() == 0)
+			return false;
+
+		FAFQuantizedAttributeBaseState* OldState = static_cast<FAFQuantizedAttributeBaseState*>(DeltaParms.OldState);
+		TSharedPtr<FAFQuantizedAttributeBaseState> NewState = MakeShareable(new FAFQuantizedAttributeBaseState());
+		NewState->Values.SetNumUninitialized(Fields.Num());
+
+		TArray<int32, TInlineAllocator<32>> ChangedFields;
+		for (int32 Idx = 0; Idx < Fields.Num(); Idx++)
+		{
+			NewState->Values[Idx] = QuantizeField(Fields[Idx], Object);
+			if (!OldState || !OldState->Values.IsValidIndex(Idx) || OldState->Values[Idx] != NewState->Values[Idx])
+			{
+				ChangedFields.Add(Idx);
+			}
+		}
+		//nothing changed since last acknowledged state, set stays dormant.
+		if (ChangedFields.Num() == 0)
+			return false;
+
+		*DeltaParms.NewState = NewState;
+
+		FBitWriter& Writer = *DeltaParms.Writer;
+		uint32 NumChanged = ChangedFields.Num();
+		Writer.SerializeIntPacked(NumChanged);
+		int32 LastIdx = INDEX_NONE;
+		for (int32 Idx : ChangedFields)
+		{
+			uint32 Skip = Idx - LastIdx - 1;
+			Writer.SerializeIntPacked(Skip);
+			LastIdx = Idx;
+
+			int32 Value = NewState->Values[Idx];
+			SerializeFieldValue(Writer, Fields[Idx], Value);
+		}
+		return true;
+	}
+	else if (DeltaParms.Reader)
+	{
+		FBitReader& Reader = *DeltaParms.Reader;
+		uint32 NumChanged = 0;
+		Reader.SerializeIntPacked(NumChanged);
+
+		TArray<int32> ChangedAttributes;
+		int32 LastIdx = INDEX_NONE;
+		for (uint32 Count = 0; Count < NumChanged; Count++)
+		{
+			uint32 Skip = 0;
+			Reader.SerializeIntPacked(Skip);
+			const int32 Idx = LastIdx + 1 + static_cast<int32>(Skip);
+			if (Reader.IsError() || !Fields.IsValidIndex(Idx))
+			{
+				UE_LOG(AFAttributes, Warning, TEXT("%s: received invalid quantized attribute."), *Owner->GetName());
+				Reader.SetError();
+				return false;
+			}
+			LastIdx = Idx;
+
+			int32 Value = 0;
+			SerializeFieldValue(Reader, Fields[Idx], Value);
+			if (Reader.IsError())
+				return false;
+
+			DequantizeField(Fields[Idx], Value, Object);
+			ChangedAttributes.AddUnique(Fields[Idx].Attribute);
+		}
+		Owner->PostQuantizedAttributesReceived(ChangedAttributes);
+		return true;
+	}
+	return false;
+}
+
 UGAAttributesBase::UGAAttributesBase(const FObjectInitializer& ObjectInitializer)
 : Super(ObjectInitializer)
 {
 	bNetAddressable = false;
-	LastAttributeProp = nullptr;
-	CachedFloatPropety = nullptr;
+	AttributeTable = nullptr;
+	AttributeTableGeneration = 0;
+	QuantizedAttributes.Owner = this;
 }
 UGAAttributesBase::~UGAAttributesBase()
 {
-	LastAttributeProp = nullptr; //make sure we clear this pointer.
-	CachedFloatPropety = nullptr;
+	AttributeTable = nullptr;
+}
+const FAFAttributeIndexTable& UGAAttributesBase::GetAttributeTable()
+{
+	if (!AttributeTable || AttributeTableGeneration != FAFAttributeIndexTable::GetGeneration())
+	{
+		AttributeTable = &FAFAttributeIndexTable::Get(GetClass());
+		AttributeTableGeneration = FAFAttributeIndexTable::GetGeneration();
+	}
+	return *AttributeTable;
 }
 //void UGAAttributesBase::PostNetReceive()
 //{
@@ -25,14 +301,12 @@ UGAAttributesBase::~UGAAttributesBase()
 void UGAAttributesBase::InitializeAttributes(UAFAbilityComponent* InOwningAttributeComp)
 {
 	OwningAttributeComp = InOwningAttributeComp;
-	for (TFieldIterator<UStructProperty> StrIt(GetClass(), EFieldIteratorFlags::IncludeSuper); StrIt; ++StrIt)
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	for (int32 Index : Table.StructAttributes)
 	{
-		FAFAttributeBase* attr = StrIt->ContainerPtrToValuePtr<FAFAttributeBase>(this);
-		if (attr)
-		{
-			attr->InitializeAttribute(InOwningAttributeComp, StrIt->GetFName());
-			TickableAttributes.Add(attr);
-		}
+		FAFAttributeBase* attr = GetAttributeByIndex(Index);
+		attr->InitializeAttribute(InOwningAttributeComp, Table.Names[Index]);
+		TickableAttributes.Add(attr);
 	}
 	/*
 		Bind Delegates to map > For each attribute, so we don't store them inside attribute
@@ -53,10 +327,11 @@ void UGAAttributesBase::InitializeAttributes(UAFAbilityComponent* InOwningAttrib
 
 void UGAAttributesBase::CopyFromOtherAttributes(UGAAttributesBase* Other)
 {
-	for (TFieldIterator<UStructProperty> StrIt(GetClass(), EFieldIteratorFlags::IncludeSuper); StrIt; ++StrIt)
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	for (int32 Index : Table.StructAttributes)
 	{
-		FAFAttributeBase* ThisAttribute = StrIt->ContainerPtrToValuePtr<FAFAttributeBase>(this);
-		FAFAttributeBase* OtherAttribute = Other->GetAttribute(FGAAttribute(StrIt->GetFName()));
+		FAFAttributeBase* ThisAttribute = GetAttributeByIndex(Index);
+		FAFAttributeBase* OtherAttribute = Other->GetAttribute(FGAAttribute(Table.Names[Index]));
 
 		if (ThisAttribute && OtherAttribute)
 		{
@@ -91,12 +366,13 @@ void UGAAttributesBase::InitializeAttributesFromTable()
 	if (!AttributeValues)
 		return;
 
-	for (TFieldIterator<UStructProperty> StrIt(GetClass(), EFieldIteratorFlags::IncludeSuper); StrIt; ++StrIt)
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	for (int32 Index : Table.StructAttributes)
 	{
-		FAFAttributeBase* attr = StrIt->ContainerPtrToValuePtr<FAFAttributeBase>(this);
+		FAFAttributeBase* attr = GetAttributeByIndex(Index);
 		if (attr)
 		{
-			FName fieldName = StrIt->GetFName();
+			FName fieldName = Table.Names[Index];
 			FString OutString;
 			FAFAtributeRowData* row = AttributeValues->FindRow<FAFAtributeRowData>(fieldName, OutString);
 			if (row)
@@ -106,13 +382,38 @@ void UGAAttributesBase::InitializeAttributesFromTable()
 				attr->SetMinValue(row->MinValue);
 				attr->SetCurrentValue(row->CurrentValue);
 				attr->SetExtensionClass(row->Extension);
-				attr->InitializeAttribute(OwningAttributeComp, StrIt->GetFName());
+				attr->InitializeAttribute(OwningAttributeComp, fieldName);
 			}
 			//TickableAttributes.Add(attr);
 		}
 	}
 }
 
+void UGAAttributesBase::ResetAttributes(UGAAttributesBase* InDefaults)
+{
+	const bool bCopyDefaults = InDefaults && InDefaults != this && InDefaults->GetClass() == GetClass();
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	for (int32 Index : Table.StructAttributes)
+	{
+		FAFAttributeBase* Attribute = GetAttributeByIndex(Index);
+		if (!Attribute)
+			continue;
+
+		Attribute->Modifiers.Reset();
+		if (bCopyDefaults)
+		{
+			//same class, so attribute have the same index in defaults.
+			Attribute->CopyFromOther(InDefaults->GetAttributeByIndex(Index));
+		}
+		else
+		{
+			Attribute->CalculateBonus();
+			Attribute->SetCurrentValue(Attribute->GetFinalValue());
+		}
+	}
+	InitializeAttributesFromTable();
+}
+
 void UGAAttributesBase::Tick(float DeltaTime)
 {
 	for (FAFAttributeBase* Attribute : TickableAttributes)
@@ -123,19 +424,15 @@ void UGAAttributesBase::Tick(float DeltaTime)
 
 UProperty* UGAAttributesBase::FindProperty(const FGAAttribute& AttributeIn)
 {
-	//if new attribute name is the same as last attribute name and pointer to last property
-	//is not null, then we just return last pointer instead of performing new search.
-	if ((AttributeIn.AttributeName == LastAttributeName) && LastAttributeProp)
-		return LastAttributeProp;
-
-	LastAttributeName = AttributeIn.AttributeName;
-	LastAttributeProp = FindFieldChecked<UProperty>(this->GetClass(), LastAttributeName);
-	return LastAttributeProp;
-	return nullptr;
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	const int32 Index = Table.Find(AttributeIn);
+	if (Index == INDEX_NONE)
+		return nullptr;
+	return Table.Properties[Index];
 }
 UStructProperty* UGAAttributesBase::GetStructAttribute(const FGAAttribute& Name)
 {
-	return FindField<UStructProperty>(this->GetClass(), Name.AttributeName);
+	return Cast<UStructProperty>(FindProperty(Name));
 }
 FAFAttributeBase* UGAAttributesBase::GetAttribute(const FGAAttribute& Name)
 {
@@ -144,15 +441,19 @@ FAFAttributeBase* UGAAttributesBase::GetAttribute(const FGAAttribute& Name)
 		UE_LOG(GameAttributesEffects, Log, TEXT("GetAttribute INVALID NAME"));
 		return nullptr;
 	}
-	UStructProperty* tempStruct = FindField<UStructProperty>(this->GetClass(), Name.AttributeName);
+	return GetAttributeByIndex(GetAttributeIndex(Name));
+}
+int32 UGAAttributesBase::GetAttributeIndex(const FGAAttribute& Name)
+{
+	return GetAttributeTable().Find(Name);
+}
+FAFAttributeBase* UGAAttributesBase::GetAttributeByIndex(int32 InIndex)
+{
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	if (!Table.IsStructAttribute(InIndex))
+		return nullptr;
 
-	FAFAttributeBase* attr = nullptr;
-	if (tempStruct)
-	{
-		attr = tempStruct->ContainerPtrToValuePtr<FAFAttributeBase>(this);
-		return attr;
-	} 
-	return attr;
+	return reinterpret_cast<FAFAttributeBase*>(reinterpret_cast<uint8*>(this) + Table.Offsets[InIndex]);
 }
 void UGAAttributesBase::SetAttribute(const FGAAttribute& NameIn, UObject* NewVal)
 {
@@ -160,7 +461,9 @@ void UGAAttributesBase::SetAttribute(const FGAAttribute& NameIn, UObject* NewVal
 }
 void UGAAttributesBase::SetAttributeAdditiveBonus(const FGAAttribute& NameIn, float NewValue)
 {
-	UStructProperty* tempStruct = FindField<UStructProperty>(this->GetClass(), NameIn.AttributeName);
+	UStructProperty* tempStruct = GetStructAttribute(NameIn);
+	if (!tempStruct)
+		return;
 	UScriptStruct* scriptStruct = tempStruct->Struct;
 
 	uint8* StructData = tempStruct->ContainerPtrToValuePtr<uint8>(this);
@@ -212,22 +515,15 @@ float UGAAttributesBase::GetFloatValue(const FGAAttribute& AttributeIn)
 
 float UGAAttributesBase::SetFloatValue(const FGAAttribute& AttributeIn, float ValueIn)
 {
-	if ((AttributeIn.AttributeName == LastAttributeName))
-	{
-		if (CachedFloatPropety)
-		{
-			void* ValuePtr = CachedFloatPropety->ContainerPtrToValuePtr<void>(this);
-			CachedFloatPropety->SetFloatingPointPropertyValue(ValuePtr, ValueIn);
-			return CachedFloatPropety->GetFloatingPointPropertyValue(ValuePtr);
-		}
-	}
-	//LastAttributeName = AttributeIn.AttributeName;
-	UNumericProperty* NumericProperty = CastChecked<UNumericProperty>(FindProperty(AttributeIn));
-	CachedFloatPropety = NumericProperty;
-	void* ValuePtr = CachedFloatPropety->ContainerPtrToValuePtr<void>(this);
+	const FAFAttributeIndexTable& Table = GetAttributeTable();
+	const int32 Index = Table.Find(AttributeIn);
+	UNumericProperty* NumericProperty = Table.Properties.IsValidIndex(Index) ? Cast<UNumericProperty>(Table.Properties[Index]) : nullptr;
+	if (!NumericProperty)
+		return 0;
+
+	void* ValuePtr = reinterpret_cast<uint8*>(this) + Table.Offsets[Index];
 	NumericProperty->SetFloatingPointPropertyValue(ValuePtr, ValueIn);
-	return CachedFloatPropety->GetFloatingPointPropertyValue(ValuePtr);
-	return 0;
+	return NumericProperty->GetFloatingPointPropertyValue(ValuePtr);
 }
 
 float UGAAttributesBase::AttributeOperation(const FGAAttribute& AttributeIn, float ValueIn, EGAAttributeMod Operation)
@@ -332,4 +628,5 @@ void UGAAttributesBase::GetLifetimeReplicatedProps(TArray< class FLifetimeProper
 	//possibly replicate it to everyone
 	//to allow prediction for UI.
 	DOREPLIFETIME(UGAAttributesBase, OwningAttributeComp);
+	DOREPLIFETIME(UGAAttributesBase, QuantizedAttributes);
 }
\ No newline at end of file
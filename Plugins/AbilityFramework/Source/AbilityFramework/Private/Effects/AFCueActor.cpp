@@ -5,12 +5,15 @@
 #include "GAEffectCueSequence.h"
 #include "ActorSequencePlayer.h"
 #include "AFCueActor.h"
+#include "AFCueManager.h"
 
 AAFCueActor::AAFCueActor(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	bInstanced = false;
+	bInPool = false;
 	StartTime = 0;
 	EndTime = 5;
 	if (HasAnyFlags(RF_ClassDefaultObject) || GetArchetype() == GetDefault<AAFCueActor>())
@@ -135,22 +138,61 @@ void AAFCueActor::Tick( float DeltaTime )
 	if (SequencePlayer)
 	{
 		SequencePlayer->Update(DeltaTime);
+		if (SequencePlayer->IsPlaying())
+			return;
+	}
+	SetActorTickEnabled(false);
+	if (!bInstanced)
+	{
+		UAFCueManager::Get()->ReleaseCueActor(this);
 	}
 }
 void AAFCueActor::NativeBeginCue(AActor* InstigatorOut, AActor* TargetOut, UObject* Causer,
 	const FHitResult& HitInfo, const FGAEffectCueParams& CueParams)
 {
 	BeginCue(InstigatorOut, TargetOut, Causer, HitInfo);
-	if (!SequencePlayer)
+	if (SequencePlayer)
 	{
 		SequencePlayer->Play();
+		SetActorTickEnabled(true);
 	}
 }
 
+void AAFCueActor::OnTakenFromPool()
+{
+	bInPool = false;
+	SetActorHiddenInGame(false);
+}
+void AAFCueActor::OnReturnedToPool()
+{
+	bInstanced = false;
+	SetActorTickEnabled(false);
+	if (SequencePlayer)
+	{
+		SequencePlayer->Stop();
+	}
+	GetWorldTimerManager().ClearTimer(PeriodTimer);
+	SetActorHiddenInGame(true);
+	OnCueReset();
+}
+void AAFCueActor::ReleaseWhenFinished()
+{
+	bInstanced = false;
+	//still playing, tick will release it.
+	if (SequencePlayer && SequencePlayer->IsPlaying())
+		return;
+
+	UAFCueManager::Get()->ReleaseCueActor(this);
+}
+
 void AAFCueActor::NativeOnExecuted()
 {
 	OnExecuted();
 }
+void AAFCueActor::NativeOnExpired()
+{
+	OnExpired();
+}
 void AAFCueActor::NativeOnRemoved()
 {
 	OnRemoved();
@@ -0,0 +1,335 @@
+#include "AbilityFramework.h"
+#include "AFEffectsComponent.h"
+#include "AFEffectTimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("EffectTimer.Run"), STAT_EffectTimerRun, STATGROUP_EffectTimer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EffectTimer.Executed"), STAT_EffectTimerExecuted, STATGROUP_EffectTimer);
+
+TMap<FObjectKey, TUniquePtr<FAFEffectTimerManager>> FAFEffectTimerManager::Managers;
+
+FAFEffectTimerWheel::FAFEffectTimerWheel()
+	: CurrentTick(0)
+{
+	for (int32 Idx = 0; Idx < LevelNum * SlotNum; Idx++)
+	{
+		Buckets[Idx] = INDEX_NONE;
+	}
+}
+
+int32 FAFEffectTimerWheel::AddTimer(const FGAEffectHandle& InHandle, EAFEffectTimerType InType, uint64 InExpireTick, uint64 InPeriodTicks)
+{
+	int32 Idx = INDEX_NONE;
+	if (FreeTimers.Num() > 0)
+	{
+		Idx = FreeTimers.Pop(false);
+	}
+	else
+	{
+		Idx = Timers.AddDefaulted();
+	}
+
+	FAFEffectTimer& Timer = Timers[Idx];
+	Timer.Handle = InHandle;
+	Timer.Type = InType;
+	Timer.ExpireTick = FMath::Max(InExpireTick, CurrentTick + 1);
+	Timer.PeriodTicks = InPeriodTicks;
+	Timer.bActive = true;
+	Link(Idx);
+
+	return Idx;
+}
+
+void FAFEffectTimerWheel::RemoveTimer(int32 InTimer)
+{
+	if (!Timers.IsValidIndex(InTimer) || !Timers[InTimer].bActive)
+		return;
+
+	if (Timers[InTimer].Bucket != INDEX_NONE)
+	{
+		Unlink(InTimer);
+	}
+	Timers[InTimer].bActive = false;
+	Timers[InTimer].Handle.Reset();
+	FreeTimers.Add(InTimer);
+}
+
+void FAFEffectTimerWheel::RescheduleTimer(int32 InTimer, uint64 InExpireTick)
+{
+	FAFEffectTimer& Timer = Timers[InTimer];
+	if (Timer.Bucket != INDEX_NONE)
+	{
+		Unlink(InTimer);
+	}
+	Timer.ExpireTick = FMath::Max(InExpireTick, CurrentTick + 1);
+	Link(InTimer);
+}
+
+void FAFEffectTimerWheel::Advance(uint64 InTick, TArray<FAFExpiredEffectTimer>& OutExpired)
+{
+	if (GetTimersNum() == 0)
+	{
+		CurrentTick = FMath::Max(CurrentTick, InTick);
+		return;
+	}
+
+	while (CurrentTick < InTick)
+	{
+		CurrentTick++;
+
+		//cascade upper levels, when all levels below them wrapped around.
+		for (int32 Level = 1; Level < LevelNum; Level++)
+		{
+			const uint64 LowerMask = (uint64(1) << (SlotBits * Level)) - 1;
+			if ((CurrentTick & LowerMask) != 0)
+				break;
+			Cascade(Level);
+		}
+
+		const int32 Slot = CurrentTick & SlotMask;
+		int32 Idx = Buckets[Slot];
+		Buckets[Slot] = INDEX_NONE;
+
+		DueDurations.Reset();
+		while (Idx != INDEX_NONE)
+		{
+			FAFEffectTimer& Timer = Timers[Idx];
+			const int32 Next = Timer.Next;
+			Timer.Next = INDEX_NONE;
+			Timer.Prev = INDEX_NONE;
+			Timer.Bucket = INDEX_NONE;
+
+			if (Timer.PeriodTicks > 0)
+			{
+				OutExpired.Add(FAFExpiredEffectTimer(Timer.Handle, Timer.Type));
+				Timer.ExpireTick += Timer.PeriodTicks;
+				Link(Idx);
+			}
+			else
+			{
+				DueDurations.Add(Idx);
+			}
+			Idx = Next;
+		}
+		for (int32 DueIdx : DueDurations)
+		{
+			OutExpired.Add(FAFExpiredEffectTimer(Timers[DueIdx].Handle, Timers[DueIdx].Type));
+		}
+	}
+}
+
+void FAFEffectTimerWheel::Link(int32 InTimer)
+{
+	FAFEffectTimer& Timer = Timers[InTimer];
+	const uint64 Delta = Timer.ExpireTick - CurrentTick;
+
+	int32 Level = 0;
+	while (Level < LevelNum - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1))))
+	{
+		Level++;
+	}
+	//timers beyond wheel range are parked in last bucket and cascaded again when wheel reaches it.
+	uint64 Expire = Timer.ExpireTick;
+	const uint64 MaxDelta = (uint64(1) << (SlotBits * LevelNum)) - 1;
+	if (Delta > MaxDelta)
+	{
+		Expire = CurrentTick + MaxDelta;
+	}
+
+	const int32 Slot = (Expire >> (SlotBits * Level)) & SlotMask;
+	const int32 Bucket = Level * SlotNum + Slot;
+
+	Timer.Bucket = Bucket;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = Buckets[Bucket];
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = InTimer;
+	}
+	Buckets[Bucket] = InTimer;
+}
+
+void FAFEffectTimerWheel::Unlink(int32 InTimer)
+{
+	FAFEffectTimer& Timer = Timers[InTimer];
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		Buckets[Timer.Bucket] = Timer.Next;
+	}
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+	Timer.Next = INDEX_NONE;
+	Timer.Prev = INDEX_NONE;
+	Timer.Bucket = INDEX_NONE;
+}
+
+void FAFEffectTimerWheel::Cascade(int32 InLevel)
+{
+	const int32 Slot = (CurrentTick >> (SlotBits * InLevel)) & SlotMask;
+	const int32 Bucket = InLevel * SlotNum + Slot;
+	int32 Idx = Buckets[Bucket];
+	Buckets[Bucket] = INDEX_NONE;
+
+	while (Idx != INDEX_NONE)
+	{
+		const int32 Next = Timers[Idx].Next;
+		Link(Idx);
+		Idx = Next;
+	}
+}
+
+FAFEffectTimerManager& FAFEffectTimerManager::Get(UWorld* InWorld)
+{
+	check(InWorld);
+	TUniquePtr<FAFEffectTimerManager>& Manager = Managers.FindOrAdd(FObjectKey(InWorld));
+	if (!Manager.IsValid())
+	{
+		Manager = MakeUnique<FAFEffectTimerManager>(InWorld);
+	}
+	return *Manager;
+}
+
+void FAFEffectTimerManager::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	Managers.Remove(FObjectKey(InWorld));
+}
+
+void FAFEffectTimerManager::Shutdown()
+{
+	Managers.Empty();
+}
+
+FAFEffectTimerManager::FAFEffectTimerManager(UWorld* InWorld)
+	: World(InWorld)
+	, BaseTime(InWorld->GetTimeSeconds())
+	, TickResolution(0.01)
+{
+}
+
+void FAFEffectTimerManager::AddEffect(const FGAEffectHandle& InHandle
+	, const FAFEffectParams& Params
+	, const FAFFunctionModifier& Modifier
+	, float InDuration
+	, float InPeriod)
+{
+	RemoveEffect(InHandle);
+	if (InDuration <= 0 && InPeriod <= 0)
+		return;
+
+	TSharedPtr<FAFEffectTimerEntry> Entry = MakeShareable(new FAFEffectTimerEntry(Params, Modifier));
+	const double Now = GetWorldTime();
+	if (InDuration > 0)
+	{
+		Entry->DurationTimer = Wheel.AddTimer(InHandle, EAFEffectTimerType::Duration, TimeToTick(Now + InDuration), 0);
+	}
+	if (InPeriod > 0)
+	{
+		const uint64 PeriodTicks = FMath::Max<uint64>(1, (uint64)FMath::RoundToDouble(InPeriod / TickResolution));
+		Entry->PeriodTimer = Wheel.AddTimer(InHandle, EAFEffectTimerType::Period, TimeToTick(Now + InPeriod), PeriodTicks);
+	}
+	Entries.Add(InHandle, Entry);
+}
+
+void FAFEffectTimerManager::RemoveEffect(const FGAEffectHandle& InHandle)
+{
+	TSharedPtr<FAFEffectTimerEntry> Entry;
+	if (!Entries.RemoveAndCopyValue(InHandle, Entry))
+		return;
+
+	Wheel.RemoveTimer(Entry->DurationTimer);
+	Wheel.RemoveTimer(Entry->PeriodTimer);
+}
+
+bool FAFEffectTimerManager::SetRemainingTime(const FGAEffectHandle& InHandle, float InDuration)
+{
+	const TSharedPtr<FAFEffectTimerEntry>* Entry = Entries.Find(InHandle);
+	if (!Entry || (*Entry)->DurationTimer == INDEX_NONE)
+		return false;
+
+	Wheel.RescheduleTimer((*Entry)->DurationTimer, TimeToTick(GetWorldTime() + InDuration));
+	return true;
+}
+
+float FAFEffectTimerManager::GetRemainingTime(const FGAEffectHandle& InHandle) const
+{
+	const TSharedPtr<FAFEffectTimerEntry>* Entry = Entries.Find(InHandle);
+	if (!Entry || (*Entry)->DurationTimer == INDEX_NONE)
+		return 0;
+
+	const double ExpireTime = TickToTime(Wheel.GetTimer((*Entry)->DurationTimer).ExpireTick);
+	return FMath::Max<float>(ExpireTime - GetWorldTime(), 0);
+}
+
+void FAFEffectTimerManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EffectTimerRun);
+
+	const uint64 TargetTick = (uint64)FMath::FloorToDouble((GetWorldTime() - BaseTime) / TickResolution);
+	ExpiredTimers.Reset();
+	Wheel.Advance(TargetTick, ExpiredTimers);
+
+	INC_DWORD_STAT_BY(STAT_EffectTimerExecuted, ExpiredTimers.Num());
+	for (const FAFExpiredEffectTimer& Expired : ExpiredTimers)
+	{
+		ExecuteTimer(Expired);
+	}
+}
+
+double FAFEffectTimerManager::GetWorldTime() const
+{
+	if (UWorld* LocalWorld = World.Get())
+	{
+		return LocalWorld->GetTimeSeconds();
+	}
+	return BaseTime;
+}
+
+uint64 FAFEffectTimerManager::TimeToTick(double InTime) const
+{
+	return (uint64)FMath::Max(FMath::CeilToDouble((InTime - BaseTime) / TickResolution), 0.0);
+}
+
+double FAFEffectTimerManager::TickToTime(uint64 InTick) const
+{
+	return BaseTime + InTick * TickResolution;
+}
+
+void FAFEffectTimerManager::ExecuteTimer(const FAFExpiredEffectTimer& InTimer)
+{
+	//effect might have been removed by timer executed earlier in this batch.
+	TSharedPtr<FAFEffectTimerEntry> Entry = Entries.FindRef(InTimer.Handle);
+	if (!Entry.IsValid())
+		return;
+
+	UAFEffectsComponent* EffectsComponent = Entry->Params.GetTargetEffectsComponent();
+	if (!EffectsComponent)
+	{
+		RemoveEffect(InTimer.Handle);
+		return;
+	}
+
+	switch (InTimer.Type)
+	{
+	case EAFEffectTimerType::Duration:
+	{
+		//duration could have been extended after timer has been collected.
+		if (Entry->DurationTimer == INDEX_NONE
+			|| Wheel.GetTimer(Entry->DurationTimer).ExpireTick > Wheel.GetCurrentTick())
+			return;
+
+		RemoveEffect(InTimer.Handle);
+		EffectsComponent->ExpireEffect(InTimer.Handle, Entry->Params);
+		break;
+	}
+	case EAFEffectTimerType::Period:
+	{
+		EffectsComponent->ExecuteEffect(InTimer.Handle, Entry->Params, Entry->Modifier);
+		break;
+	}
+	}
+}
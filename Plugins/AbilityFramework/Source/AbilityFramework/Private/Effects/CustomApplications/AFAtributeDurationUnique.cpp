@@ -3,6 +3,7 @@
 #include "AbilityFramework.h"
 #include "../GAGameEffect.h"
 #include "AFEffectsComponent.h"
+#include "Effects/AFEffectTimerManager.h"
 #include "AFAbilityInterface.h"
 #include "AFAtributeDurationUnique.h"
 
@@ -20,11 +21,8 @@ bool UAFAtributeDurationUnique::ApplyEffect(
 	{
 		return false;
 	}
-	FTimerManager& DurationTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-	FTimerDelegate delDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExpireEffect, InHandle, Params);
-	DurationTimer.SetTimer(const_cast<FGAEffect&>(EffectIn).DurationTimerHandle, delDuration,
-		Params.GetProperty().GetDuration(), false);
+	Params.GetEffectTimerManager().AddEffect(InHandle, Params, Modifier,
+		Params.GetProperty().GetDuration(), 0);
 
 	return true;
 }
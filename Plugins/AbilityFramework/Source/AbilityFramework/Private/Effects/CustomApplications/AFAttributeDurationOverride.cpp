@@ -3,6 +3,7 @@
 #include "AbilityFramework.h"
 #include "../GAGameEffect.h"
 #include "AFEffectsComponent.h"
+#include "Effects/AFEffectTimerManager.h"
 #include "AFAttributeDurationOverride.h"
 
 
@@ -17,11 +18,8 @@ bool UAFAttributeDurationOverride::ApplyEffect(
 {
 	InContainer->RemoveEffect(Params.Property, Params.GetContext());
 
-	FTimerManager& DurationTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-	FTimerDelegate delDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExpireEffect, InHandle, Params);
-	DurationTimer.SetTimer(const_cast<FGAEffect&>(EffectIn).DurationTimerHandle, delDuration,
-		Params.GetProperty().GetDuration(), false);
+	Params.GetEffectTimerManager().AddEffect(InHandle, Params, Modifier,
+		Params.GetProperty().GetDuration(), 0);
 
 	return true;
 }
\ No newline at end of file
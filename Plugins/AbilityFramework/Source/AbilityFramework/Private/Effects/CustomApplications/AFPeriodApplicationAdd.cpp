@@ -3,6 +3,7 @@
 #include "AbilityFramework.h"
 #include "../GAGameEffect.h"
 #include "AFEffectsComponent.h"
+#include "Effects/AFEffectTimerManager.h"
 #include "AFPeriodApplicationAdd.h"
 
 
@@ -13,17 +14,8 @@ bool UAFPeriodApplicationAdd::ApplyEffect(
 	, const FAFEffectParams& Params
 	, const FAFFunctionModifier& Modifier)
 {
-	FTimerManager& DurationTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-	FTimerDelegate delDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExpireEffect, InHandle, Params);
-	DurationTimer.SetTimer(const_cast<FGAEffect&>(EffectIn).DurationTimerHandle, delDuration,
-		Params.GetProperty().GetDuration(), false);
-
-	FTimerManager& PeriodTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-	FTimerDelegate PeriodDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExecuteEffect, InHandle, Params, Modifier);
-	PeriodTimer.SetTimer(const_cast<FGAEffect&>(EffectIn).PeriodTimerHandle, PeriodDuration,
-		Params.GetProperty().GetPeriod(), true);
+	Params.GetEffectTimerManager().AddEffect(InHandle, Params, Modifier,
+		Params.GetProperty().GetDuration(), Params.GetProperty().GetPeriod());
 
 	//InContainer->AddEffect(InProperty, InHandle);
 	
@@ -4,6 +4,7 @@
 #include "GAGlobalTypes.h"
 #include "Effects/GAGameEffect.h"
 #include "AFEffectsComponent.h"
+#include "Effects/AFEffectTimerManager.h"
 #include "AFPeriodApplicationExtend.h"
 
 
@@ -16,38 +17,29 @@ bool UAFPeriodApplicationExtend::ApplyEffect(
 	, const FAFEffectParams& Params
 	, const FAFFunctionModifier& Modifier)
 {
+	FAFEffectTimerManager& TimerManager = Params.GetEffectTimerManager();
 	TSet<FGAEffectHandle> handles = InContainer->GetHandlesByClass(Params.GetProperty(), Params.GetContext());
 	for (const FGAEffectHandle& handle : handles)
 	{
 		FGAEffect& ExtEffect = *InContainer->GetEffect(handle);
-		FGAEffect& Effect = const_cast<FGAEffect&>(EffectIn);
+		const float AddedDuration = Params.GetProperty().GetDuration();
 		
-		FGAEffectContext& ExtContext = const_cast<FAFEffectParams&>(Params).GetContext();
-
-		FTimerManager& DurationTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-		float RemainingTime = DurationTimer.GetTimerRemaining(ExtEffect.DurationTimerHandle);
-		float NewDuration = RemainingTime + Effect.GetDurationTime();
-		DurationTimer.ClearTimer(ExtEffect.DurationTimerHandle);
-
-		FTimerDelegate delDuration = FTimerDelegate::CreateUObject(ExtContext.GetTargetEffectsComponent(), &UAFEffectsComponent::ExpireEffect, InHandle, Params);
-		DurationTimer.SetTimer(ExtEffect.DurationTimerHandle, delDuration,
-			NewDuration, false);
+		float RemainingTime = TimerManager.GetRemainingTime(handle);
+		if (TimerManager.SetRemainingTime(handle, RemainingTime + AddedDuration))
+		{
+			ExtEffect.Duration += AddedDuration;
+			//clients read duration from replicated effect.
+			InContainer->MarkItemDirty(ExtEffect);
+		}
 	}
-	if (handles.Num() <= 0)
+	if (handles.Num() > 0)
 	{
-		FGAEffect& Effect = const_cast<FGAEffect&>(EffectIn);;
-		FTimerManager& DurationTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-		FTimerDelegate delDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExpireEffect, InHandle, Params);
-		DurationTimer.SetTimer(Effect.DurationTimerHandle, delDuration,
-			Params.GetProperty().GetDuration(), false);
+		//existing effect has been extended, there is nothing new to add.
+		return false;
+	}
 
-		FTimerManager& PeriodTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
+	TimerManager.AddEffect(InHandle, Params, Modifier,
+		Params.GetProperty().GetDuration(), Params.GetProperty().GetPeriod());
 
-		FTimerDelegate PeriodDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExecuteEffect, InHandle, Params, Modifier);
-		PeriodTimer.SetTimer(Effect.PeriodTimerHandle, PeriodDuration,
-			Params.GetProperty().GetPeriod(), true);
-	}
 	return true;
 }
\ No newline at end of file
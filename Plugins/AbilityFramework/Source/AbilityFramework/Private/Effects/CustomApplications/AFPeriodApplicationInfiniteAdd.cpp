@@ -3,6 +3,7 @@
 #include "AbilityFramework.h"
 #include "../GAGameEffect.h"
 #include "AFEffectsComponent.h"
+#include "Effects/AFEffectTimerManager.h"
 #include "AFPeriodApplicationInfiniteAdd.h"
 
 
@@ -13,11 +14,8 @@ bool UAFPeriodApplicationInfiniteAdd::ApplyEffect(
 	, const FAFEffectParams& Params
 	, const FAFFunctionModifier& Modifier)
 {
-	FTimerManager& PeriodTimer = const_cast<FAFEffectParams&>(Params).GetTargetTimerManager();
-
-	FTimerDelegate PeriodDuration = FTimerDelegate::CreateUObject(Params.GetTargetEffectsComponent(), &UAFEffectsComponent::ExecuteEffect, InHandle, Params, Modifier);
-	PeriodTimer.SetTimer(const_cast<FGAEffect&>(EffectIn).PeriodTimerHandle, PeriodDuration,
-		Params.GetProperty().GetPeriod(), true);
+	Params.GetEffectTimerManager().AddEffect(InHandle, Params, Modifier,
+		0, Params.GetProperty().GetPeriod());
 	
 	return true;
 }
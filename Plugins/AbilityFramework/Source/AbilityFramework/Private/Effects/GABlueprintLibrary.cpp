@@ -115,100 +115,78 @@ TArray<FGAEffectHandle> UGABlueprintLibrary::ApplyEffect(
 	, const TArray<FHitResult>& HitsIn
 	, const FAFFunctionModifier& Modifier)
 {
-	bool bCheckHits = Targets.Num() == HitsIn.Num();
 	TArray<FGAEffectHandle> Handles;
-	for (int32 Idx = 0; Idx < Targets.Num(); Idx++)
+	if (Targets.Num() == 0)
+		return Handles;
+
+	/*
+		Everything which does not depend on target is validated and prepared once,
+		and shared by all targets in batch.
+	*/
+	ENetMode NetMode = GEngine->GetNetMode(Instigator->GetWorld());
+	UE_LOG(GameAttributesEffects, Log, TEXT("UGABlueprintLibrary::ApplyEffect NetMode %s, Targets %d"), *NetModeToString(NetMode), Targets.Num());
+
+	IAFAbilityInterface* Ability = Cast<IAFAbilityInterface>(Causer);
+	if (!Ability)
 	{
-		UObject* Target = Targets[Idx];
-		FHitResult HitIn;
-		if (bCheckHits)
-		{
-			HitIn = HitsIn[Idx];
-		}
-		
-
-		ENetMode NetMode = GEngine->GetNetMode(Instigator->GetWorld());
-
-		UE_LOG(GameAttributesEffects, Error, TEXT("UGABlueprintLibrary::ApplyEffect START, NetMode %s"), *NetModeToString(NetMode));
-		UE_LOG(GameAttributesEffects, Error, TEXT("-----"));
-		IAFAbilityInterface* Ability = Cast<IAFAbilityInterface>(Causer);
-		if (!Ability)
-		{
-			UE_LOG(GameAttributesEffects, Error, TEXT("UGABlueprintLibrary::ApplyEffect Effects must be applied trough Ability"));
-			return Handles;
-		}
-
-		IAFAbilityInterface* TargetInterface = Cast<IAFAbilityInterface>(Target);
+		UE_LOG(GameAttributesEffects, Error, TEXT("UGABlueprintLibrary::ApplyEffect Effects must be applied trough Ability"));
+		return Handles;
+	}
+	IAFAbilityInterface* InstigatorInterface = Cast<IAFAbilityInterface>(Instigator);
 
+	InEffect.InitializeIfNotInitialized(Instigator, Causer);
+	if (!InEffect.IsInitialized())
+	{
+		UE_LOG(GameAttributesEffects, Error, TEXT("Invalid Effect Spec"));
+		return Handles;
+	}
 
-		if (!InEffect.GetClass().GetDefaultObject()->Application.GetDefaultObject()->CanApply(TargetInterface, InEffect.GetClass()))
-		{
-			return Handles;
-		}
-		bool bReusedParams = false;
-		bool bPeriodicEffect = false;
-		
-		FAFEffectSpecHandle EffectSpecHandle;
-		FAFEffectParams Params(InEffect);
-		InEffect.InitializeIfNotInitialized(Instigator, Causer);
-		Params.Context = InEffect.GetPtr()->GetContextCopy(Target, HitIn);
+	UGAGameEffectSpec* Spec = InEffect.GetSpecData();
+	UAFEffectCustomApplication* Application = InEffect.GetClass().GetDefaultObject()->Application.GetDefaultObject();
+	FGAEffectProperty& Property = InEffect.GetRef();
+	const bool bPeriodicEffect = InEffect.GetDuration() > 0 || InEffect.GetPeriod() > 0;
+	//spec with extension is instanced per target, since extension is created for target.
+	const bool bSharedSpec = !Spec->Extension;
+	const bool bCheckHits = Targets.Num() == HitsIn.Num();
 
-		UAFEffectsComponent* Target2 = Params.Context.GetTargetEffectsComponent();
+	FAFEffectParams Params(InEffect);
+	Params.bRecreated = false;
+	Params.bPeriodicEffect = bPeriodicEffect;
 
-		UGAGameEffectSpec* Spec = InEffect.GetSpecData();
+	FGAEffect Effect;
+	Effect.World = Instigator->GetWorld();
+	Effect.PredictionHandle = Ability->GetPredictionHandle();
 
-		if (!Target2->HaveEffectRquiredTags(Spec->ApplicationRequiredTags))
-		{
-			return Handles;
-		}
-		if (Target2->DenyEffectApplication(Spec->DenyTags))
-		{
-			return Handles;
-		}
+	Handles.Reserve(Targets.Num());
+	bool bHaveSpec = false;
+	for (int32 Idx = 0; Idx < Targets.Num(); Idx++)
+	{
+		UObject* Target = Targets[Idx];
+		IAFAbilityInterface* TargetInterface = Cast<IAFAbilityInterface>(Target);
+		if (!Application->CanApply(TargetInterface, InEffect.GetClass()))
+			continue;
 
-		if ((InEffect.GetDuration() > 0 || InEffect.GetPeriod() > 0))
-		{
-			bPeriodicEffect = true;
-		}
+		Params.Context = Property.GetContextCopy(Target, bCheckHits ? HitsIn[Idx] : FHitResult());
 
-		if (!InEffect.IsInitialized())
+		UAFEffectsComponent* TargetComp = Params.Context.GetTargetEffectsComponent();
+		if (!TargetComp
+			|| !TargetComp->HaveEffectRquiredTags(Spec->GetApplicationRequiredMask())
+			|| TargetComp->DenyEffectApplication(Spec->GetDenyMask()))
 		{
-			UE_LOG(GameAttributesEffects, Error, TEXT("Invalid Effect Spec"));
-			return Handles;
+			continue;
 		}
 
-
-
-		UE_LOG(GameAttributesEffects, Log, TEXT("MakeOutgoingSpecObj: Created new Context: %s"), *Params.Context.ToString());
-
-		FGAEffect effect;
-		effect.World = Instigator->GetWorld();
-		if (Ability)
+		if (!bHaveSpec || !bSharedSpec)
 		{
-			effect.PredictionHandle = Ability->GetPredictionHandle();
+			Params.EffectSpec = Property.GetSpecCopy();
+			AddTagsToEffect(&Params.EffectSpec);
+			bHaveSpec = true;
 		}
-		IAFAbilityInterface* InstigatorInterface = Cast<IAFAbilityInterface>(Instigator);
-
-		
-		/*if (Params.EffectSpec.GetPtr())
-		{
-			if (Params.EffectSpec.GetPtr()->GetContext().GetPtr()->Target.IsValid())
-			{
-				UE_LOG(GameAttributesEffects, Log, TEXT("  Pre Spec Target: %s"), *Params.EffectSpec.GetPtr()->GetContext().GetPtr()->Target->GetName());
-			}
-		}*/
 
-		Params.EffectSpec = InEffect.GetPtr()->GetSpecCopy();
-		AddTagsToEffect(&Params.EffectSpec);
-
-		Params.bRecreated = bReusedParams;
-		Params.bPeriodicEffect = bPeriodicEffect;
-
-		FGAEffectHandle NewHandle = InstigatorInterface->ApplyEffectToTarget(effect, Params, Modifier);
+		//container modifies effect it is given, so each target starts from clean copy.
+		FGAEffect TargetEffect = Effect;
+		FGAEffectHandle NewHandle = InstigatorInterface->ApplyEffectToTarget(TargetEffect, Params, Modifier);
 		Handles.Add(NewHandle);
-		UE_LOG(GameAttributesEffects, Error, TEXT("-----"));
-		UE_LOG(GameAttributesEffects, Error, TEXT("UGABlueprintLibrary::ApplyEffect END"));
-
 	}
 	return Handles;
 }
@@ -277,7 +255,7 @@ FAFContextHandle UGABlueprintLibrary::MakeContext(class UObject* Target, class A
 	}
 	
 	FVector location = targetComp ? targetComp->GetOwner()->GetActorLocation() : FVector(HitIn.ImpactPoint.X, HitIn.ImpactPoint.Y, HitIn.ImpactPoint.Z);
-	FGAEffectContext* Context = new FGAEffectContext(
+	FAFContextHandle Handle = FAFContextHandle::Generate(
 		targetAttr ? targetAttr->GetAttributes() : nullptr
 		, instiAttr ? instiAttr->GetAttributes() : nullptr
 		, location
@@ -288,9 +266,7 @@ FAFContextHandle UGABlueprintLibrary::MakeContext(class UObject* Target, class A
 		, instiComp
 		, InAvatar);
 
-	Context->HitResult = HitIn;
-	
-	FAFContextHandle Handle = FAFContextHandle::Generate(Context);
+	Handle.GetPtr()->HitResult = HitIn;
 
 	return Handle;
 }
@@ -347,9 +323,8 @@ void UGABlueprintLibrary::CreateEffectSpec(UPARAM(Ref) FAFEffectSpecHandle& InOu
 	
 	UE_LOG(GameAttributesEffects, Log, TEXT("MakeOutgoingSpecObj: Created new Context: %s"), *Context.GetRef().ToString());
 
-	FAFEffectSpec* EffectSpec = new FAFEffectSpec(Context, InEffect.GetClass());
-	AddTagsToEffect(EffectSpec);
-	EffectSpecHandle = FAFEffectSpecHandle::Generate(EffectSpec);
+	EffectSpecHandle = FAFEffectSpecHandle::Generate(Context, InEffect.GetClass());
+	AddTagsToEffect(EffectSpecHandle.GetPtr());
 
 	InOutSpec = EffectSpecHandle;
 }
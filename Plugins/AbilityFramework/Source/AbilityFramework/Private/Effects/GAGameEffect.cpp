@@ -14,9 +14,27 @@
 #include "AFEffectCustomApplication.h"
 #include "GAGameEffect.h"
 #include "GABlueprintLibrary.h"
+#include "AFEffectTimerManager.h"
 
 DEFINE_STAT(STAT_GatherModifiers);
 
+//single pool per type for whole process, handles are copied in game modules too.
+template<> TAFHandlePool<FGAEffectContext>& TAFHandlePool<FGAEffectContext>::Get()
+{
+	static TAFHandlePool Pool;
+	return Pool;
+}
+template<> TAFHandlePool<FAFEffectSpec>& TAFHandlePool<FAFEffectSpec>::Get()
+{
+	static TAFHandlePool Pool;
+	return Pool;
+}
+template<> TAFHandlePool<FGAEffectProperty>& TAFHandlePool<FGAEffectProperty>::Get()
+{
+	static TAFHandlePool Pool;
+	return Pool;
+}
+
 
 void FAFEffectSpec::OnApplied() const
 {
@@ -178,9 +196,7 @@ void FGAEffectProperty::InitializeIfNotInitialized(
 	{
 		SpecClass = EffectClass;
 
-		FGAEffectContext* Context = new FGAEffectContext(Instigator, Causer);
-
-		EffectContext = FAFContextHandle::Generate(Context);
+		EffectContext = FAFContextHandle::Generate(Instigator, Causer);
 		Initialize(EffectClass);
 	}
 	if (Spec.IsValid())
@@ -244,9 +260,19 @@ void FGAEffect::PostReplicatedAdd(const struct FGAEffectContainer& InArraySerial
 }
 void FGAEffect::PostReplicatedChange(const struct FGAEffectContainer& InArraySerializer)
 {
-
+	//duration might have been extended on server, keep local timer in sync if effect is tracked here.
+	if (!World)
+		return;
+	FAFEffectTimerManager& TimerManager = FAFEffectTimerManager::Get(World);
+	if (TimerManager.HasEffect(Handle))
+	{
+		TimerManager.SetRemainingTime(Handle, FMath::Max(Duration - GetCurrentDuration(), 0.f));
+	}
 }
-FGAEffect::FGAEffect(TSharedPtr<FAFEffectSpec> InSpec, const FGAEffectHandle& InHandle)
+FGAEffect::FGAEffect(FAFEffectSpec* InSpec, const FGAEffectHandle& InHandle)
+	: World(nullptr)
+	, Duration(0)
+	, SlotIndex(INDEX_NONE)
 {
 	Handle = InHandle;
 }
@@ -369,9 +395,9 @@ float FGAEffect::GetCurrentDuration() const
 	
 	return 0;
 }
-FTimerManager& FAFEffectParams::GetTargetTimerManager()
+FAFEffectTimerManager& FAFEffectParams::GetEffectTimerManager() const
 {
-	return Context.TargetComp->GetWorld()->GetTimerManager();
+	return FAFEffectTimerManager::Get(Context.TargetComp->GetWorld());
 }
 UAFEffectsComponent* FAFEffectParams::GetTargetEffectsComponent()
 {
@@ -441,10 +467,7 @@ FGAEffectHandle FGAEffectContainer::ApplyEffect(
 				const_cast<FGAEffect&>(EffectIn).LastTickTime = OwningComponent->GetWorld()->TimeSeconds;
 				const_cast<FGAEffect&>(EffectIn).Duration = Spec.GetDuration(Context);
 				const_cast<FGAEffect&>(EffectIn).Period = Spec.GetPeriod(Context);
-				MarkItemDirty(const_cast<FGAEffect&>(EffectIn));
-				int32 newItem = ActiveEffectInfos.Add(EffectIn);
-				MarkArrayDirty();
-				AddEffect(Handle, const_cast<FGAEffect&>(EffectIn).PredictionHandle, &ActiveEffectInfos[newItem], InProperty, Params);
+				AddEffect(Handle, EffectIn.PredictionHandle, EffectIn, InProperty, Params);
 				
 				//InProperty.ApplyExecute(Handle, Params, Modifier);
 				//generate it only on client, and apply prediction key from client.
@@ -495,81 +518,156 @@ TSet<FGAEffectHandle> FGAEffectContainer::GetHandlesByClass(const FGAEffectPrope
 {
 	TSet<FGAEffectHandle> Handles;
 	UGAGameEffectSpec* Spec = InProperty.GetSpecData();
-	EGAEffectAggregation Aggregation = Spec->EffectAggregation;
 	UClass* EffectClass = Spec->GetClass();
 
-	switch (Aggregation)
+	FAFEffectAggregationKey Key;
+	switch (Spec->EffectAggregation)
 	{
 	case EGAEffectAggregation::AggregateByInstigator:
-	{
-		UAFAbilityComponent* Instigator = InContext.InstigatorComp.Get();
-		TMap<UClass*, TSet<FGAEffectHandle>>* EffectByClassMap = InstigatorEffectByClass.Find(Instigator);
-		//TSet<FGAEffectHandle>* EffectByClass;
-		if (EffectByClassMap)
-		{
-			return EffectByClassMap->FindRef(EffectClass);
-		}
-
+		Key = FAFEffectAggregationKey(InContext.Instigator.Get(), EffectClass);
 		break;
-	}
 	case EGAEffectAggregation::AggregateByTarget:
-	{
-		UAFAbilityComponent* Target = InContext.TargetComp.Get();
-		TSet<FGAEffectHandle>* TargetEffect = TargetEffectByClass.Find(EffectClass);
-		if (TargetEffect)
-		{
-			return *TargetEffect;
-		}
+		Key = FAFEffectAggregationKey(nullptr, EffectClass);
 		break;
-	}
 	default:
-		break;
+		return Handles;
+	}
+
+	const FAFEffectSlotList* List = EffectByAggregation.Find(Key);
+	if (!List)
+		return Handles;
+
+	Handles.Reserve(List->Num);
+	const uint8 ListIdx = (uint8)EAFEffectSlotList::Aggregation;
+	for (int32 SlotIndex = List->Head; SlotIndex != INDEX_NONE; SlotIndex = Slots[SlotIndex].Next[ListIdx])
+	{
+		Handles.Add(Slots[SlotIndex].Handle);
 	}
 	return Handles;
 }
 
-void FGAEffectContainer::AddEffect(
+int32 FGAEffectContainer::AllocateSlot()
+{
+	if (FreeSlot == INDEX_NONE)
+	{
+		return Slots.AddDefaulted();
+	}
+	const int32 SlotIndex = FreeSlot;
+	FreeSlot = Slots[SlotIndex].NextFree;
+	Slots[SlotIndex] = FAFEffectSlot();
+	return SlotIndex;
+}
+
+void FGAEffectContainer::FreeSlotAt(int32 SlotIndex)
+{
+	FAFEffectSlot& Slot = Slots[SlotIndex];
+	Slot.DenseIndex = INDEX_NONE;
+	Slot.Handle = FGAEffectHandle();
+	Slot.NextFree = FreeSlot;
+	FreeSlot = SlotIndex;
+}
+
+void FGAEffectContainer::LinkSlot(FAFEffectSlotList& List, int32 SlotIndex, EAFEffectSlotList ListType)
+{
+	const uint8 ListIdx = (uint8)ListType;
+	FAFEffectSlot& Slot = Slots[SlotIndex];
+	Slot.Prev[ListIdx] = INDEX_NONE;
+	Slot.Next[ListIdx] = List.Head;
+	if (List.Head != INDEX_NONE)
+	{
+		Slots[List.Head].Prev[ListIdx] = SlotIndex;
+	}
+	List.Head = SlotIndex;
+	List.Num++;
+}
+
+bool FGAEffectContainer::UnlinkSlot(FAFEffectSlotList& List, int32 SlotIndex, EAFEffectSlotList ListType)
+{
+	const uint8 ListIdx = (uint8)ListType;
+	FAFEffectSlot& Slot = Slots[SlotIndex];
+	if (Slot.Prev[ListIdx] != INDEX_NONE)
+	{
+		Slots[Slot.Prev[ListIdx]].Next[ListIdx] = Slot.Next[ListIdx];
+	}
+	else
+	{
+		List.Head = Slot.Next[ListIdx];
+	}
+	if (Slot.Next[ListIdx] != INDEX_NONE)
+	{
+		Slots[Slot.Next[ListIdx]].Prev[ListIdx] = Slot.Prev[ListIdx];
+	}
+	Slot.Prev[ListIdx] = INDEX_NONE;
+	Slot.Next[ListIdx] = INDEX_NONE;
+	List.Num--;
+	return List.Num == 0;
+}
+
+FGAEffect* FGAEffectContainer::AddEffect(
 	const FGAEffectHandle& InHandle
 	, const FAFPredictionHandle& InPredHandle
-	, FGAEffect* InEffect
+	, const FGAEffect& InEffect
 	, const FGAEffectProperty& InProperty
 	, const FAFEffectParams& Params
 	, bool bInfinite)
 {
-	HandleByPrediction.Add(InPredHandle, InHandle);
-	PredictionByHandle.Add(InHandle, InPredHandle);
-	PredictedEffectInfos.Add(InPredHandle, InEffect);
 	UGAGameEffectSpec* Spec = InProperty.GetSpecData();
 	UClass* SpecClass = Spec->GetClass();
 	const FGAEffectContext& Context = Params.GetContext();
 
-	TSet<FGAEffectHandle>& Effects = EffectByAttribute.FindOrAdd(Spec->AtributeModifier.Attribute);
-	Effects.Add(InHandle);
+	const int32 SlotIndex = AllocateSlot();
+	const int32 DenseIndex = ActiveEffectInfos.Add(InEffect);
+	ActiveEffectInfos[DenseIndex].SlotIndex = SlotIndex;
+	DeferArrayDirty();
 
-	FObjectKey EffectKey(SpecClass);
-	TArray<FGAEffectHandle>& LocalEffectClass = EffectByClass.FindOrAdd(EffectKey);
-	LocalEffectClass.Add(InHandle);
+	FAFEffectSlot& Slot = Slots[SlotIndex];
+	Slot.Handle = InHandle;
+	Slot.PredictionHandle = InPredHandle;
+	Slot.Attribute = Spec->AtributeModifier.Attribute;
+	Slot.ClassKey = FObjectKey(SpecClass);
+	Slot.DenseIndex = DenseIndex;
 
 	switch (Spec->EffectAggregation)
 	{
 	case EGAEffectAggregation::AggregateByInstigator:
-	{
-		TMap<UClass*, TSet<FGAEffectHandle>>& InstEffectClass = InstigatorEffectByClass.FindOrAdd(Context.Instigator.Get());
-		TSet<FGAEffectHandle>& EffectClass2 = InstEffectClass.FindOrAdd(SpecClass);
-		EffectClass2.Add(InHandle);
+		Slot.AggregationKey = FAFEffectAggregationKey(Context.Instigator.Get(), SpecClass);
+		Slot.bAggregated = true;
 		break;
-	}
 	case EGAEffectAggregation::AggregateByTarget:
-	{
-		TSet<FGAEffectHandle>& EffectClass = TargetEffectByClass.FindOrAdd(SpecClass);
-		EffectClass.Add(InHandle);
+		Slot.AggregationKey = FAFEffectAggregationKey(nullptr, SpecClass);
+		Slot.bAggregated = true;
+		break;
+	default:
 		break;
 	}
+
+	//copy keys, Slot reference is not needed after this point.
+	const FGAAttribute Attribute = Slot.Attribute;
+	const FObjectKey ClassKey = Slot.ClassKey;
+	const FAFEffectAggregationKey AggregationKey = Slot.AggregationKey;
+	const bool bAggregated = Slot.bAggregated;
+
+	LinkSlot(EffectByAttribute.FindOrAdd(Attribute), SlotIndex, EAFEffectSlotList::Attribute);
+	LinkSlot(EffectByClass.FindOrAdd(ClassKey), SlotIndex, EAFEffectSlotList::Class);
+	if (bAggregated)
+	{
+		LinkSlot(EffectByAggregation.FindOrAdd(AggregationKey), SlotIndex, EAFEffectSlotList::Aggregation);
 	}
 
-	ActiveEffects.Add(InHandle, InEffect);
-	FGAEffectContainer* sss = this;
-	int dbg = 0;
+	SlotByHandle.Add(InHandle, SlotIndex);
+	HandleByPrediction.Add(InPredHandle, InHandle);
+
+	return &ActiveEffectInfos[DenseIndex];
+}
+
+const FGAEffect* FGAEffectContainer::GetEffect(const FGAEffectHandle& InHandle) const
+{
+	const int32* SlotIndex = SlotByHandle.Find(InHandle);
+	if (!SlotIndex)
+		return nullptr;
+
+	const int32 DenseIndex = Slots[*SlotIndex].DenseIndex;
+	return ActiveEffectInfos.IsValidIndex(DenseIndex) ? &ActiveEffectInfos[DenseIndex] : nullptr;
 }
 
 void FGAEffectContainer::RemoveEffectByHandle(const FGAEffectHandle& InHandle, const FGAEffectContext& InContext, const FAFPropertytHandle& InProperty)
@@ -577,55 +675,62 @@ void FGAEffectContainer::RemoveEffectByHandle(const FGAEffectHandle& InHandle, c
 	RemoveEffectInternal(InProperty, InContext, InHandle);
 }
 
-TArray<FGAEffectHandle> FGAEffectContainer::RemoveEffect(const FAFPropertytHandle& HandleIn, const FGAEffectContext& InContext, int32 Num)
+void FGAEffectContainer::ResetEffects()
 {
-	UGAGameEffectSpec* Spec = HandleIn.GetSpecData();
-	EGAEffectAggregation Aggregation = Spec->EffectAggregation;
-	FObjectKey key(HandleIn.GetClass());
-	TArray<FGAEffectHandle>* handles = EffectByClass.Find(key);//GetHandlesByClass(HandleIn, InContext);
-	FGAEffectContainer* sss = this;
-	if (!handles)
-		return TArray<FGAEffectHandle>();
-	TArray<FGAEffectHandle> copy = *handles;
-
-	for (int32 idx = 0; idx < Num; idx++)
+	if (UWorld* World = GetWorld())
 	{
-		if (handles->IsValidIndex(0))
+		FAFEffectTimerManager& TimerManager = FAFEffectTimerManager::Get(World);
+		for (const TPair<FGAEffectHandle, int32>& Effect : SlotByHandle)
 		{
-			FGAEffectHandle OutHandle = (*handles)[idx];
-			RemoveEffectInternal(HandleIn, InContext, OutHandle);
+			TimerManager.RemoveEffect(Effect.Key);
 		}
 	}
+	//keep allocations, pooled owners will fill container again.
+	ActiveEffectInfos.Reset();
+	Slots.Reset();
+	FreeSlot = INDEX_NONE;
+	SlotByHandle.Reset();
+	HandleByPrediction.Reset();
+	EffectByAttribute.Reset();
+	EffectByClass.Reset();
+	EffectByAggregation.Reset();
+	InfiniteEffects.Reset();
+	MarkArrayDirty();
+}
 
-	
+TArray<FGAEffectHandle> FGAEffectContainer::RemoveEffect(const FAFPropertytHandle& HandleIn, const FGAEffectContext& InContext, int32 Num)
+{
+	TArray<FGAEffectHandle> Removed;
+	const FAFEffectSlotList* List = EffectByClass.Find(FObjectKey(HandleIn.GetClass()));
+	if (!List)
+		return Removed;
 
-	return copy;
+	const int32 RemoveNum = Num > 0 ? FMath::Min(Num, List->Num) : List->Num;
+	Removed.Reserve(RemoveNum);
+	const uint8 ListIdx = (uint8)EAFEffectSlotList::Class;
+	for (int32 SlotIndex = List->Head; SlotIndex != INDEX_NONE && Removed.Num() < RemoveNum; SlotIndex = Slots[SlotIndex].Next[ListIdx])
+	{
+		Removed.Add(Slots[SlotIndex].Handle);
+	}
+	//list is gone, once last effect of class is removed.
+	for (const FGAEffectHandle& Handle : Removed)
+	{
+		RemoveEffectInternal(HandleIn, InContext, Handle);
+	}
+	return Removed;
 }
 
 bool FGAEffectContainer::IsEffectActive(const FGAEffectHandle& HandleIn)
 {
-	if (ActiveEffects.Contains(HandleIn))
-	{
-		return true;
-	}
-	return false;
+	return SlotByHandle.Contains(HandleIn);
 }
 bool FGAEffectContainer::IsEffectActive(const FGAEffectHandle& HandleIn) const
 {
-	if (ActiveEffects.Contains(HandleIn))
-	{
-		return true;
-	}
-	return false;
+	return SlotByHandle.Contains(HandleIn);
 }
 bool FGAEffectContainer::ContainsEffectOfClass(const FAFPropertytHandle& InProperty)
 {
-	FObjectKey key(InProperty.GetClass());
-	if (EffectByClass.Contains(key))
-	{
-		return true;
-	}
-	return false;
+	return EffectByClass.Contains(FObjectKey(InProperty.GetClass()));
 }
 
 void FGAEffectContainer::ApplyFromReplication(const FGAEffectHandle& InHandle, const FAFPredictionHandle& InPredHandle, FGAEffect* InEffect)
@@ -718,14 +823,46 @@ UGAGameEffectSpec::UGAGameEffectSpec()
 	ExecutionType = UGAEffectExecution::StaticClass();
 	ApplicationRequirement = UAFEffectApplicationRequirement::StaticClass();
 	Application = UAFEffectCustomApplication::StaticClass();
+	bTagMasksBuilt = false;
+}
+#if WITH_EDITOR
+void UGAGameEffectSpec::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	bTagMasksBuilt = false;
+}
+#endif //WITH_EDITOR
+void UGAGameEffectSpec::BuildTagMasks() const
+{
+	if (bTagMasksBuilt)
+		return;
+
+	//explicit tags only, counted container matches them against parents of owned tags.
+	DenyMask = FAFGameplayTagMask(DenyTags);
+	ApplicationRequiredMask = FAFGameplayTagMask(ApplicationRequiredTags);
+	ExecutionDenyMask = FAFGameplayTagMask(ExecutionDenyTags);
+	bTagMasksBuilt = true;
+}
+const FAFGameplayTagMask& UGAGameEffectSpec::GetDenyMask() const
+{
+	BuildTagMasks();
+	return DenyMask;
+}
+const FAFGameplayTagMask& UGAGameEffectSpec::GetApplicationRequiredMask() const
+{
+	BuildTagMasks();
+	return ApplicationRequiredMask;
+}
+const FAFGameplayTagMask& UGAGameEffectSpec::GetExecutionDenyMask() const
+{
+	BuildTagMasks();
+	return ExecutionDenyMask;
 }
 
 float FGAEffectContainer::GetRemainingTime(const FGAEffectHandle& InHandle) const
 {
-	const FGAEffect* const * Effect = ActiveEffects.Find(InHandle);
-	if (Effect)
+	if (const FGAEffect* Ptr = GetEffect(InHandle))
 	{
-		const FGAEffect* Ptr = *Effect;
 		float Duration = Ptr->GetDurationTime();
 		return FMath::Clamp<float>(Duration - Ptr->GetCurrentDuration(), 0, Duration);
 	}
@@ -733,10 +870,8 @@ float FGAEffectContainer::GetRemainingTime(const FGAEffectHandle& InHandle) cons
 }
 float FGAEffectContainer::GetRemainingTimeNormalized(const FGAEffectHandle& InHandle) const
 {
-	const FGAEffect* const * Effect = ActiveEffects.Find(InHandle);
-	if (Effect)
+	if (const FGAEffect* Ptr = GetEffect(InHandle))
 	{
-		const FGAEffect* Ptr = *Effect;
 		float CurrentDuration = Ptr->GetCurrentDuration();
 		float MaxDuration = Ptr->GetDurationTime();
 
@@ -748,20 +883,16 @@ float FGAEffectContainer::GetRemainingTimeNormalized(const FGAEffectHandle& InHa
 }
 float FGAEffectContainer::GetCurrentTime(const FGAEffectHandle& InHandle) const
 {
-	const FGAEffect* const * Effect = ActiveEffects.Find(InHandle);
-	if (Effect)
+	if (const FGAEffect* Ptr = GetEffect(InHandle))
 	{
-		const FGAEffect* Ptr = *Effect;
 		return Ptr->GetCurrentDuration();
 	}
 	return 0;
 }
 float FGAEffectContainer::GetCurrentTimeNormalized(const FGAEffectHandle& InHandle) const
 {
-	const FGAEffect* const * Effect = ActiveEffects.Find(InHandle);
-	if (Effect)
+	if (const FGAEffect* Ptr = GetEffect(InHandle))
 	{
-		const FGAEffect* Ptr = *Effect;
 		float CurrentDuration = Ptr->GetCurrentDuration();
 		float MaxDuration = Ptr->GetDurationTime();
 		return CurrentDuration * 1 / MaxDuration;
@@ -775,97 +906,82 @@ float FGAEffectContainer::GetEndTime(const FGAEffectHandle& InHandle) const
 
 void FGAEffectContainer::RemoveEffectInternal(const FAFPropertytHandle& InProperty, const FGAEffectContext& InContext, const FGAEffectHandle& InHandle)
 {
-	FGAEffect* Effect = ActiveEffects[InHandle];
-	UGAGameEffectSpec* Spec = InProperty.GetSpecData();
-	UClass* SpecClass = Spec->GetClass();
-
-	FTimerManager& DurationTimer = InContext.TargetComp->GetWorld()->GetTimerManager();
-	DurationTimer.ClearTimer(Effect->DurationTimerHandle);
-	DurationTimer.ClearTimer(Effect->PeriodTimerHandle);
-
-	APawn* Instigator = InContext.Instigator.Get();
-	UObject* ObjectTarget = InContext.Target.Get();
-	FAFPredictionHandle PredHandle = PredictionByHandle[InHandle];
+	int32 SlotIndex = INDEX_NONE;
+	if (!SlotByHandle.RemoveAndCopyValue(InHandle, SlotIndex))
+		return;
 
-	HandleByPrediction.Remove(PredHandle);
-	PredictionByHandle.Remove(InHandle);
-	PredictedEffectInfos.Remove(PredHandle);
+	if (UWorld* World = GetWorld())
+	{
+		FAFEffectTimerManager::Get(World).RemoveEffect(InHandle);
+	}
 
-	FGAAttribute Attribute = Spec->AtributeModifier.Attribute;
-	EGAAttributeMod AttributeMod = Spec->AtributeModifier.AttributeMod;;
+	UGAGameEffectSpec* Spec = InProperty.GetSpecData();
+	FAFEffectSlot& Slot = Slots[SlotIndex];
+	HandleByPrediction.Remove(Slot.PredictionHandle);
 
-	TSet<FGAEffectHandle>* Effects = EffectByAttribute.Find(Spec->AtributeModifier.Attribute);
-	if (Effects)
+	if (FAFEffectSlotList* Effects = EffectByAttribute.Find(Slot.Attribute))
 	{
 		IAFAbilityInterface* IntTarget = InContext.TargetInterface;
-		IntTarget->RemoveBonus(Attribute, InHandle, AttributeMod);
-		Effects->Remove(InHandle);
-		if (Effects->Num() == 0)
+		IntTarget->RemoveBonus(Slot.Attribute, InHandle, Spec->AtributeModifier.AttributeMod);
+		if (UnlinkSlot(*Effects, SlotIndex, EAFEffectSlotList::Attribute))
 		{
-			EffectByAttribute.Remove(Spec->AtributeModifier.Attribute);
+			EffectByAttribute.Remove(Slot.Attribute);
 		}
 	}
 
-	FObjectKey EffectKey(SpecClass);
-	TArray<FGAEffectHandle>* EffectClass = EffectByClass.Find(EffectKey);
-	if (EffectClass)
+	if (FAFEffectSlotList* EffectClass = EffectByClass.Find(Slot.ClassKey))
 	{
-		EffectClass->Remove(InHandle);
-		if (EffectClass->Num() == 0)
+		if (UnlinkSlot(*EffectClass, SlotIndex, EAFEffectSlotList::Class))
 		{
-			EffectByClass.Remove(EffectKey);
+			EffectByClass.Remove(Slot.ClassKey);
 		}
 	}
 
-	switch (Spec->EffectAggregation)
+	if (Slot.bAggregated)
 	{
-	case EGAEffectAggregation::AggregateByInstigator:
-	{
-		TMap<UClass*, TSet<FGAEffectHandle>>* InstEffectClass = InstigatorEffectByClass.Find(Instigator);
-		if (InstEffectClass)
+		if (FAFEffectSlotList* Aggregated = EffectByAggregation.Find(Slot.AggregationKey))
 		{
-			TSet<FGAEffectHandle>* EffectClass2 = InstEffectClass->Find(SpecClass);
-			if (EffectClass2)
-			{
-				EffectClass2->Remove(InHandle);
-				if (EffectClass2->Num() == 0)
-				{
-					InstEffectClass->Remove(SpecClass);
-				}
-			}
-			if (InstEffectClass->Num() == 0)
+			if (UnlinkSlot(*Aggregated, SlotIndex, EAFEffectSlotList::Aggregation))
 			{
-				InstigatorEffectByClass.Remove(Instigator);
+				EffectByAggregation.Remove(Slot.AggregationKey);
 			}
 		}
-
-		break;
 	}
-	case EGAEffectAggregation::AggregateByTarget:
+
+	//swap last effect into freed place and point its slot there.
+	const int32 DenseIndex = Slot.DenseIndex;
+	if (ActiveEffectInfos.IsValidIndex(DenseIndex))
 	{
-		TSet<FGAEffectHandle>* EffectClass2 = TargetEffectByClass.Find(SpecClass);
-		if (EffectClass2)
+		ActiveEffectInfos.RemoveAtSwap(DenseIndex, 1, false);
+		if (ActiveEffectInfos.IsValidIndex(DenseIndex))
 		{
-			EffectClass2->Remove(InHandle);
-			if (EffectClass2->Num() == 0)
+			const int32 MovedSlot = ActiveEffectInfos[DenseIndex].SlotIndex;
+			if (Slots.IsValidIndex(MovedSlot))
 			{
-				TargetEffectByClass.Remove(SpecClass);
+				Slots[MovedSlot].DenseIndex = DenseIndex;
 			}
 		}
-		break;
+		DeferArrayDirty();
 	}
-	}
-	ActiveEffects.Remove(InHandle);
+	FreeSlotAt(SlotIndex);
 }
 
-bool FGAEffectContainer::IsEffectActive(TSubclassOf<UGAGameEffectSpec> EffectClass)
+void FGAEffectContainer::DeferArrayDirty()
 {
-	FObjectKey EffectKey(EffectClass);
-	if (EffectByClass.Contains(EffectKey))
+	//new items get their replication ids when array is serialized, nothing has to be marked per item.
+	if (OwningComponent)
+	{
+		OwningComponent->MarkEffectArrayDirty();
+	}
+	else
 	{
-		return true;
+		MarkArrayDirty();
 	}
-	return false;
+}
+
+bool FGAEffectContainer::IsEffectActive(TSubclassOf<UGAGameEffectSpec> EffectClass)
+{
+	return EffectByClass.Contains(FObjectKey(EffectClass.Get()));
 }
 
 void FAFEffectContainerSimple::ApplyEffect(const FGAEffectHandle& InHandle
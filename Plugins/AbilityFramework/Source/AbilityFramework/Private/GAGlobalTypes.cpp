@@ -246,111 +246,260 @@ FGAEffectContext::~FGAEffectContext()
 	InstigatorComp.Reset();
 }
 
-void FGACountedTagContainer::AddTag(const FGameplayTag& TagIn)
+TMap<FGameplayTag, int32> FAFGameplayTagIndex::Indexes;
+TArray<int32> FAFGameplayTagIndex::Parents;
+
+int32 FAFGameplayTagIndex::GetIndex(const FGameplayTag& InTag)
 {
-	int32& count = CountedTags.FindOrAdd(TagIn);
-	//if (count)
-	//{
-	//	*count += 1;
-	//	return;
-	//}
-	count++;
-	//CountedTags.Add(TagIn, 1);
-	AllTags.AddTag(TagIn);
+	if (!InTag.IsValid())
+		return INDEX_NONE;
+
+	if (const int32* Index = Indexes.Find(InTag))
+		return *Index;
+
+	//parent first, so parent index is always lower than child.
+	const int32 Parent = GetIndex(InTag.RequestDirectParent());
+	const int32 Index = Parents.Add(Parent);
+	Indexes.Add(InTag, Index);
+	return Index;
 }
-void FGACountedTagContainer::AddTagContainer(const FGameplayTagContainer& TagsIn)
+int32 FAFGameplayTagIndex::FindIndex(const FGameplayTag& InTag)
 {
-	for (auto TagIt = TagsIn.CreateConstIterator(); TagIt; ++TagIt)
+	const int32* Index = Indexes.Find(InTag);
+	return Index ? *Index : INDEX_NONE;
+}
+
+FAFGameplayTagMask::FAFGameplayTagMask(const FGameplayTagContainer& InTags, bool bIncludeParents)
+{
+	for (const FGameplayTag& Tag : InTags)
 	{
-		int32* count = CountedTags.Find(*TagIt);
-		if (count)
-		{
-			*count += 1;
-		}
-		else
+		int32 Index = FAFGameplayTagIndex::GetIndex(Tag);
+		Set(Index, true);
+		while (bIncludeParents && Index != INDEX_NONE)
 		{
-			CountedTags.Add(*TagIt, 1);
-			AllTags.AddTag(*TagIt);
+			Index = FAFGameplayTagIndex::GetParent(Index);
+			if (Index != INDEX_NONE)
+			{
+				Set(Index, true);
+			}
 		}
 	}
 }
-void FGACountedTagContainer::RemoveTag(const FGameplayTag& TagIn)
+bool FAFGameplayTagMask::IsEmpty() const
 {
-	int32* count = CountedTags.Find(TagIn);
-	if (count)
+	for (uint64 Word : Words)
 	{
-		*count -= 1;
-		if (*count <= 0)
-		{
-			CountedTags.Remove(TagIn);
-			AllTags.RemoveTag(TagIn);
-		}
+		if (Word)
+			return false;
 	}
+	return true;
 }
-void FGACountedTagContainer::RemoveTagContainer(const FGameplayTagContainer& TagsIn)
+bool FAFGameplayTagMask::HasAny(const FAFGameplayTagMask& InOther) const
 {
-	for (auto TagIt = TagsIn.CreateConstIterator(); TagIt; ++TagIt)
+	const int32 Num = FMath::Min(Words.Num(), InOther.Words.Num());
+	for (int32 Idx = 0; Idx < Num; Idx++)
+	{
+		if (Words[Idx] & InOther.Words[Idx])
+			return true;
+	}
+	return false;
+}
+bool FAFGameplayTagMask::HasAll(const FAFGameplayTagMask& InOther) const
+{
+	for (int32 Idx = 0; Idx < InOther.Words.Num(); Idx++)
 	{
-		int32* count = CountedTags.Find(*TagIt);
-		if (count)
+		const uint64 Word = Idx < Words.Num() ? Words[Idx] : 0;
+		if ((Word & InOther.Words[Idx]) != InOther.Words[Idx])
+			return false;
+	}
+	return true;
+}
+
+void FGACountedTagContainer::AddTagIndex(int32 InIndex, const FGameplayTag& InTag)
+{
+	if (InIndex >= Counts.Num())
+	{
+		Counts.AddZeroed(FAFGameplayTagIndex::Num() - Counts.Num());
+		ParentCounts.AddZeroed(FAFGameplayTagIndex::Num() - ParentCounts.Num());
+	}
+	Counts[InIndex]++;
+	if (Counts[InIndex] > 1)
+		return;
+
+	ExplicitMask.Set(InIndex, true);
+	AllTags.AddTag(InTag);
+	for (int32 Index = InIndex; Index != INDEX_NONE; Index = FAFGameplayTagIndex::GetParent(Index))
+	{
+		if (ParentCounts[Index]++ == 0)
 		{
-			*count -= 1;
+			ParentMask.Set(Index, true);
 		}
-		if (*count <= 0)
+	}
+}
+void FGACountedTagContainer::RemoveTagIndex(int32 InIndex, const FGameplayTag& InTag)
+{
+	if (!Counts.IsValidIndex(InIndex) || Counts[InIndex] <= 0)
+		return;
+
+	Counts[InIndex]--;
+	if (Counts[InIndex] > 0)
+		return;
+
+	ExplicitMask.Set(InIndex, false);
+	AllTags.RemoveTag(InTag);
+	for (int32 Index = InIndex; Index != INDEX_NONE; Index = FAFGameplayTagIndex::GetParent(Index))
+	{
+		if (--ParentCounts[Index] == 0)
 		{
-			CountedTags.Remove(*TagIt);
-			AllTags.RemoveTag(*TagIt);
+			ParentMask.Set(Index, false);
 		}
 	}
 }
-bool FGACountedTagContainer::HasTag(const FGameplayTag& TagIn)
+void FGACountedTagContainer::ResetCounts()
 {
-	return AllTags.HasTag(TagIn);
+	Counts.Reset();
+	ParentCounts.Reset();
+	ExplicitMask.Reset();
+	ParentMask.Reset();
 }
-bool FGACountedTagContainer::HasTagExact(const FGameplayTag TagIn)
+
+void FGACountedTagContainer::Reset()
 {
-	return AllTags.HasTagExact(TagIn);
+	ResetCounts();
+	AllTags.Reset();
 }
-bool FGACountedTagContainer::HasAny(const FGameplayTagContainer& TagsIn)
+
+void FGACountedTagContainer::AddTag(const FGameplayTag& TagIn)
 {
-	return AllTags.HasAny(TagsIn);
+	const int32 Index = FAFGameplayTagIndex::GetIndex(TagIn);
+	if (Index != INDEX_NONE)
+	{
+		AddTagIndex(Index, TagIn);
+	}
 }
-bool FGACountedTagContainer::HasAnyExact(const FGameplayTagContainer& TagsIn)
+void FGACountedTagContainer::AddTagContainer(const FGameplayTagContainer& TagsIn)
 {
-	return AllTags.HasAnyExact(TagsIn);
+	for (auto TagIt = TagsIn.CreateConstIterator(); TagIt; ++TagIt)
+	{
+		AddTag(*TagIt);
+	}
 }
-bool FGACountedTagContainer::HasAll(const FGameplayTagContainer& TagsIn)
+void FGACountedTagContainer::RemoveTag(const FGameplayTag& TagIn)
 {
-	return AllTags.HasAll(TagsIn);
+	const int32 Index = FAFGameplayTagIndex::FindIndex(TagIn);
+	if (Index != INDEX_NONE)
+	{
+		RemoveTagIndex(Index, TagIn);
+	}
 }
-bool FGACountedTagContainer::HasAllExact(const FGameplayTagContainer& TagsIn)
+void FGACountedTagContainer::RemoveTagContainer(const FGameplayTagContainer& TagsIn)
 {
-	return AllTags.HasAllExact(TagsIn);
+	for (auto TagIt = TagsIn.CreateConstIterator(); TagIt; ++TagIt)
+	{
+		RemoveTag(*TagIt);
+	}
 }
 
 bool FGACountedTagContainer::HasTag(const FGameplayTag& TagIn) const
 {
-	return AllTags.HasTag(TagIn);
+	return ParentMask.Get(FAFGameplayTagIndex::FindIndex(TagIn));
 }
 bool FGACountedTagContainer::HasTagExact(const FGameplayTag TagIn) const
 {
-	return AllTags.HasTagExact(TagIn);
+	return ExplicitMask.Get(FAFGameplayTagIndex::FindIndex(TagIn));
 }
 bool FGACountedTagContainer::HasAny(const FGameplayTagContainer& TagsIn) const
 {
-	return AllTags.HasAny(TagsIn);
+	for (const FGameplayTag& Tag : TagsIn)
+	{
+		if (HasTag(Tag))
+			return true;
+	}
+	return false;
 }
 bool FGACountedTagContainer::HasAnyExact(const FGameplayTagContainer& TagsIn) const
 {
-	return AllTags.HasAnyExact(TagsIn);
+	for (const FGameplayTag& Tag : TagsIn)
+	{
+		if (HasTagExact(Tag))
+			return true;
+	}
+	return false;
 }
 bool FGACountedTagContainer::HasAll(const FGameplayTagContainer& TagsIn) const
 {
-	return AllTags.HasAll(TagsIn);
+	for (const FGameplayTag& Tag : TagsIn)
+	{
+		if (!HasTag(Tag))
+			return false;
+	}
+	return true;
 }
 bool FGACountedTagContainer::HasAllExact(const FGameplayTagContainer& TagsIn) const
 {
-	return AllTags.HasAllExact(TagsIn);
+	for (const FGameplayTag& Tag : TagsIn)
+	{
+		if (!HasTagExact(Tag))
+			return false;
+	}
+	return true;
+}
+int32 FGACountedTagContainer::GetTagCount(const FGameplayTag& TagIn) const
+{
+	const int32 Index = FAFGameplayTagIndex::FindIndex(TagIn);
+	return Counts.IsValidIndex(Index) ? Counts[Index] : 0;
+}
+
+bool FGACountedTagContainer::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	AllTags.NetSerialize(Ar, Map, bOutSuccess);
+	if (Ar.IsLoading())
+	{
+		ResetCounts();
+		const FGameplayTagContainer ReceivedTags = AllTags;
+		AddTagContainer(ReceivedTags);
+	}
+	return true;
+}
+
+FAFAttributeChangedData FAFAttributeChangedRecord::ToChangedData() const
+{
+	FAFAttributeChangedData Data;
+	Data.Mod.Attribute = Attribute;
+	Data.Mod.AttributeMod = AttributeMod;
+	Data.Mod.Value = Value;
+	Data.Target = Target;
+	Data.Location = Location;
+	Data.NewValue = 0;
+	return Data;
+}
+bool FAFAttributeChangedRecord::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* TargetObj = Target.Get();
+	Map->SerializeObject(Ar, UObject::StaticClass(), TargetObj);
+
+	Ar << Attribute.AttributeName;
+
+	uint8 Mod = static_cast<uint8>(AttributeMod);
+	Ar.SerializeBits(&Mod, 3);
+
+	//zigzag encoded, so small negative values are packed as tightly as positive ones.
+	const int32 Quantized = FMath::RoundToInt(Value * 100.0f);
+	uint32 Packed = (uint32(Quantized) << 1) ^ uint32(Quantized >> 31);
+	Ar.SerializeIntPacked(Packed);
+
+	bool bLocationSuccess = true;
+	Location.NetSerialize(Ar, Map, bLocationSuccess);
+
+	if (Ar.IsLoading())
+	{
+		Target = TargetObj;
+		AttributeMod = static_cast<EGAAttributeMod>(Mod);
+		const int32 Unpacked = int32(Packed >> 1) ^ -int32(Packed & 1);
+		Value = Unpacked / 100.0f;
+	}
+	bOutSuccess = bLocationSuccess && !Ar.IsError();
+	return true;
 }
 
 FAFCueHandle FAFCueHandle::GenerateHandle()
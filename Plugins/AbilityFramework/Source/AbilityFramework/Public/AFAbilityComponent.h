@@ -344,12 +344,19 @@ public:
 	void NotifyInstigatorTargetAttributeChanged(const FAFAttributeChangedData& InData, 
 		const FGAEffectContext& InContext);
 
+	/* Changes caused by this component on server, waiting to be sent to owning client. */
+	TArray<FAFAttributeChangedRecord> PendingAttributeNotifies;
+	/* Sends pending changes in RPCs of at most af.MaxAttributeNotifiesPerRPC records. Called once per tick. */
+	void FlushAttributeNotifies();
+
 	UFUNCTION(Client, Unreliable)
-		void ClientNotifyAttributeModifier(const FAFAttributeChangedData& InData);
-	void ClientNotifyAttributeModifier_Implementation(const FAFAttributeChangedData& InData);
+		void ClientNotifyAttributeModifiers(const TArray<FAFAttributeChangedRecord>& InRecords);
+	void ClientNotifyAttributeModifiers_Implementation(const TArray<FAFAttributeChangedRecord>& InRecords);
 	FAFAttributeBase* GetAttribute(FGAAttribute AttributeIn) { return DefaultAttributes->GetAttribute(AttributeIn); };
 	void RemoveBonus(FGAAttribute AttributeIn, const FGAEffectHandle& HandleIn, EGAAttributeMod InMod) { DefaultAttributes->RemoveBonus(AttributeIn, HandleIn, InMod);  };
 	float NativeGetAttributeValue(const FGAAttribute AttributeIn) const { return 0; };
+	/* Restores attributes to values from archetype and attribute table. */
+	void ResetAttributes();
 
 private:
 	class IAFAbilityInterface* AttributeInterface;
@@ -10,6 +10,27 @@
 #include "AFCueManager.generated.h"
 
 
+UENUM()
+enum EAFCueEvent
+{
+	Activated,
+	Executed,
+	Expire,
+	Removed
+};
+
+/* Cue event received while cue class was still loading. */
+struct FAFPendingCueEvent
+{
+	FGAEffectCueParams CueParams;
+	EAFCueEvent CueEvent;
+
+	FAFPendingCueEvent(const FGAEffectCueParams& InCueParams, EAFCueEvent InCueEvent)
+		: CueParams(InCueParams)
+		, CueEvent(InCueEvent)
+	{}
+};
+
 USTRUCT()
 struct FAFCueData
 {
@@ -22,18 +43,50 @@ public:
 	UPROPERTY(Transient)
 		UClass* CueClass;
 
+	/* Events which arrived during load. Every cue have at most one load in flight. */
+	TArray<FAFPendingCueEvent> PendingEvents;
+	bool bLoading;
+	/* Number of active preload requests. Pinned cues are never evicted. */
+	int32 PinCount;
+	/* Links in resident list, most recently used first. */
+	int32 LruPrev;
+	int32 LruNext;
+
 	FAFCueData()
 		: CueClass(nullptr)
+		, bLoading(false)
+		, PinCount(0)
+		, LruPrev(INDEX_NONE)
+		, LruNext(INDEX_NONE)
 	{}
 };
 
-UENUM()
-enum EAFCueEvent
+USTRUCT()
+struct FAFCueActorPool
 {
-	Activated,
-	Executed,
-	Expire,
-	Removed
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+		TArray<AAFCueActor*> Actors;
+};
+
+/*
+	Set of cues loaded together, before they are needed.
+	Group is preloaded automatically on listed maps, or explicitly with UAFCueManager::PreloadGroup
+	(ie. when ability set using those cues is granted).
+*/
+USTRUCT()
+struct FAFCuePreloadGroup
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = "Cues")
+		FName GroupName;
+	/* Short names of maps, on which group is preloaded. */
+	UPROPERTY(EditAnywhere, Category = "Cues")
+		TArray<FString> Maps;
+	UPROPERTY(EditAnywhere, Category = "Cues")
+		FGameplayTagContainer CueTags;
 };
 
 struct FAFCueActorKey
@@ -96,16 +149,41 @@ protected:
 		static UAFCueManager* ManagerInstance;
 		UWorld* CurrentWorld;
 
-	UPROPERTY()
-		UObjectLibrary* StaticCues;
+	UPROPERTY(config)
+		TArray<FAFCuePreloadGroup> PreloadGroups;
+	/*
+		Maximum number of loaded cue classes kept in memory. When exceeded, least recently used
+		cues which are not pinned by preload are unloaded.
+	*/
+	UPROPERTY(config)
+		int32 MaxResidentCues;
 
-	TArray<FAFCueData> Cues;
+	/* Registry of all cues, built once from primary asset data. Indexes are stable. */
+	UPROPERTY()
+		TArray<FAFCueData> Cues;
 	TMap<FGameplayTag, int32> CuesMap;
 
+	int32 LruHead;
+	int32 LruTail;
+	int32 NumResident;
+	/* Groups preloaded for current map. */
+	TArray<FName> MapGroups;
+
+	/* Maximum number of idle actors kept per cue class. */
+	UPROPERTY(config)
+		int32 MaxPooledCueActors;
+	/* Idle actor cues in current world, per cue class. */
+	UPROPERTY()
+		TMap<UClass*, FAFCueActorPool> CueActorPools;
+
 	//Cues = Instigator+Target (optional) since Actor Cue might not have target (ie. Fire storm effect).
-	TMap<FAFCueActorKey, AAFCueActor> InstancedCues;
+	//weak, key type is not visible to GC and actors can be destroyed with their world.
+	TMap<FAFCueActorKey, TWeakObjectPtr<AAFCueActor>> InstancedCues;
 public:
+	UAFCueManager(const FObjectInitializer& ObjectInitializer);
 	void Initialize();
+	/* Fills Cues from StaticCue and ActorCue primary assets, after asset manager finished initial scan. */
+	void BuildCueRegistry();
 #if WITH_EDITOR
 	//handle clearing up cache when PIE mode is ending.
 	void HandleOnPIEEnd(bool InVal);
@@ -120,11 +198,34 @@ public:
 	
 	void HandleRemoveCue(const FGameplayTagContainer& Tags,
 		const FGAEffectCueParams& CueParams, FAFCueHandle InHandle);
+
+	/* Starts loading cues and keeps them loaded until matching ReleaseCues. */
+	void PreloadCues(const FGameplayTagContainer& InTags);
+	void ReleaseCues(const FGameplayTagContainer& InTags);
+	void PreloadGroup(const FName& InGroupName);
+	void ReleaseGroup(const FName& InGroupName);
+
+	/* Takes idle actor of given class from pool, or spawns new one if pool is empty. */
+	AAFCueActor* AcquireCueActor(UClass* InCueClass, const FGAEffectCueParams& InCueParams);
+	void ReleaseCueActor(AAFCueActor* InActor);
+#if !UE_BUILD_SHIPPING
+	/*
+		Acquires actor cue with InTag, returns it to pool and acquires it again.
+		Returns true if second acquire reused pooled actor. Used by af.Cues.TestActorPool.
+	*/
+	bool TestActorPool(UWorld* InWorld, const FGameplayTag& InTag);
+#endif //!UE_BUILD_SHIPPING
 protected:
-	void OnFinishedLoad(int32 Idx
-		, FPrimaryAssetId InPrimaryAssetId
-		, FGAEffectCueParams CueParams
-		, EAFCueEvent CueEvent);
+	void ClearCueActors();
+
+	void LoadCue(int32 Idx);
+	void OnFinishedLoad(int32 Idx);
+
+	void LinkResident(int32 Idx);
+	void UnlinkResident(int32 Idx);
+	void TouchResident(int32 Idx);
+	void EvictResidents();
+	const FAFCuePreloadGroup* FindGroup(const FName& InGroupName) const;
 
 	void HandleCueEvent(UClass* InCueClass, const FGAEffectCueParams& InCueParams, EAFCueEvent CueEvent);
 };
@@ -53,6 +53,9 @@ private:
 
 	TMap<FGameplayTag, TArray<FAFEventDelegate>> AppliedEvents;
 	TMap<FGameplayTag, TArray<FAFEventDelegate>> ExecutedEvents;
+
+	/* Effects have been added or removed since last replication, GameEffectContainer is marked dirty in PreReplication. */
+	bool bEffectArrayDirty;
 public:
 	FAFApplicationDelegate OnAppliedToTarget;
 	FAFApplicationDelegate OnAppliedToSelf;
@@ -72,6 +75,9 @@ protected:
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	/* Called by GameEffectContainer on every add and remove. */
+	inline void MarkEffectArrayDirty() { bEffectArrayDirty = true; }
 
 protected:
 
@@ -114,16 +120,16 @@ protected:
 		, const FAFFunctionModifier& Modifier = FAFFunctionModifier());
 
 public:
-	/* Have to to copy handle around, because timer delegates do not support references. */
-	void ExecuteEffect(FGAEffectHandle HandleIn
-		, FAFEffectParams Params
-		, FAFFunctionModifier Modifier);
+	/* Called by FAFEffectTimerManager on each period, and by application for instant effects. */
+	void ExecuteEffect(const FGAEffectHandle& HandleIn
+		, const FAFEffectParams& Params
+		, const FAFFunctionModifier& Modifier);
 	
 	virtual void PostExecuteEffect();
 	/* ExpireEffect is used to remove existing effect naturally when their time expires. */
 public:
-	void ExpireEffect(FGAEffectHandle HandleIn
-		, FAFEffectParams Params);
+	void ExpireEffect(const FGAEffectHandle& HandleIn
+		, const FAFEffectParams& Params);
 
 protected:
 	UFUNCTION(Client, Reliable)
@@ -140,6 +146,8 @@ protected:
 	void ExecuteEffectEvent(const FGameplayTag& InEventTag);
 	void RemoveEffectEvent(const FGameplayTag& InEventTag);
 	bool IsEffectActive(const FGAEffectHandle& InHandle) const;
+	/* Removes all effects and applied tags at once. Used when owner is reused instead of destroyed. */
+	void ResetEffects();
 
 public:
 	void AddEvent(const FGameplayTag& EventTag, FAFEventDelegate& EventDelegate);
@@ -159,6 +167,9 @@ public:
 public:
 	bool DenyEffectApplication(const FGameplayTagContainer& InTags);
 	bool HaveEffectRquiredTags(const FGameplayTagContainer& InTags);
+	/* Mask versions, for containers which are checked often (see UGAGameEffectSpec::GetDenyMask). */
+	inline bool DenyEffectApplication(const FAFGameplayTagMask& InMask) const { return HasAny(InMask); }
+	inline bool HaveEffectRquiredTags(const FAFGameplayTagMask& InMask) const { return HasAll(InMask); }
 protected:
 	/*
 
@@ -204,6 +215,8 @@ public:
 	inline bool HasAnyExact(const FGameplayTagContainer& TagsIn) const { return AppliedTags.HasAnyExact(TagsIn); };
 	inline bool HasAll(const FGameplayTagContainer& TagsIn) const { return AppliedTags.HasAll(TagsIn); };
 	inline bool HasAllExact(const FGameplayTagContainer& TagsIn) const { return AppliedTags.HasAllExact(TagsIn); };
+	inline bool HasAny(const FAFGameplayTagMask& InMask) const { return AppliedTags.HasAny(InMask); };
+	inline bool HasAll(const FAFGameplayTagMask& InMask) const { return AppliedTags.HasAll(InMask); };
 	inline int32 GetTagCount(const FGameplayTag& TagIn) const { return AppliedTags.GetTagCount(TagIn); }
 	/* Counted Tag Container Wrapper Start */
 
@@ -39,6 +39,57 @@ struct FNumericAttribute
 	AttributeReal Value;
 };
 
+/*
+	Modifiers of single type (Add, Multiply etc) applied to attribute.
+	Handles and values are kept in separate, packed arrays and removal swaps last element into the hole,
+	so they stay contiguous. Sum of all values is updated as modifiers come and go,
+	so bonus never needs to walk whole stack.
+*/
+struct ABILITYFRAMEWORK_API FAFAttributeModifierStack
+{
+	TArray<FGAEffectHandle> Handles;
+	TArray<float> Values;
+	/* Index into Handles/Values for each handle. */
+	TMap<FGAEffectHandle, int32> IndexByHandle;
+	/* Kept in double, so long add/remove sequences do not drift. */
+	double Sum;
+
+	FAFAttributeModifierStack()
+		: Sum(0)
+	{}
+
+	void Add(const FGAEffectHandle& InHandle, float InValue);
+	bool Remove(const FGAEffectHandle& InHandle);
+	void Reset();
+
+	inline int32 Num() const { return Values.Num(); }
+};
+
+/*
+	All modifiers applied to attribute, one stack per EGAAttributeMod.
+*/
+struct ABILITYFRAMEWORK_API FAFAttributeModifiers
+{
+	static constexpr int32 StackNum = static_cast<int32>(EGAAttributeMod::Invalid);
+
+	FAFAttributeModifierStack Stacks[StackNum];
+
+	inline FAFAttributeModifierStack& Get(EGAAttributeMod InMod) { return Stacks[static_cast<int32>(InMod)]; }
+	inline const FAFAttributeModifierStack& Get(EGAAttributeMod InMod) const { return Stacks[static_cast<int32>(InMod)]; }
+	inline static bool IsValidMod(EGAAttributeMod InMod)
+	{
+		return static_cast<int32>(InMod) >= 0 && static_cast<int32>(InMod) < StackNum;
+	}
+
+	void Reset()
+	{
+		for (FAFAttributeModifierStack& Stack : Stacks)
+		{
+			Stack.Reset();
+		}
+	}
+};
+
 class UAFAbilityComponent;
 /*
 	I probabaly should chaange attribute to use int's instead of floats. Stable, accurate and
@@ -95,8 +146,7 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Value")
 		TSubclassOf<class UGAAttributeExtension> ExtensionClass;
 
-	//Considering amount of bonuses TArray might be better than TMap, for cache coherency.
-	TArray<TMap<FGAEffectHandle, FGAEffectMod>> Modifiers;
+	FAFAttributeModifiers Modifiers;
 	FAFAttributeBase();
 	FAFAttributeBase(float BaseValueIn);
 	void InitializeAttribute(UAFAbilityComponent* InComponent, const FName InAttributeName);
@@ -6,6 +6,8 @@
 #include "Templates/SubclassOf.h"
 #include "UObject/UnrealType.h"
 #include "UObject/CoreNet.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/NetSerialization.h"
 #include "../Effects/GAGameEffect.h"
 #include "../GAGlobalTypes.h"
 #include "GAAttributeBase.h"
@@ -43,6 +45,131 @@
 	myriads of possible combinations of those tree systems. We would need to mix some instanced/non-instanced UObjects
 	along with plain structs. Which is probabaly going to be total mess.
 */
+/*
+	Attribute registered for quantized replication.
+	Values are sent as multiples of Precision. Precision <= 0 sends full float.
+*/
+struct FAFQuantizedAttribute
+{
+	FName Name;
+	float Precision;
+
+	FAFQuantizedAttribute(const FName& InName, float InPrecision)
+		: Name(InName)
+		, Precision(InPrecision)
+	{}
+};
+
+/* Single numeric value replicated by FAFQuantizedAttributeState. */
+struct FAFQuantizedField
+{
+	/* Index of attribute in FAFAttributeIndexTable. */
+	int32 Attribute;
+	/* Offset of value from start of owning object. */
+	int32 Offset;
+	float Precision;
+	/* Set for plain numeric attributes. Null for float fields of FAFAttributeBase. */
+	UNumericProperty* Property;
+};
+
+/*
+	Layout of attributes in single UGAAttributesBase class. Build once per class, on first use
+	and shared by all instances, so looking up attribute is index + offset instead of
+	reflection search. Tables are dropped when classes are reinstanced (blueprint compile, hot reload),
+	holders notice it through Generation.
+
+	Contains both complex attributes (FAFAttributeBase or derived) and plain numeric properties.
+*/
+struct ABILITYFRAMEWORK_API FAFAttributeIndexTable
+{
+	TMap<FName, int32> Indexes;
+	TArray<FName> Names;
+	TArray<UProperty*> Properties;
+	/* Offset of attribute value from start of owning object. */
+	TArray<int32> Offsets;
+	/* Indexes of FAFAttributeBase attributes only. */
+	TArray<int32> StructAttributes;
+	/* Values replicated trough FAFQuantizedAttributeState, in the order they were registered. */
+	TArray<FAFQuantizedField> NetFields;
+	/* Unique for every built table, never 0. */
+	uint32 Serial;
+
+	FAFAttributeIndexTable()
+		: Serial(0)
+	{}
+
+	static const FAFAttributeIndexTable& Get(UClass* InClass);
+	/* Drops all tables, properties and offsets they point to might be gone. */
+	static void Reset();
+	/* Changes every time tables are dropped. */
+	static inline uint32 GetGeneration() { return Generation; }
+
+	/* Resolves name only once per attribute and table, result is cached in InAttribute. */
+	inline int32 Find(const FGAAttribute& InAttribute) const
+	{
+		if (InAttribute.CachedTableSerial == Serial
+			&& Names.IsValidIndex(InAttribute.CachedIndex)
+			&& Names[InAttribute.CachedIndex] == InAttribute.AttributeName)
+		{
+			return InAttribute.CachedIndex;
+		}
+		const int32* Index = Indexes.Find(InAttribute.AttributeName);
+		InAttribute.CachedIndex = Index ? *Index : INDEX_NONE;
+		InAttribute.CachedTableSerial = Serial;
+		return InAttribute.CachedIndex;
+	}
+	inline bool IsStructAttribute(int32 InIndex) const
+	{
+		return Properties.IsValidIndex(InIndex) && Properties[InIndex]->IsA<UStructProperty>();
+	}
+	inline int32 Num() const { return Properties.Num(); }
+
+private:
+	static TMap<FObjectKey, TUniquePtr<FAFAttributeIndexTable>> Tables;
+	static uint32 NextSerial;
+	static uint32 Generation;
+
+	void Build(UClass* InClass);
+	void BuildNetFields(UClass* InClass);
+};
+
+/*
+	Replicates attributes registered in UGAAttributesBase::GetQuantizedAttributes.
+	Only values which changed since last state acknowledged by connection are sent, as index and
+	quantized value, so attribute set which did not change writes nothing at all.
+*/
+USTRUCT()
+struct ABILITYFRAMEWORK_API FAFQuantizedAttributeState
+{
+	GENERATED_BODY()
+public:
+	class UGAAttributesBase* Owner;
+
+	FAFQuantizedAttributeState()
+		: Owner(nullptr)
+	{}
+	//owner is set by owning object and never copied with state.
+	FAFQuantizedAttributeState(const FAFQuantizedAttributeState& Other)
+		: Owner(nullptr)
+	{}
+	FAFQuantizedAttributeState& operator=(const FAFQuantizedAttributeState& Other)
+	{
+		return *this;
+	}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FAFQuantizedAttributeState> : public TStructOpsTypeTraitsBase2<FAFQuantizedAttributeState>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+		WithCopy = false,
+	};
+};
+
 UCLASS(BlueprintType, Blueprintable, DefaultToInstanced, EditInlineNew)
 class ABILITYFRAMEWORK_API UGAAttributesBase : public UObject
 {
@@ -63,6 +190,11 @@ public:
 	*/
 	void CopyFromStruct(UStruct* StructType, void* StructObject);
 	void InitializeAttributesFromTable();
+	/*
+		Drops all modifiers and restores values from InDefaults (must be the same class) and AttributeValues table.
+		Used when owner is reused instead of being spawned again.
+	*/
+	void ResetAttributes(UGAAttributesBase* InDefaults);
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "Initialize Attributes"))
 		bool BP_InitializeAttributes();
 	/*
@@ -77,6 +209,21 @@ public:
 	*/
 	UPROPERTY(Replicated)
 	class UAFAbilityComponent* OwningAttributeComp;
+
+	UPROPERTY(Replicated)
+		FAFQuantizedAttributeState QuantizedAttributes;
+
+	/*
+		Register attributes which should be replicated trough quantized delta path,
+		the same way GetLifetimeReplicatedProps registers properties. Called once per class, on default object.
+		Registered attributes should not be marked as Replicated.
+	*/
+	virtual void GetQuantizedAttributes(TArray<FAFQuantizedAttribute>& OutAttributes) const {}
+	/*
+		Called on client after quantized attributes have been received.
+		@param InChangedAttributes - indexes (in attribute table) of attributes which changed.
+	*/
+	virtual void PostQuantizedAttributesReceived(const TArray<int32>& InChangedAttributes) {}
 protected:
 	UProperty* FindProperty(const FGAAttribute& AttributeIn);
 
@@ -96,6 +243,12 @@ public:
 		Gets pointer to compelx attribute.
 	*/
 	FAFAttributeBase* GetAttribute(const FGAAttribute& Name);
+	/*
+		Index of attribute in this class attribute table. Stable until class is reinstanced,
+		so it can be cached and used with GetAttributeByIndex.
+	*/
+	int32 GetAttributeIndex(const FGAAttribute& Name);
+	FAFAttributeBase* GetAttributeByIndex(int32 InIndex);
 	/*
 		Deprecated. I'm going to remove it, since it does not work as intended!
 	*/
@@ -131,11 +284,14 @@ protected:
 	bool bNetAddressable;
 
 private:
+	friend struct FAFQuantizedAttributeState;
+
 	TArray<FAFAttributeBase*> TickableAttributes;
-	UProperty* LastAttributeProp;
-	FName LastAttributeName;
-	// cached numeric property. WEll we probabaly don't need UProperty cache then..
-	UNumericProperty* CachedFloatPropety;
+	const FAFAttributeIndexTable* AttributeTable;
+	/* FAFAttributeIndexTable::Generation AttributeTable has been taken from. */
+	uint32 AttributeTableGeneration;
+
+	const FAFAttributeIndexTable& GetAttributeTable();
 	
 	float AddAttributeFloat(float ValueA, float ValueB);
 	float SubtractAttributeFloat(float ValueA, float ValueB);
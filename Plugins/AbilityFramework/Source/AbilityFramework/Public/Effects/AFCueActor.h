@@ -37,9 +37,26 @@ public:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	
-	// Called every frame
+	// Called every frame. Tick is only enabled while sequence is playing.
 	virtual void Tick( float DeltaSeconds ) override;
 
+	inline const FGameplayTag& GetCueTag() const { return CueTag; }
+
+	/* Called by UAFCueManager, when actor is reused from pool. */
+	virtual void OnTakenFromPool();
+	/* Called by UAFCueManager before actor goes back to pool. Stops sequence, hides actor and stops ticking. */
+	virtual void OnReturnedToPool();
+	/* Returns actor to pool now, or once sequence finishes playing. */
+	void ReleaseWhenFinished();
+
+	/* Reset any state set during cue, actor will be reused for another cue. */
+	UFUNCTION(BlueprintImplementableEvent)
+		void OnCueReset();
+
+	/* Actor is tracked by cue manager as active cue, and is not returned to pool when sequence ends. */
+	bool bInstanced;
+	bool bInPool;
+
 
 	UFUNCTION(BlueprintImplementableEvent)
 		void BeginCue(AActor* InstigatorOut, AActor* TargetOut, UObject* Causer,
@@ -58,6 +75,7 @@ public:
 		const FHitResult& HitInfo, const FGAEffectCueParams& CueParams);
 
 	void NativeOnExecuted();
+	void NativeOnExpired();
 	void NativeOnRemoved();
 	UPROPERTY()
 		float Duration;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/ObjectKey.h"
+#include "GAGlobalTypes.h"
+#include "GAGameEffect.h"
+
+DECLARE_STATS_GROUP(TEXT("EffectTimer"), STATGROUP_EffectTimer, STATCAT_Advanced);
+
+enum class EAFEffectTimerType : uint8
+{
+	Duration,
+	Period
+};
+
+/*
+	Single node in timing wheel. Nodes are linked into wheel buckets trough indexes,
+	so scheduling and canceling timer does not allocate once wheel is warmed up.
+*/
+struct FAFEffectTimer
+{
+	FGAEffectHandle Handle;
+	/* Wheel tick at which timer will fire. */
+	uint64 ExpireTick;
+	/* Number of ticks between executions, 0 for one shot timers. */
+	uint64 PeriodTicks;
+
+	int32 Next;
+	int32 Prev;
+	/* Bucket timer is currently linked into. INDEX_NONE if timer is free or waiting for execution. */
+	int32 Bucket;
+
+	EAFEffectTimerType Type;
+	bool bActive;
+
+	FAFEffectTimer()
+		: ExpireTick(0)
+		, PeriodTicks(0)
+		, Next(INDEX_NONE)
+		, Prev(INDEX_NONE)
+		, Bucket(INDEX_NONE)
+		, Type(EAFEffectTimerType::Duration)
+		, bActive(false)
+	{}
+};
+
+struct FAFExpiredEffectTimer
+{
+	FGAEffectHandle Handle;
+	EAFEffectTimerType Type;
+
+	FAFExpiredEffectTimer(const FGAEffectHandle& InHandle, EAFEffectTimerType InType)
+		: Handle(InHandle)
+		, Type(InType)
+	{}
+};
+
+/*
+	Hierarchical timing wheel. Level 0 have resolution of single tick, every next level
+	covers whole previous level in single bucket. Timers from upper levels are cascaded down
+	when lower level wraps around.
+
+	Wheel does not know anything about effects. Advance() only collects expired timers,
+	and owner decides what to do with them.
+*/
+class ABILITYFRAMEWORK_API FAFEffectTimerWheel
+{
+public:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotNum = 1 << SlotBits;
+	static constexpr uint64 SlotMask = SlotNum - 1;
+	static constexpr int32 LevelNum = 4;
+
+private:
+	TArray<FAFEffectTimer> Timers;
+	TArray<int32> FreeTimers;
+	/* Head of each bucket list. LevelNum * SlotNum entries. */
+	int32 Buckets[LevelNum * SlotNum];
+	/* Scratch array, so durations expiring in the same tick as periods are reported after them. */
+	TArray<int32> DueDurations;
+
+	uint64 CurrentTick;
+
+public:
+	FAFEffectTimerWheel();
+
+	int32 AddTimer(const FGAEffectHandle& InHandle, EAFEffectTimerType InType, uint64 InExpireTick, uint64 InPeriodTicks);
+	void RemoveTimer(int32 InTimer);
+	/* Moves existing timer to new tick, without touching it's period. */
+	void RescheduleTimer(int32 InTimer, uint64 InExpireTick);
+
+	/*
+		Advance wheel up to InTick (inclusive), appending timers which should fire to OutExpired in order they expired.
+		Periodic timers are put back on wheel right away, and can be reported multiple times if InTick is far ahead.
+		One shot timers are only unlinked and must be removed by owner.
+	*/
+	void Advance(uint64 InTick, TArray<FAFExpiredEffectTimer>& OutExpired);
+
+	inline uint64 GetCurrentTick() const { return CurrentTick; }
+	inline int32 GetTimersNum() const { return Timers.Num() - FreeTimers.Num(); }
+	inline const FAFEffectTimer& GetTimer(int32 InTimer) const { return Timers[InTimer]; }
+
+private:
+	void Link(int32 InTimer);
+	void Unlink(int32 InTimer);
+	void Cascade(int32 InLevel);
+};
+
+/*
+	Data needed to fire effect timers. Stored once per effect, instead of being copied
+	into every timer delegate.
+*/
+struct FAFEffectTimerEntry
+{
+	FAFEffectParams Params;
+	FAFFunctionModifier Modifier;
+	int32 DurationTimer;
+	int32 PeriodTimer;
+
+	FAFEffectTimerEntry(const FAFEffectParams& InParams, const FAFFunctionModifier& InModifier)
+		: Params(InParams)
+		, Modifier(InModifier)
+		, DurationTimer(INDEX_NONE)
+		, PeriodTimer(INDEX_NONE)
+	{}
+};
+
+/*
+	Per world scheduler for effect durations and periods.
+	Replaces separate FTimerManager timers for every effect. All timers which expired during frame
+	are collected once per world tick, and then executed in single batch.
+*/
+class ABILITYFRAMEWORK_API FAFEffectTimerManager : public FTickableGameObject
+{
+	static TMap<FObjectKey, TUniquePtr<FAFEffectTimerManager>> Managers;
+
+	TWeakObjectPtr<UWorld> World;
+	FAFEffectTimerWheel Wheel;
+	/*
+		Shared, because effect can be removed (or other effects added) while it's timer is executing.
+		Executing timer keeps reference to it's entry until it's done.
+	*/
+	TMap<FGAEffectHandle, TSharedPtr<FAFEffectTimerEntry>> Entries;
+	TArray<FAFExpiredEffectTimer> ExpiredTimers;
+
+	/* World time at which wheel tick 0 happened. */
+	double BaseTime;
+	/* Length of single wheel tick in seconds. */
+	double TickResolution;
+
+public:
+	static FAFEffectTimerManager& Get(UWorld* InWorld);
+	static void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+	static void Shutdown();
+
+	FAFEffectTimerManager(UWorld* InWorld);
+
+	/*
+		Start tracking effect. InDuration <= 0 means effect will never expire on it's own,
+		InPeriod <= 0 means effect will not be executed periodically.
+	*/
+	void AddEffect(const FGAEffectHandle& InHandle
+		, const FAFEffectParams& Params
+		, const FAFFunctionModifier& Modifier
+		, float InDuration
+		, float InPeriod);
+
+	void RemoveEffect(const FGAEffectHandle& InHandle);
+
+	/* Set new remaining duration for effect. Returns false if effect does not have duration timer. */
+	bool SetRemainingTime(const FGAEffectHandle& InHandle, float InDuration);
+	float GetRemainingTime(const FGAEffectHandle& InHandle) const;
+	inline bool HasEffect(const FGAEffectHandle& InHandle) const { return Entries.Contains(InHandle); }
+	inline int32 GetEffectsNum() const { return Entries.Num(); }
+
+	/* FTickableGameObject Begin */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return World.IsValid(); }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return World.Get(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(FAFEffectTimerManager, STATGROUP_EffectTimer); }
+	/* FTickableGameObject End */
+
+private:
+	double GetWorldTime() const;
+	/* First tick at or after InTime. Timers never fire early. */
+	uint64 TimeToTick(double InTime) const;
+	double TickToTime(uint64 InTick) const;
+	void ExecuteTimer(const FAFExpiredEffectTimer& InTimer);
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "HAL/PlatformAtomics.h"
+#include "Async/Async.h"
+
+/*
+	Reference counted slab of objects, addressed by index and generation.
+	Slots are allocated in fixed size chunks which are never moved or freed while pool is alive,
+	so once pool has grown to working size, creating and releasing objects does not touch general purpose heap.
+
+	Generation is increased every time slot is released, so stale index can't resolve to object
+	which has been created in the same slot later.
+
+	Objects are created on game thread only. References can be copied and released from any thread
+	(async effect application, trace callbacks), reference count is atomic and object released
+	off game thread is destroyed on game thread. Chunk table has fixed size, so it is never reallocated
+	under reader.
+
+	Every pool type has single instance owned by AbilityFramework module. Get is exported and specialized
+	in GAGameEffect.cpp for each pooled type, so handles copied in other modules resolve against the same pool.
+*/
+template<typename ObjectType, int32 SlotsPerChunk = 256, int32 MaxChunks = 256>
+class TAFHandlePool
+{
+	struct FSlot
+	{
+		TTypeCompatibleBytes<ObjectType> Storage;
+		uint32 Generation;
+		volatile int32 RefCount;
+		int32 NextFree;
+	};
+
+	FSlot* Chunks[MaxChunks];
+	int32 NumChunks;
+	int32 FreeHead;
+	int32 NumSlots;
+	int32 NumUsed;
+
+	TAFHandlePool()
+		: NumChunks(0)
+		, FreeHead(INDEX_NONE)
+		, NumSlots(0)
+		, NumUsed(0)
+	{}
+	~TAFHandlePool()
+	{
+		//handles living in static objects can outlive pool, in that case leave memory to process exit.
+		if (NumUsed > 0)
+			return;
+
+		for (int32 Idx = 0; Idx < NumChunks; Idx++)
+		{
+			FMemory::Free(Chunks[Idx]);
+		}
+	}
+
+	inline FSlot& GetSlot(int32 InIndex)
+	{
+		return Chunks[InIndex / SlotsPerChunk][InIndex % SlotsPerChunk];
+	}
+
+	void Grow()
+	{
+		checkf(NumChunks < MaxChunks, TEXT("TAFHandlePool: more than %d live objects"), SlotsPerChunk * MaxChunks);
+		FSlot* Chunk = (FSlot*)FMemory::Malloc(sizeof(FSlot) * SlotsPerChunk, alignof(FSlot));
+		//link new slots so the lowest index is handed out first.
+		for (int32 Idx = SlotsPerChunk - 1; Idx >= 0; Idx--)
+		{
+			Chunk[Idx].Generation = 1;
+			Chunk[Idx].RefCount = 0;
+			Chunk[Idx].NextFree = FreeHead;
+			FreeHead = NumSlots + Idx;
+		}
+		NumSlots += SlotsPerChunk;
+		Chunks[NumChunks] = Chunk;
+		//publish chunk before it can be handed out.
+		FPlatformMisc::MemoryBarrier();
+		NumChunks++;
+	}
+
+	void Free(int32 InIndex)
+	{
+		check(IsInGameThread());
+		FSlot& Slot = GetSlot(InIndex);
+		//bump generation first, destructor can release other handles.
+		Slot.Generation++;
+		Slot.Storage.GetTypedPtr()->~ObjectType();
+		Slot.NextFree = FreeHead;
+		FreeHead = InIndex;
+		NumUsed--;
+	}
+
+public:
+	/* Defined in AbilityFramework module only. */
+	static ABILITYFRAMEWORK_API TAFHandlePool& Get();
+
+	/* Constructs new object with reference count 1. */
+	template<typename... ArgTypes>
+	int32 Allocate(uint32& OutGeneration, ArgTypes&&... Args)
+	{
+		check(IsInGameThread());
+		if (FreeHead == INDEX_NONE)
+		{
+			Grow();
+		}
+		const int32 Index = FreeHead;
+		FSlot& Slot = GetSlot(Index);
+		FreeHead = Slot.NextFree;
+
+		new (Slot.Storage.GetTypedPtr()) ObjectType(Forward<ArgTypes>(Args)...);
+		Slot.RefCount = 1;
+		Slot.NextFree = INDEX_NONE;
+		NumUsed++;
+
+		OutGeneration = Slot.Generation;
+		return Index;
+	}
+
+	void AddRef(int32 InIndex, uint32 InGeneration)
+	{
+		FSlot& Slot = GetSlot(InIndex);
+		check(Slot.Generation == InGeneration && Slot.RefCount > 0);
+		FPlatformAtomics::InterlockedIncrement(&Slot.RefCount);
+	}
+
+	/* Destroys object, when last reference is released. Off game thread, destruction is queued to game thread. */
+	void Release(int32 InIndex, uint32 InGeneration)
+	{
+		FSlot& Slot = GetSlot(InIndex);
+		check(Slot.Generation == InGeneration && Slot.RefCount > 0);
+		if (FPlatformAtomics::InterlockedDecrement(&Slot.RefCount) > 0)
+			return;
+
+		if (!IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [InIndex]()
+			{
+				Get().Free(InIndex);
+			});
+			return;
+		}
+		Free(InIndex);
+	}
+
+	/* Returns nullptr if object in slot has been already released. */
+	inline ObjectType* Find(int32 InIndex, uint32 InGeneration)
+	{
+		FSlot& Slot = GetSlot(InIndex);
+		return Slot.Generation == InGeneration ? Slot.Storage.GetTypedPtr() : nullptr;
+	}
+
+	inline int32 Num() const { return NumUsed; }
+};
+
+/*
+	Shared reference to object in TAFHandlePool. Behaves like TSharedPtr,
+	but copying or releasing it only touches pool slot.
+*/
+template<typename ObjectType>
+struct TAFPooledRef
+{
+	typedef TAFHandlePool<ObjectType> FPool;
+private:
+	int32 Index;
+	uint32 Generation;
+
+public:
+	TAFPooledRef()
+		: Index(INDEX_NONE)
+		, Generation(0)
+	{}
+	TAFPooledRef(const TAFPooledRef& Other)
+		: Index(Other.Index)
+		, Generation(Other.Generation)
+	{
+		if (Index != INDEX_NONE)
+		{
+			FPool::Get().AddRef(Index, Generation);
+		}
+	}
+	TAFPooledRef(TAFPooledRef&& Other)
+		: Index(Other.Index)
+		, Generation(Other.Generation)
+	{
+		Other.Index = INDEX_NONE;
+		Other.Generation = 0;
+	}
+	~TAFPooledRef()
+	{
+		Reset();
+	}
+
+	TAFPooledRef& operator=(const TAFPooledRef& Other)
+	{
+		if (Index == Other.Index && Generation == Other.Generation)
+			return *this;
+
+		TAFPooledRef Copy(Other);
+		Swap(Index, Copy.Index);
+		Swap(Generation, Copy.Generation);
+		return *this;
+	}
+	TAFPooledRef& operator=(TAFPooledRef&& Other)
+	{
+		if (this != &Other)
+		{
+			Reset();
+			Index = Other.Index;
+			Generation = Other.Generation;
+			Other.Index = INDEX_NONE;
+			Other.Generation = 0;
+		}
+		return *this;
+	}
+
+	template<typename... ArgTypes>
+	static TAFPooledRef Make(ArgTypes&&... Args)
+	{
+		TAFPooledRef Ref;
+		Ref.Index = FPool::Get().Allocate(Ref.Generation, Forward<ArgTypes>(Args)...);
+		return Ref;
+	}
+
+	void Reset()
+	{
+		if (Index != INDEX_NONE)
+		{
+			//clear first, releasing can destroy objects which hold reference to this one.
+			const int32 OldIndex = Index;
+			Index = INDEX_NONE;
+			FPool::Get().Release(OldIndex, Generation);
+			Generation = 0;
+		}
+	}
+
+	inline bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+	inline ObjectType* Get() const
+	{
+		return Index != INDEX_NONE ? FPool::Get().Find(Index, Generation) : nullptr;
+	}
+	inline ObjectType& operator*() const
+	{
+		ObjectType* Object = Get();
+		check(Object);
+		return *Object;
+	}
+	inline ObjectType* operator->() const
+	{
+		ObjectType* Object = Get();
+		check(Object);
+		return Object;
+	}
+};
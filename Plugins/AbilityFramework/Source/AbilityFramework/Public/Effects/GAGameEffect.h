@@ -4,6 +4,7 @@
 #include "GameplayTagContainer.h"
 #include "UObject/ObjectMacros.h"
 #include "UObject/GCObject.h"
+#include "AFHandlePool.h"
 #include "GAGameEffect.generated.h"
 
 DECLARE_STATS_GROUP(TEXT("GameEffect"), STATGROUP_GameEffect, STATCAT_Advanced);
@@ -294,8 +295,24 @@ public:
 	/* If any of these tags are present on Effect Target, it will not be executed */
 	UPROPERTY(EditAnywhere, Category = "Tags")
 		FGameplayTagContainer ExecutionDenyTags;
+
+private:
+	/* Masks of tag containers checked against target on every application, built on first use. */
+	mutable FAFGameplayTagMask DenyMask;
+	mutable FAFGameplayTagMask ApplicationRequiredMask;
+	mutable FAFGameplayTagMask ExecutionDenyMask;
+	mutable bool bTagMasksBuilt;
+
+	void BuildTagMasks() const;
 public:
 	UGAGameEffectSpec();
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif //WITH_EDITOR
+
+	const FAFGameplayTagMask& GetDenyMask() const;
+	const FAFGameplayTagMask& GetApplicationRequiredMask() const;
+	const FAFGameplayTagMask& GetExecutionDenyMask() const;
 };
 /*
 	Base effect class to extend from when creating effect blueprints.
@@ -347,21 +364,24 @@ public:
 	}
 };
 
+template<> ABILITYFRAMEWORK_API TAFHandlePool<FGAEffectContext>& TAFHandlePool<FGAEffectContext>::Get();
+
 USTRUCT(BlueprintType)
 struct ABILITYFRAMEWORK_API FAFContextHandle
 {
 	GENERATED_BODY()
 private:
-	TSharedPtr<FGAEffectContext> DataPtr;
+	TAFPooledRef<FGAEffectContext> DataPtr;
 	uint32 ID;
 public:
-	static FAFContextHandle Generate(FGAEffectContext* InContext)
+	/* Constructs context in place, inside pooled storage. */
+	template<typename... ArgTypes>
+	static FAFContextHandle Generate(ArgTypes&&... Args)
 	{
 		static uint32 id = 0;
 		id++;
 
-		TSharedPtr<FGAEffectContext> PropPtr = MakeShareable<FGAEffectContext>(InContext);
-		FAFContextHandle Handle(PropPtr, id);
+		FAFContextHandle Handle(TAFPooledRef<FGAEffectContext>::Make(Forward<ArgTypes>(Args)...), id);
 
 		return Handle;
 	}
@@ -370,8 +390,8 @@ public:
 		: ID(0)
 	{};
 protected:
-	FAFContextHandle(TSharedPtr<FGAEffectContext> InProperty, uint32 InID)
-		: DataPtr(InProperty)
+	FAFContextHandle(TAFPooledRef<FGAEffectContext>&& InProperty, uint32 InID)
+		: DataPtr(MoveTemp(InProperty))
 		, ID(InID)
 	{};
 
@@ -386,11 +406,11 @@ public:
 	}
 	FGAEffectContext& GetRef()
 	{
-		return DataPtr.ToSharedRef().Get();
+		return *DataPtr;
 	}
 	FGAEffectContext& GetRef() const
 	{
-		return DataPtr.ToSharedRef().Get();
+		return *DataPtr;
 	}
 	FGAEffectContext* GetPtr()
 	{
@@ -523,22 +543,25 @@ public:
 	//}
 
 };
+template<> ABILITYFRAMEWORK_API TAFHandlePool<FAFEffectSpec>& TAFHandlePool<FAFEffectSpec>::Get();
+
 USTRUCT(BlueprintType)
 struct ABILITYFRAMEWORK_API FAFEffectSpecHandle
 {
 	GENERATED_BODY()
 public:
-	TSharedPtr<FAFEffectSpec> SpecPtr;
+	TAFPooledRef<FAFEffectSpec> SpecPtr;
 	uint32 ID;
 
 public:
-	static FAFEffectSpecHandle Generate(FAFEffectSpec* Effect)
+	/* Constructs spec in place, inside pooled storage. */
+	template<typename... ArgTypes>
+	static FAFEffectSpecHandle Generate(ArgTypes&&... Args)
 	{
 		static uint32 id = 0;
 		id++;
 
-		TSharedPtr<FAFEffectSpec> PropPtr = MakeShareable<FAFEffectSpec>(Effect);
-		FAFEffectSpecHandle Handle(PropPtr, id);
+		FAFEffectSpecHandle Handle(TAFPooledRef<FAFEffectSpec>::Make(Forward<ArgTypes>(Args)...), id);
 
 		return Handle;
 	}
@@ -546,8 +569,8 @@ public:
 	FAFEffectSpecHandle()
 		: ID(0)
 	{}
-	FAFEffectSpecHandle(TSharedPtr<FAFEffectSpec> Ptr, uint32 InID)
-		: SpecPtr(Ptr)
+	FAFEffectSpecHandle(TAFPooledRef<FAFEffectSpec>&& Ptr, uint32 InID)
+		: SpecPtr(MoveTemp(Ptr))
 		, ID(InID)
 	{}
 
@@ -560,17 +583,17 @@ public:
 		SpecPtr.Reset();
 		ID = 0;
 	}
-	TSharedPtr<FAFEffectSpec> GetPtr()
+	FAFEffectSpec* GetPtr()
 	{
-		return SpecPtr;
+		return SpecPtr.Get();
 	}
 	FAFEffectSpec& GetRef()
 	{
-		return SpecPtr.ToSharedRef().Get();
+		return *SpecPtr;
 	}
 	FAFEffectSpec& GetRef() const
 	{
-		return SpecPtr.ToSharedRef().Get();
+		return *SpecPtr;
 	}
 	FGAEffectMod GetModifier()
 	{
@@ -681,15 +704,15 @@ public:
 	{
 		if (EffectSpec.IsValid())
 		{
-			FAFEffectSpec* Ptr = EffectSpec.GetPtr().Get();
+			FAFEffectSpec* Ptr = EffectSpec.GetPtr();
 			Ptr->Instance();
 			return *Ptr;
 		}
 		else
 		{
-			FAFEffectSpec* LocalSpec = new FAFEffectSpec(EffectContext, SpecClass);
+			EffectSpec = FAFEffectSpecHandle::Generate(EffectContext, SpecClass);
+			FAFEffectSpec* LocalSpec = EffectSpec.GetPtr();
 			LocalSpec->Instance();
-			EffectSpec = FAFEffectSpecHandle::Generate(LocalSpec);
 			return *LocalSpec;
 		}
 	}
@@ -763,6 +786,8 @@ struct TStructOpsTypeTraits< FGAEffectProperty > : public TStructOpsTypeTraitsBa
 	};
 };
 
+template<> ABILITYFRAMEWORK_API TAFHandlePool<FGAEffectProperty>& TAFHandlePool<FGAEffectProperty>::Get();
+
 USTRUCT(BlueprintType)
 struct ABILITYFRAMEWORK_API FAFPropertytHandle
 {
@@ -771,19 +796,27 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Effect")
 		FGAEffectClass SpecClass;
 
-	TSharedPtr<FGAEffectProperty> DataPtr;
+	/*
+		Property is created on first use, so handles which are only default constructed
+		(asset defaults, temporaries) don't take pool slot. Copies share property only if source already had one.
+	*/
+	mutable TAFPooledRef<FGAEffectProperty> DataPtr;
 	//TSharedRef<FGAEffectProperty> Test;
 
 	uint32 ID;
-public:
-	FAFPropertytHandle()
-		: ID(0)
+private:
+	FGAEffectProperty* GetData() const
 	{
 		if (!DataPtr.IsValid())
 		{
-			DataPtr = MakeShareable<FGAEffectProperty>(new FGAEffectProperty());
+			DataPtr = TAFPooledRef<FGAEffectProperty>::Make();
 		}
-	};
+		return DataPtr.Get();
+	}
+public:
+	FAFPropertytHandle()
+		: ID(0)
+	{};
 
 	void Reset()
 	{
@@ -796,16 +829,14 @@ public:
 		: ID(0)
 	{
 		SpecClass = InSpecClass;
-		if (!DataPtr.IsValid())
-		{
-			DataPtr = MakeShareable<FGAEffectProperty>(new FGAEffectProperty());
-		}
 	};
 
+	//copying never allocates, it can happen off game thread (async loading, CopyScriptStruct).
 	FAFPropertytHandle(const FAFPropertytHandle& Other)
+		: DataPtr(Other.DataPtr)
+		, ID(0)
 	{
 		SpecClass = Other.SpecClass;
-		DataPtr = Other.DataPtr;
 	};
 
 	
@@ -826,25 +857,25 @@ public:
 		class APawn* Instigator
 		, UObject* Causer)
 	{
-		DataPtr->InitializeIfNotInitialized(Instigator, Causer, SpecClass.SpecClass);
+		GetData()->InitializeIfNotInitialized(Instigator, Causer, SpecClass.SpecClass);
 	}
 
 	FAFEffectSpec GetSpecCopy()
 	{
-		return DataPtr->GetSpecCopy();
+		return GetData()->GetSpecCopy();
 	}
 
 	FGAEffectProperty & GetRef()
 	{
-		return DataPtr.ToSharedRef().Get();
+		return *GetData();
 	}
 	FGAEffectProperty& GetRef() const
 	{
-		return DataPtr.ToSharedRef().Get();
+		return *GetData();
 	}
 	FGAEffectProperty* GetPtr() const
 	{
-		return DataPtr.Get();
+		return GetData();
 	}
 
 	FObjectKey GetClassKey() const
@@ -853,25 +884,25 @@ public:
 	}
 	inline float GetPeriod() const
 	{
-		return DataPtr->GetPeriod();
+		return GetData()->GetPeriod();
 	}
 	inline float GetDuration() const
 	{
-		return DataPtr->GetDuration();
+		return GetData()->GetDuration();
 	}
 	
 	UGAGameEffectSpec* GetSpecData()
 	{
-		return DataPtr->GetSpecData();
+		return GetData()->GetSpecData();
 	}
 	UGAGameEffectSpec* GetSpecData() const
 	{
-		return DataPtr->GetSpecData();
+		return GetData()->GetSpecData();
 	}
 
 	const bool IsInitialized() const
 	{
-		return DataPtr->IsInitialized();
+		return GetData()->IsInitialized();
 	}
 	const bool IsValid() const
 	{
@@ -953,7 +984,8 @@ public:
 	{
 		return EffectSpec;
 	}
-	FTimerManager& GetTargetTimerManager();
+	/* Scheduler for durations and periods of effects applied to target. */
+	class FAFEffectTimerManager& GetEffectTimerManager() const;
 
 	UAFEffectsComponent* GetTargetEffectsComponent();
 	UAFEffectsComponent* GetTargetEffectsComponent() const;
@@ -1026,16 +1058,17 @@ struct ABILITYFRAMEWORK_API FGAEffect : public FFastArraySerializerItem//, TShar
 	UPROPERTY()
 		FAFPredictionHandle PredictionHandle;
 
-	mutable FTimerHandle PeriodTimerHandle;
-	mutable FTimerHandle DurationTimerHandle;
-
 	UWorld* World;
 
 public:
 	float AppliedTime;
 	float LastTickTime;
 	float Period;
-	float Duration;
+	/* Replicated, so clients see duration extended by custom application. */
+	UPROPERTY()
+		float Duration;
+	/* Stable slot of this effect in owning FGAEffectContainer. Not replicated. */
+	int32 SlotIndex;
 public:
 	void PreReplicatedRemove(const struct FGAEffectContainer& InArraySerializer);
 	void PostReplicatedAdd(const struct FGAEffectContainer& InArraySerializer);
@@ -1052,9 +1085,12 @@ public:
 	//float GetFloatFromAttributeMagnitude(const FGAMagnitude& AttributeIn) const;
 
 	FGAEffect()
+		: World(nullptr)
+		, Duration(0)
+		, SlotIndex(INDEX_NONE)
 	{}
 
-	FGAEffect(TSharedPtr<FAFEffectSpec> InSpec, const FGAEffectHandle& InHandle);
+	FGAEffect(FAFEffectSpec* InSpec, const FGAEffectHandle& InHandle);
 
 	~FGAEffect();
 
@@ -1137,6 +1173,97 @@ public:
 	void AddCue(FGAEffectHandle EffectHandle, FGAEffectCueParams CueParams);
 };
 
+/* Secondary indexes kept over active effect slots. */
+enum class EAFEffectSlotList : uint8
+{
+	Class,
+	Attribute,
+	Aggregation,
+	MAX
+};
+
+/*
+	Head of intrusive list of effect slots. Links are stored in slots themselves,
+	so adding and removing effect from index never allocates per effect.
+*/
+struct FAFEffectSlotList
+{
+	int32 Head;
+	int32 Num;
+
+	FAFEffectSlotList()
+		: Head(INDEX_NONE)
+		, Num(0)
+	{}
+};
+
+/*
+	Key of aggregation index. Effects aggregated by instigator are grouped by instigator and class,
+	effects aggregated by target only by class (InstigatorKey is null).
+*/
+struct FAFEffectAggregationKey
+{
+	FObjectKey InstigatorKey;
+	FObjectKey ClassKey;
+
+	FAFEffectAggregationKey()
+	{}
+
+	FAFEffectAggregationKey(UObject* InInstigator, UClass* InClass)
+		: InstigatorKey(FObjectKey(InInstigator))
+		, ClassKey(FObjectKey(InClass))
+	{}
+
+	inline bool operator==(const FAFEffectAggregationKey& Other) const
+	{
+		return InstigatorKey == Other.InstigatorKey
+			&& ClassKey == Other.ClassKey;
+	}
+};
+
+inline uint32 GetTypeHash(const FAFEffectAggregationKey& Key)
+{
+	return HashCombine(GetTypeHash(Key.InstigatorKey), GetTypeHash(Key.ClassKey));
+}
+
+/*
+	Slot of active effect in FGAEffectContainer. Slot index is stable for as long as effect is active.
+	Effect itself lives in dense ActiveEffectInfos array and can be moved, when other effect is removed.
+*/
+struct FAFEffectSlot
+{
+	FGAEffectHandle Handle;
+	FAFPredictionHandle PredictionHandle;
+	FGAAttribute Attribute;
+	FObjectKey ClassKey;
+	FAFEffectAggregationKey AggregationKey;
+	/* INDEX_NONE when slot is free. */
+	int32 DenseIndex;
+	int32 NextFree;
+	bool bAggregated;
+
+	int32 Prev[(uint8)EAFEffectSlotList::MAX];
+	int32 Next[(uint8)EAFEffectSlotList::MAX];
+
+	FAFEffectSlot()
+		: DenseIndex(INDEX_NONE)
+		, NextFree(INDEX_NONE)
+		, bAggregated(false)
+	{
+		for (uint8 Idx = 0; Idx < (uint8)EAFEffectSlotList::MAX; Idx++)
+		{
+			Prev[Idx] = INDEX_NONE;
+			Next[Idx] = INDEX_NONE;
+		}
+	}
+};
+
+/*
+	Active effects are stored in slot map. ActiveEffectInfos is dense array which is replicated,
+	Slots give each effect stable index and all secondary indexes (class, attribute, aggregation)
+	are intrusive lists threaded through slots, so adding, removing and querying effects by class
+	does not need to rebuild or search any per effect containers.
+*/
 USTRUCT(BlueprintType)
 struct ABILITYFRAMEWORK_API FGAEffectContainer : public FFastArraySerializer
 {
@@ -1147,20 +1274,7 @@ public:
 	
 	UPROPERTY()
 	TMap<FAFPredictionHandle, FGAEffectHandle> HandleByPrediction;
-	
-	UPROPERTY()
-	TMap<FGAEffectHandle, FAFPredictionHandle> PredictionByHandle;
-
-	
-	TMap<FAFPredictionHandle, FGAEffect*> PredictedEffectInfos;
 
-	
-	TMap<FGAAttribute, TSet<FGAEffectHandle>> EffectByAttribute;
-
-	
-	TMap<FObjectKey, TArray<FGAEffectHandle>> EffectByClass;
-
-	TMap<FGAEffectHandle, FGAEffect*> ActiveEffects;
 	/* 
 		Contains effects with infinite duration.
 		Infinite effects are considred to be special case, where they can only be self spplied
@@ -1168,30 +1282,30 @@ public:
 	*/
 	UPROPERTY()
 	TSet<FGAEffectHandle> InfiniteEffects;
-	
-	//not really sure if we really need set.\
-	// it could be usefull, for effects which stack in add.
-	/*
-		UObject* - Instigator
-		FName = Effect class name
-		FGAEffectHandle = handle to effect of class.
-	*/
-	
-	TMap<UObject*, TMap<UClass*, TSet<FGAEffectHandle>>> InstigatorEffectByClass;
-
-	/*
-		FName = Effect class name
-		FGAEffectHandle = handle to effect of class.
-	*/
-	
-	TMap<UClass*, TSet<FGAEffectHandle>> TargetEffectByClass;
 
 	//Conditonally applied effects. Only duration/periodic.
 	//TMap<FGAEffectHandle, FAFPropertytHandle> ConditionalEffects;
 
 	UPROPERTY(NotReplicated)
 		class UAFEffectsComponent* OwningComponent;
+
+private:
+	TArray<FAFEffectSlot> Slots;
+	int32 FreeSlot;
+
+	TMap<FGAEffectHandle, int32> SlotByHandle;
+
+	TMap<FGAAttribute, FAFEffectSlotList> EffectByAttribute;
+	
+	TMap<FObjectKey, FAFEffectSlotList> EffectByClass;
+	/* Effects aggregated by instigator or target, see FAFEffectAggregationKey. */
+	TMap<FAFEffectAggregationKey, FAFEffectSlotList> EffectByAggregation;
+
 public:
+	FGAEffectContainer()
+		: OwningComponent(nullptr)
+		, FreeSlot(INDEX_NONE)
+	{}
 	
 	/*
 	* @call Order:
@@ -1218,16 +1332,22 @@ public:
 	TArray<FGAEffectHandle> RemoveEffect(const FAFPropertytHandle& HandleIn, const FGAEffectContext& InContext, int32 Num = 1);
 	/* Removesgiven number of effects of the same type. If Num == 0 Removes all effects */
 	void RemoveEffectByHandle(const FGAEffectHandle& InHandle, const FGAEffectContext& InContext, const FAFPropertytHandle& InProperty);
+	/*
+		Drops all effects and their timers at once, without removing their attribute bonuses.
+		Only valid when attributes are reset as well.
+	*/
+	void ResetEffects();
 
 	inline int32 GetEffectsNum() const { return ActiveEffectInfos.Num(); };
 
 	TSet<FGAEffectHandle> GetHandlesByClass(const FGAEffectProperty& InProperty,
 		const FGAEffectContext& InContext);
 
-	void AddEffect(
+	/* Adds copy of effect to container and indexes it. Returned pointer is valid until next add or remove. */
+	FGAEffect* AddEffect(
 		const FGAEffectHandle& InHandle
 		, const FAFPredictionHandle& InPredHandle
-		, FGAEffect* InEffect
+		, const FGAEffect& InEffect
 		, const FGAEffectProperty& InProperty
 		, const FAFEffectParams& Params
 		, bool bInfinite = false);
@@ -1258,13 +1378,23 @@ public:
 	float GetCurrentTimeNormalized(const FGAEffectHandle& InHandle) const;
 	float GetEndTime(const FGAEffectHandle& InHandle) const;
 
+	/* Returns nullptr if effect is not active. Pointer is valid until next add or remove. */
 	FGAEffect* GetEffect(const FGAEffectHandle& InHandle)
 	{
-		return ActiveEffects[InHandle];
+		return const_cast<FGAEffect*>(static_cast<const FGAEffectContainer*>(this)->GetEffect(InHandle));
 	}
+	const FGAEffect* GetEffect(const FGAEffectHandle& InHandle) const;
 	bool IsEffectActive(TSubclassOf<UGAGameEffectSpec> EffectClass);
 private:
 	void RemoveEffectInternal(const FAFPropertytHandle& InProperty, const FGAEffectContext& InContext, const FGAEffectHandle& InHandle);
+
+	int32 AllocateSlot();
+	void FreeSlotAt(int32 SlotIndex);
+	void LinkSlot(FAFEffectSlotList& List, int32 SlotIndex, EAFEffectSlotList ListType);
+	/* Returns true if list became empty and should be removed from index. */
+	bool UnlinkSlot(FAFEffectSlotList& List, int32 SlotIndex, EAFEffectSlotList ListType);
+	/* Array is marked dirty once by owning component before replication, not on every change. */
+	void DeferArrayDirty();
 };
 template<>
 struct TStructOpsTypeTraits< FGAEffectContainer > : public TStructOpsTypeTraitsBase2<FGAEffectContainer>
@@ -508,6 +508,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 		FName AttributeName;
 
+	/*
+		Index resolved by last FAFAttributeIndexTable::Find, and serial of that table.
+		Attributes kept in specs and mods resolve their name once per table instead of on every access.
+	*/
+	mutable int32 CachedIndex;
+	mutable uint32 CachedTableSerial;
+
 	inline bool operator== (const FGAAttribute& OtherAttribute) const
 	{
 		return (OtherAttribute.AttributeName == AttributeName);
@@ -529,10 +536,14 @@ public:
 	}
 
 	FGAAttribute()
+		: CachedIndex(INDEX_NONE)
+		, CachedTableSerial(0)
 	{
 		AttributeName = NAME_None;
 	};
 	FGAAttribute(const FName& AttributeNameIn)
+		: CachedIndex(INDEX_NONE)
+		, CachedTableSerial(0)
 	{
 		AttributeName = AttributeNameIn;
 	};
@@ -645,6 +656,53 @@ public:
 		float NewValue;
 };
 
+/*
+	Packed attribute change sent to instigator's client. Changes are batched per instigator
+	and sent once per tick, so only what's needed for UI is serialized, and value is quantized
+	to 0.01 and written as packed int.
+*/
+USTRUCT()
+struct ABILITYFRAMEWORK_API FAFAttributeChangedRecord
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+		TWeakObjectPtr<UObject> Target;
+	UPROPERTY()
+		FGAAttribute Attribute;
+	EGAAttributeMod AttributeMod;
+	UPROPERTY()
+		float Value;
+	UPROPERTY()
+		FVector_NetQuantize Location;
+
+	FAFAttributeChangedRecord()
+		: AttributeMod(EGAAttributeMod::Invalid)
+		, Value(0)
+		, Location(ForceInitToZero)
+	{}
+	FAFAttributeChangedRecord(const FAFAttributeChangedData& InData)
+		: Target(InData.Target)
+		, Attribute(InData.Mod.Attribute)
+		, AttributeMod(InData.Mod.AttributeMod)
+		, Value(InData.Mod.Value)
+		, Location(InData.Location)
+	{}
+
+	FAFAttributeChangedData ToChangedData() const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FAFAttributeChangedRecord> : public TStructOpsTypeTraitsBase2<FAFAttributeChangedRecord>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 /*
 Struct representing final modifier applied to attribute.
 */
@@ -684,21 +742,89 @@ public:
 	{};
 };
 
+/*
+	Assigns dense, stable index to every gameplay tag it sees, along with index of it's direct parent.
+	Indexes are never reused or invalidated (unlike tag net indexes, which can be rebuilt),
+	so they can be safely stored in bitsets for lifetime of process.
+*/
+struct ABILITYFRAMEWORK_API FAFGameplayTagIndex
+{
+private:
+	static TMap<FGameplayTag, int32> Indexes;
+	static TArray<int32> Parents;
+public:
+	/* Returns index of tag, registering it (and it's parents) if needed. INDEX_NONE for invalid tag. */
+	static int32 GetIndex(const FGameplayTag& InTag);
+	/* Returns index of tag, without registering it. INDEX_NONE if tag has never been seen. */
+	static int32 FindIndex(const FGameplayTag& InTag);
+	inline static int32 GetParent(int32 InIndex) { return Parents[InIndex]; }
+	inline static int32 Num() { return Parents.Num(); }
+};
+
+/*
+	Bitset over FAFGameplayTagIndex index space. First few hundred tags fit inline,
+	so most masks never allocate.
+*/
+struct ABILITYFRAMEWORK_API FAFGameplayTagMask
+{
+	TArray<uint64, TInlineAllocator<4>> Words;
+
+	FAFGameplayTagMask()
+	{}
+	/* Builds mask of explicit tags. With bIncludeParents, parents of every tag are set as well. */
+	FAFGameplayTagMask(const FGameplayTagContainer& InTags, bool bIncludeParents = false);
+
+	inline bool Get(int32 InIndex) const
+	{
+		const int32 Word = InIndex >> 6;
+		return InIndex >= 0 && Word < Words.Num() && (Words[Word] & (uint64(1) << (InIndex & 63))) != 0;
+	}
+	inline void Set(int32 InIndex, bool bValue)
+	{
+		const int32 Word = InIndex >> 6;
+		if (Word >= Words.Num())
+		{
+			if (!bValue)
+				return;
+			Words.AddZeroed(Word + 1 - Words.Num());
+		}
+		if (bValue)
+			Words[Word] |= uint64(1) << (InIndex & 63);
+		else
+			Words[Word] &= ~(uint64(1) << (InIndex & 63));
+	}
+	inline void Reset() { Words.Reset(); }
+
+	bool IsEmpty() const;
+	/* True if any bit of InOther is set in this mask. */
+	bool HasAny(const FAFGameplayTagMask& InOther) const;
+	/* True if every bit of InOther is set in this mask. */
+	bool HasAll(const FAFGameplayTagMask& InOther) const;
+};
+
+/*
+	Tags with reference count. Explicit tags and their parents are kept in two bitsets,
+	so queries are bit tests instead of tag container matching.
+	Parent matching follows FGameplayTagContainer - container with A.B.C HasTag(A.B), but not HasTagExact(A.B).
+
+	Only AllTags is replicated. Clients rebuild bitsets from it, with count 1 for every tag.
+*/
 USTRUCT()
 struct ABILITYFRAMEWORK_API FGACountedTagContainer
 {
 	GENERATED_USTRUCT_BODY()
 protected:
-	/*
-	Here we will store counted GamaplayTags.
-	If tag is already in map, we just incremement count.
-	*/
-	TMap<FGameplayTag, int32> CountedTags;
+	/* Count of every explicit tag, by FAFGameplayTagIndex. */
+	TArray<int32> Counts;
+	/* Count of tags in container which are tag or it's children, by FAFGameplayTagIndex. */
+	TArray<int32> ParentCounts;
+	FAFGameplayTagMask ExplicitMask;
+	FAFGameplayTagMask ParentMask;
 
 	/*
 	Here we store all currently posesd tags.
-	It is equivalent of CountedTags, except this does not track count of tags, but we need it
-	to have something against which we can perform queries.
+	It is equivalent of Counts, except this does not track count of tags, but we need it
+	for replication and for anyone who wants plain tag container.
 	*/
 public:
 	UPROPERTY()
@@ -711,14 +837,9 @@ public:
 	void AddTagContainer(const FGameplayTagContainer& TagsIn);
 	void RemoveTag(const FGameplayTag& TagIn);
 	void RemoveTagContainer(const FGameplayTagContainer& TagsIn);
+	/* Removes all tags, regardless of their count. */
+	void Reset();
 
-	bool HasTag(const FGameplayTag& TagIn);
-	bool HasTagExact(const FGameplayTag TagIn);
-	bool HasAny(const FGameplayTagContainer& TagsIn);
-	bool HasAnyExact(const FGameplayTagContainer& TagsIn);
-	bool HasAll(const FGameplayTagContainer& TagsIn);
-	bool HasAllExact(const FGameplayTagContainer& TagsIn);
-	
 	bool HasTag(const FGameplayTag& TagIn) const;
 	bool HasTagExact(const FGameplayTag TagIn) const;
 	bool HasAny(const FGameplayTagContainer& TagsIn) const;
@@ -726,15 +847,34 @@ public:
 	bool HasAll(const FGameplayTagContainer& TagsIn) const;
 	bool HasAllExact(const FGameplayTagContainer& TagsIn) const;
 
-	inline FGameplayTagContainer& GetAllTags()
+	/* Queries against prebuild masks. Build mask once and reuse it for repeated checks. */
+	inline bool HasAny(const FAFGameplayTagMask& InMask) const { return ParentMask.HasAny(InMask); }
+	inline bool HasAnyExact(const FAFGameplayTagMask& InMask) const { return ExplicitMask.HasAny(InMask); }
+	inline bool HasAll(const FAFGameplayTagMask& InMask) const { return ParentMask.HasAll(InMask); }
+	inline bool HasAllExact(const FAFGameplayTagMask& InMask) const { return ExplicitMask.HasAll(InMask); }
+
+	inline const FGameplayTagContainer& GetAllTags() const
 	{
 		return AllTags;
 	}
 
-	inline int32 GetTagCount(const FGameplayTag& TagIn) const
+	int32 GetTagCount(const FGameplayTag& TagIn) const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+private:
+	void AddTagIndex(int32 InIndex, const FGameplayTag& InTag);
+	void RemoveTagIndex(int32 InIndex, const FGameplayTag& InTag);
+	void ResetCounts();
+};
+
+template<>
+struct TStructOpsTypeTraits<FGACountedTagContainer> : public TStructOpsTypeTraitsBase2<FGACountedTagContainer>
+{
+	enum
 	{
-		return CountedTags.FindRef(TagIn);
-	}
+		WithNetSerializer = true,
+	};
 };
 
 
@@ -20,6 +20,8 @@ public class InventoryFramework : ModuleRules
 			new string[]
 			{
 				"Core",
+                "GameplayTags",
+                "JsonUObject"
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -33,8 +35,7 @@ public class InventoryFramework : ModuleRules
 				"Slate",
 				"SlateCore",
                 "Json",
-                "JsonUtilities",
-                "JsonUObject"
+                "JsonUtilities"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
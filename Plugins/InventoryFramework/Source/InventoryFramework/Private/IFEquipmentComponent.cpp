@@ -43,90 +43,176 @@ void UIFEquipmentComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 
 void UIFEquipmentComponent::AddItemFromInventory(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex)
 {
+	UIFItemBase* Item = Source ? Source->GetItem(SourceIndex) : nullptr;
+	if (!Item || !EquipmentItems.IsValidIndex(EquipmentIndex))
+		return;
+
 	if (GetOwnerRole() < ENetRole::ROLE_Authority)
 	{
-		UIFItemBase* Item = Source->GetItem(SourceIndex);
+		//stacked predictions on one slot could not be rolled back independently.
+		if (IsSlotPredicted(EquipmentIndex) || Source->IsSlotPredicted(SourceIndex))
+			return;
+
 		OnClientPreItemAdded(Item, EquipmentIndex);
-		ServerAddItemFromInventory(Source, SourceIndex, EquipmentIndex);
+		const uint16 PredictionKey = FIFPrediction::NewKey();
+		PredictSlot(EquipmentIndex, DuplicateObject<UIFItemBase>(Item, this), PredictionKey);
+		Source->PredictSlot(SourceIndex, nullptr, PredictionKey);
+		ServerAddItemFromInventory(Source, SourceIndex, EquipmentIndex, PredictionKey);
 	}
 	else
 	{
-		UIFItemBase* Item = Source->GetItem(SourceIndex);
-		if (!Item)
-			return;
-
 		EquipmentItems[EquipmentIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
 		
 		OnItemAdded(EquipmentItems[EquipmentIndex].Item, EquipmentIndex);
 		EquipmentItems[EquipmentIndex].Item->OnServerItemAddedEquipment(EquipmentItems[EquipmentIndex].Index);
 
 		OnItemAddedEvent.Broadcast(EquipmentIndex, EquipmentIndex, EquipmentItems[EquipmentIndex].Item);
-		
+		Source->RemoveItemOnServer(SourceIndex);
 	}
 }
-void UIFEquipmentComponent::ServerAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex)
+void UIFEquipmentComponent::ServerAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex, uint16 PredictionKey)
 {
-	UIFItemBase* Item = Source->GetItem(SourceIndex);
-	if (!Item)
+	UIFItemBase* Item = Source ? Source->GetItem(SourceIndex) : nullptr;
+	const bool bAccepted = Item
+		&& EquipmentItems.IsValidIndex(EquipmentIndex)
+		&& FIFPrediction::HaveSameOwner(this, Source);
+	if (bAccepted)
+	{
+		EquipmentItems[EquipmentIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
+		OnServerItemAdded(EquipmentItems[EquipmentIndex].Item, EquipmentIndex);
+		EquipmentItems[EquipmentIndex].Item->OnServerItemAddedEquipment(EquipmentItems[EquipmentIndex].Index);
+		OnItemAddedEvent.Broadcast(EquipmentIndex, EquipmentIndex, EquipmentItems[EquipmentIndex].Item);
+		//client has already removed it from inventory, as part of the same prediction.
+		Source->RemoveItemOnServer(SourceIndex);
+	}
+	if (PredictionKey != 0)
+	{
+		ClientPredictionAck(PredictionKey, bAccepted, Source);
+	}
+}
+bool UIFEquipmentComponent::ServerAddItemFromInventory_Validate(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex, uint16 PredictionKey)
+{
+	//server removes item from Source, it must not be someone else inventory.
+	return !Source || FIFPrediction::HaveSameOwner(this, Source);
+}
+
+void UIFEquipmentComponent::RemoveFromEquipment(uint8 EquipmentIndex)
+{
+	if (!GetItem(EquipmentIndex))
 		return;
 
-	EquipmentItems[EquipmentIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
-	OnServerItemAdded(EquipmentItems[EquipmentIndex].Item, EquipmentIndex);
-	EquipmentItems[EquipmentIndex].Item->OnServerItemAddedEquipment(EquipmentItems[EquipmentIndex].Index);
-	ClientAddItemFromInventory(Source, SourceIndex, EquipmentIndex);
-	OnItemAddedEvent.Broadcast(EquipmentIndex, EquipmentIndex, EquipmentItems[EquipmentIndex].Item);
-	
+	if (GetOwnerRole() < ENetRole::ROLE_Authority)
+	{
+		if (IsSlotPredicted(EquipmentIndex))
+			return;
+
+		const uint16 PredictionKey = FIFPrediction::NewKey();
+		PredictSlot(EquipmentIndex, nullptr, PredictionKey);
+		ServerRemoveFromEquipment(EquipmentIndex, PredictionKey);
+		return;
+	}
+	RemoveFromEquipmentOnServer(EquipmentIndex);
 }
-bool UIFEquipmentComponent::ServerAddItemFromInventory_Validate(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex)
+
+void UIFEquipmentComponent::ServerRemoveFromEquipment_Implementation(uint8 EquipmentIndex, uint16 PredictionKey)
+{
+	const bool bRemoved = RemoveFromEquipmentOnServer(EquipmentIndex);
+	if (PredictionKey != 0)
+	{
+		ClientPredictionAck(PredictionKey, bRemoved, nullptr);
+	}
+}
+bool UIFEquipmentComponent::ServerRemoveFromEquipment_Validate(uint8 EquipmentIndex, uint16 PredictionKey)
 {
 	return true;
 }
-void UIFEquipmentComponent::ClientAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex)
+
+bool UIFEquipmentComponent::RemoveFromEquipmentOnServer(uint8 EquipmentIndex)
 {
-	UIFItemBase* Item = Source->GetItem(SourceIndex);
+	UIFItemBase* Item = GetItem(EquipmentIndex);
 	if (!Item)
-		return;
+		return false;
 
-	EquipmentItems[EquipmentIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
-	EquipmentItems[EquipmentIndex].Item->OnItemAddedEquipment(EquipmentItems[EquipmentIndex].Index);
-	OnItemAdded(EquipmentItems[EquipmentIndex].Item, EquipmentIndex);
-	OnItemAddedEvent.Broadcast(EquipmentIndex, EquipmentIndex, EquipmentItems[EquipmentIndex].Item);
-	Source->RemoveItem(SourceIndex);
+	Item->OnServerItemRemovedEquipment(EquipmentItems[EquipmentIndex].Index);
+	Item->MarkPendingKill();
+	EquipmentItems[EquipmentIndex].Item = nullptr;
+	OnServerItemRemoved(EquipmentIndex);
+	OnItemRemovedEvent.Broadcast(EquipmentIndex, EquipmentIndex, Item);
+	return true;
 }
 
-
-void UIFEquipmentComponent::RemoveFromEquipment(uint8 EquipmentIndex)
+void UIFEquipmentComponent::ClientPredictionAck_Implementation(uint16 PredictionKey, bool bAccepted, class UIFInventoryComponent* Inventory)
 {
-	if (GetOwnerRole() < ENetRole::ROLE_Authority)
+	ResolvePrediction(PredictionKey, bAccepted);
+	if (Inventory)
 	{
-		ServerRemoveFromEquipment(EquipmentIndex);
-		return;
+		Inventory->ResolvePrediction(PredictionKey, bAccepted);
 	}
 }
 
-void UIFEquipmentComponent::ServerRemoveFromEquipment_Implementation(uint8 EquipmentIndex)
+void UIFEquipmentComponent::PredictSlot(uint8 InIndex, UIFItemBase* InItem, uint16 PredictionKey)
+{
+	if (!EquipmentItems.IsValidIndex(InIndex))
+		return;
+
+	FIFPredictedSlot Predicted;
+	Predicted.OldItem = EquipmentItems[InIndex].Item;
+	Predicted.PredictionKey = PredictionKey;
+	Predicted.Index = InIndex;
+	PredictedSlots.Add(Predicted);
+
+	SetSlotLocal(InIndex, InItem);
+}
+
+bool UIFEquipmentComponent::IsSlotPredicted(uint8 InIndex) const
 {
-	EquipmentItems[EquipmentIndex].Item->OnServerItemRemovedEquipment(EquipmentItems[EquipmentIndex].Index);
-	if (EquipmentItems[EquipmentIndex].Item)
+	return PredictedSlots.ContainsByPredicate([InIndex](const FIFPredictedSlot& Predicted)
 	{
-		EquipmentItems[EquipmentIndex].Item->MarkPendingKill();
-	}
-	EquipmentItems[EquipmentIndex].Item = nullptr;
-	ClientRemoveFromEquipment(EquipmentIndex);
-	OnServerItemRemoved(EquipmentIndex);
+		return Predicted.Index == InIndex;
+	});
 }
-bool UIFEquipmentComponent::ServerRemoveFromEquipment_Validate(uint8 EquipmentIndex)
+
+void UIFEquipmentComponent::ResolvePrediction(uint16 PredictionKey, bool bAccepted)
 {
-	return true;
+	for (int32 Idx = PredictedSlots.Num() - 1; Idx >= 0; Idx--)
+	{
+		if (PredictedSlots[Idx].PredictionKey != PredictionKey)
+			continue;
+
+		const FIFPredictedSlot Predicted = PredictedSlots[Idx];
+		PredictedSlots.RemoveAt(Idx);
+
+		//equipment items are local copies on client, whichever one is dropped can be destroyed.
+		UIFItemBase* Dropped = Predicted.OldItem;
+		if (!bAccepted)
+		{
+			Dropped = EquipmentItems[Predicted.Index].Item;
+			SetSlotLocal(Predicted.Index, Predicted.OldItem);
+		}
+		if (Dropped)
+		{
+			Dropped->MarkPendingKill();
+		}
+	}
 }
 
-void UIFEquipmentComponent::ClientRemoveFromEquipment_Implementation(uint8 EquipmentIndex)
+void UIFEquipmentComponent::SetSlotLocal(uint8 InIndex, UIFItemBase* InItem)
 {
-	EquipmentItems[EquipmentIndex].Item->OnItemRemovedEquipment(EquipmentItems[EquipmentIndex].Index);
-	if (EquipmentItems[EquipmentIndex].Item)
+	UIFItemBase* OldItem = EquipmentItems[InIndex].Item;
+	if (OldItem == InItem)
+		return;
+
+	EquipmentItems[InIndex].Item = InItem;
+	if (OldItem)
 	{
-		EquipmentItems[EquipmentIndex].Item->MarkPendingKill();
+		OldItem->OnItemRemovedEquipment(InIndex);
+		OnItemRemoved(InIndex);
+		OnItemRemovedEvent.Broadcast(InIndex, InIndex, OldItem);
 	}
-	EquipmentItems[EquipmentIndex].Item = nullptr;
-	OnItemRemoved(EquipmentIndex);
-}
\ No newline at end of file
+	if (InItem)
+	{
+		InItem->OnItemAddedEquipment(InIndex);
+		OnItemAdded(InItem, InIndex);
+		OnItemAddedEvent.Broadcast(InIndex, InIndex, InItem);
+	}
+}
@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "IFInventoryBackend.h"
+#include "IFRecordLog.h"
+
+#include "JsonUOSerialize.h"
+
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Async/Async.h"
+
+DEFINE_LOG_CATEGORY(LogIFBackend);
+
+TUniquePtr<FIFInventoryBackend> FIFInventoryBackend::Instance;
+
+FIFInventoryBackend::FIFInventoryBackend(const FString& InDirectory)
+	: Directory(InDirectory)
+	, WorkEvent(FPlatformProcess::GetSynchEventFromPool())
+	, Thread(nullptr)
+{
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		Thread = FRunnableThread::Create(this, TEXT("IFInventoryBackend"), 0, TPri_BelowNormal);
+	}
+}
+
+FIFInventoryBackend::~FIFInventoryBackend()
+{
+	if (Thread)
+	{
+		//worker writes everything still in queue before it exits.
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	Logs.Empty();
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+void FIFInventoryBackend::Startup()
+{
+	FString Directory = FPaths::ProjectSavedDir() / TEXT("Inventory");
+	FParse::Value(FCommandLine::Get(), TEXT("IFBackendDir="), Directory);
+	Instance = MakeUnique<FIFInventoryBackend>(Directory);
+}
+
+void FIFInventoryBackend::Shutdown()
+{
+	Instance.Reset();
+}
+
+FIFInventoryBackend* FIFInventoryBackend::Get()
+{
+	return Instance.Get();
+}
+
+void FIFInventoryBackend::Save(const FString& PlayerId, uint8 Slot, const FJsonUOBuffer& Json)
+{
+	FIFBackendCommand Command(EIFBackendCommand::Save, PlayerId, Slot);
+	FTCHARToUTF8 Converted(Json.GetData(), Json.Len());
+	Command.Payload.Append((const uint8*)Converted.Get(), Converted.Length());
+	Enqueue(Command);
+}
+
+void FIFInventoryBackend::Remove(const FString& PlayerId, uint8 Slot)
+{
+	FIFBackendCommand Command(EIFBackendCommand::Remove, PlayerId, Slot);
+	Enqueue(Command);
+}
+
+void FIFInventoryBackend::Load(const FString& PlayerId, const FIFOnBackendLoaded& OnLoaded)
+{
+	FIFBackendCommand Command(EIFBackendCommand::Load, PlayerId, 0);
+	Command.OnLoaded = OnLoaded;
+	Enqueue(Command);
+}
+
+void FIFInventoryBackend::Close(const FString& PlayerId)
+{
+	FIFBackendCommand Command(EIFBackendCommand::Close, PlayerId, 0);
+	Enqueue(Command);
+}
+
+uint32 FIFInventoryBackend::Run()
+{
+	while (true)
+	{
+		FIFBackendCommand Command;
+		while (Commands.Dequeue(Command))
+		{
+			Execute(Command);
+			PendingCommands.Decrement();
+		}
+		//everything written in this batch is flushed at once.
+		FlushLogs();
+
+		if (bStopping)
+			break;
+		WorkEvent->Wait();
+	}
+	//commands enqueued between last drain and Stop are still written before exit.
+	FIFBackendCommand Command;
+	while (Commands.Dequeue(Command))
+	{
+		Execute(Command);
+		PendingCommands.Decrement();
+	}
+	FlushLogs();
+	return 0;
+}
+
+void FIFInventoryBackend::Stop()
+{
+	bStopping = true;
+	WorkEvent->Trigger();
+}
+
+void FIFInventoryBackend::Enqueue(FIFBackendCommand& Command)
+{
+	if (bStopping)
+	{
+		UE_LOG(LogIFBackend, Warning, TEXT("Backend is shutting down, command for %s dropped."), *Command.PlayerId);
+		return;
+	}
+	if (!Thread)
+	{
+		Execute(Command);
+		FlushLogs();
+		return;
+	}
+	PendingCommands.Increment();
+	Commands.Enqueue(MoveTemp(Command));
+	WorkEvent->Trigger();
+}
+
+void FIFInventoryBackend::Execute(FIFBackendCommand& Command)
+{
+	if (Command.Type == EIFBackendCommand::Close)
+	{
+		//log flushes in destructor.
+		Logs.Remove(Command.PlayerId);
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FIFRecordLog* Log = FindOrOpenLog(Command.PlayerId);
+	switch (Command.Type)
+	{
+	case EIFBackendCommand::Save:
+		if (Log)
+		{
+			Log->Append(Command.Slot, Command.Payload, false);
+		}
+		break;
+	case EIFBackendCommand::Remove:
+		if (Log)
+		{
+			Log->Append(Command.Slot, Command.Payload, true);
+		}
+		break;
+	case EIFBackendCommand::Load:
+	{
+		TArray<FIFBackendRecord> Records;
+		if (Log)
+		{
+			Log->ReadLive(Records);
+			UE_LOG(LogIFBackend, Log, TEXT("Loaded %d slots of %s from %lld bytes (%s) in %.3f ms."),
+				Records.Num(), *Command.PlayerId, Log->GetFileSize(),
+				Log->WasLastReadMapped() ? TEXT("mapped") : TEXT("read"),
+				(FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		if (Command.OnLoaded.IsBound())
+		{
+			FIFOnBackendLoaded OnLoaded = Command.OnLoaded;
+			AsyncTask(ENamedThreads::GameThread, [OnLoaded, Records = MoveTemp(Records)]()
+			{
+				OnLoaded.ExecuteIfBound(Records);
+			});
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+FIFRecordLog* FIFInventoryBackend::FindOrOpenLog(const FString& PlayerId)
+{
+	if (TUniquePtr<FIFRecordLog>* Existing = Logs.Find(PlayerId))
+	{
+		return Existing->Get();
+	}
+
+	TUniquePtr<FIFRecordLog> NewLog = MakeUnique<FIFRecordLog>(GetLogFilename(PlayerId));
+	if (!NewLog->Open())
+		return nullptr;
+
+	FIFRecordLog* Log = NewLog.Get();
+	Logs.Add(PlayerId, MoveTemp(NewLog));
+	return Log;
+}
+
+void FIFInventoryBackend::FlushLogs()
+{
+	for (TPair<FString, TUniquePtr<FIFRecordLog>>& Pair : Logs)
+	{
+		Pair.Value->Flush();
+		if (Pair.Value->ShouldCompact())
+		{
+			Pair.Value->Compact();
+		}
+	}
+}
+
+FString FIFInventoryBackend::GetLogFilename(const FString& PlayerId) const
+{
+	//net ids can contain characters which are not valid in file names.
+	FString Name = PlayerId;
+	for (TCHAR& Char : Name.GetCharArray())
+	{
+		if (Char != 0 && !FChar::IsAlnum(Char) && Char != TEXT('-') && Char != TEXT('_'))
+		{
+			Char = TEXT('_');
+		}
+	}
+	return Directory / Name + TEXT(".iflog");
+}
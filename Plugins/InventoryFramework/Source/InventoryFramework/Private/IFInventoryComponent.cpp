@@ -6,6 +6,8 @@
 #include "Engine/AssetManager.h"
 
 #include "JsonUOSerialize.h"
+#include "JsonUODeserialize.h"
+#include "Serialization/BufferReader.h"
 
 #include "JsonObjectConverter.h"
 
@@ -13,13 +15,65 @@
 #include "IFItemActorBase.h"
 #include "IFInventoryInterface.h"
 #include "IFEquipmentComponent.h"
+#include "IFInventoryBackend.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/ActorChannel.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "TimerManager.h"
 
 
 
 DEFINE_LOG_CATEGORY(IFLog);
 
+void FIFItemData::PreReplicatedRemove(const struct FIFItemContainer& InArraySerializer)
+{
+	if (!InArraySerializer.IC.IsValid())
+		return;
+
+	InArraySerializer.IC->ItemSlotIndex.Set(Index, nullptr);
+	if (Item)
+	{
+		InArraySerializer.IC->NotifyItemRemoved(Item, Index);
+	}
+}
+void FIFItemData::PostReplicatedAdd(const struct FIFItemContainer& InArraySerializer)
+{
+	LocalItem = Item;
+	if (!InArraySerializer.IC.IsValid())
+		return;
+
+	InArraySerializer.IC->OnSlotReplicated(Index);
+	if (Item)
+	{
+		InArraySerializer.IC->NotifyItemAdded(Index);
+	}
+}
+void FIFItemData::PostReplicatedChange(const struct FIFItemContainer& InArraySerializer)
+{
+	if (InArraySerializer.IC.IsValid())
+	{
+		InArraySerializer.IC->OnSlotReplicated(Index);
+	}
+	if (LocalItem.Get() == Item)
+		return;
+
+	UIFItemBase* OldItem = LocalItem.Get();
+	LocalItem = Item;
+	if (!InArraySerializer.IC.IsValid())
+		return;
+
+	if (OldItem)
+	{
+		InArraySerializer.IC->NotifyItemRemoved(OldItem, Index);
+	}
+	if (Item)
+	{
+		InArraySerializer.IC->NotifyItemAdded(Index);
+	}
+}
+
 
 // Sets default values for this component's properties
 UIFInventoryComponent::UIFInventoryComponent()
@@ -39,28 +93,39 @@ UIFInventoryComponent::UIFInventoryComponent()
 void UIFInventoryComponent::InitializeComponent()
 {
 	Super::InitializeComponent();
+	Inventory.IC = this;
 }
 
 // Called when the game starts
 void UIFInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
-	uint8 Counter = 0;
-	for (uint8 Idx = 0; Idx < MaxSlots; Idx++)
-	{
-		FIFItemData NewItem;
-		NewItem.Item = nullptr;
-		NewItem.Index = Idx;
-		Counter++;
-		InventoryItems.Add(NewItem);
-	}
-	FakeBackend.SetNumZeroed(MaxSlots);
-	/*
-		Further steps
-		2. Load Properties from external data source (JSON);
-	*/
-	// ...
-	
+	Inventory.IC = this;
+	//clients get slots trough replication.
+	if (GetOwnerRole() == ENetRole::ROLE_Authority)
+	{
+		for (uint8 Idx = 0; Idx < MaxSlots; Idx++)
+		{
+			FIFItemData NewItem;
+			NewItem.Item = nullptr;
+			NewItem.Index = Idx;
+			Inventory.Items.Add(NewItem);
+			Inventory.MarkItemDirty(Inventory.Items.Last());
+		}
+		Inventory.MarkArrayDirty();
+		//player id is assigned after controller has been spawned.
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UIFInventoryComponent::LoadFromBackend);
+	}
+}
+
+void UIFInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FIFInventoryBackend* Backend = FIFInventoryBackend::Get();
+	if (Backend && !BackendId.IsEmpty())
+	{
+		Backend->Close(BackendId);
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -73,88 +138,151 @@ void UIFInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 
 TArray<uint8> UIFInventoryComponent::GetLocalItemIdxs(TSubclassOf<UIFItemBase> ItemClass)
 {
-	TArray<uint8> Idxs;
-	for (uint8 Idx = 0; Idx < InventoryItems.Num(); Idx++)
-	{
-		if (InventoryItems[Idx].Item && InventoryItems[Idx].Item->IsA(ItemClass))
-		{
-			Idxs.Add(Idx);
-		}
-	}
-
-	return Idxs;
-	//return Inventory.GetLocalItemIdxs(ItemClass);
+	return GetSlotsByClass(ItemClass);
 }
 
 bool UIFInventoryComponent::AcceptItem(UIFItemBase* Item, uint8 InLocaLIndex)
 {
-	bool bAccept = false;
+	if (!Item)
+		return false;
 
-	if (AcceptedClasses.Num() == 0)
+	const TBitArray<>& Slots = GetAcceptedSlots(Item->GetClass());
+	return InLocaLIndex < Slots.Num() && Slots[InLocaLIndex];
+}
+
+const TBitArray<>& UIFInventoryComponent::GetAcceptedSlots(UClass* ItemClass)
+{
+	const FObjectKey ClassKey(ItemClass);
+	if (const TBitArray<>* Cached = AcceptedSlots.Find(ClassKey))
 	{
-		bAccept = true;
+		return *Cached;
 	}
-	else
+
+	bool bInventoryAccepts = AcceptedClasses.Num() == 0;
+	for (const TSubclassOf<UIFItemBase>& Accepted : AcceptedClasses)
 	{
-		for (TSubclassOf<UIFItemBase>& ItemClass : AcceptedClasses)
+		if (ItemClass->IsChildOf(Accepted.Get()))
 		{
-			bAccept = false;
-			if (Item->IsA(ItemClass))
-			{
-				bAccept = true;
-				break; //no reason to check further.
-			}
+			bInventoryAccepts = true;
+			break;
 		}
 	}
 
-	if (bAccept)
+	TBitArray<> Slots(false, MaxSlots);
+	if (bInventoryAccepts)
 	{
-		if (AcceptedSlotClasses.Num() == 0)
-		{
-			bAccept = true;
-		}
-		else
+		for (int32 Idx = 0; Idx < MaxSlots; Idx++)
 		{
-			FIFSlotAcceptedClasses AC = AcceptedSlotClasses[InLocaLIndex];
-			if (AC.AcceptedClasses.Num() == 0)
+			bool bSlotAccepts = true;
+			if (AcceptedSlotClasses.IsValidIndex(Idx) && AcceptedSlotClasses[Idx].AcceptedClasses.Num() > 0)
 			{
-				bAccept = true;
-			}
-			else
-			{
-				for (TSubclassOf<UIFItemBase>& ItemClass : AC.AcceptedClasses)
+				bSlotAccepts = false;
+				for (const TSubclassOf<UIFItemBase>& Accepted : AcceptedSlotClasses[Idx].AcceptedClasses)
 				{
-					bAccept = false;
-					if (Item->IsA(ItemClass))
+					if (ItemClass->IsChildOf(Accepted.Get()))
 					{
-						bAccept = true;
-						break; //no reason to check further.
+						bSlotAccepts = true;
+						break;
 					}
 				}
 			}
+			Slots[Idx] = bSlotAccepts;
+		}
+	}
+	return AcceptedSlots.Add(ClassKey, MoveTemp(Slots));
+}
+
+int32 UIFInventoryComponent::FindFreeSlot(UIFItemBase* Item)
+{
+	for (int32 Idx = 0; Idx < Inventory.Items.Num(); Idx++)
+	{
+		if (!Inventory.Items[Idx].Item && AcceptItem(Item, Idx))
+		{
+			return Idx;
 		}
-		
 	}
-	return bAccept;
+	return INDEX_NONE;
 }
 
 void UIFInventoryComponent::MoveItemInInventory(uint8 NewLocalPostion, uint8 OldLocalPositin)
 {
-	if (GetOwnerRole() < ENetRole::ROLE_Authority)
+	if (NewLocalPostion == OldLocalPositin
+		|| !Inventory.Items.IsValidIndex(NewLocalPostion)
+		|| !Inventory.Items.IsValidIndex(OldLocalPositin))
 	{
 		return;
 	}
 
-	const FIFItemData& NewSlot = GetSlot(NewLocalPostion);
-	const FIFItemData& OldSlot = GetSlot(OldLocalPositin);
+	if (GetOwnerRole() < ENetRole::ROLE_Authority)
+	{
+		UIFItemBase* Moved = Inventory.Items[OldLocalPositin].Item;
+		UIFItemBase* Swapped = Inventory.Items[NewLocalPostion].Item;
+		//the same checks as server, so only moves rejected because of outdated client state are rolled back.
+		if (IsSlotPredicted(OldLocalPositin) || IsSlotPredicted(NewLocalPostion))
+			return;
+		if (!Moved || !AcceptItem(Moved, NewLocalPostion) || (Swapped && !AcceptItem(Swapped, OldLocalPositin)))
+			return;
+
+		const uint16 PredictionKey = FIFPrediction::NewKey();
+		PredictSlot(OldLocalPositin, Swapped, PredictionKey);
+		PredictSlot(NewLocalPostion, Moved, PredictionKey);
+		ServerMoveItemInInventory(NewLocalPostion, OldLocalPositin, PredictionKey);
+		return;
+	}
+	ServerMoveItemInInventory_Implementation(NewLocalPostion, OldLocalPositin, 0);
 }
 
-void UIFInventoryComponent::ServerMoveItemInInventory_Implementation(uint8 NewNetPostion, uint8 OldNetPositin)
+void UIFInventoryComponent::ServerMoveItemInInventory_Implementation(uint8 NewNetPostion, uint8 OldNetPositin, uint16 PredictionKey)
 {
+	UIFItemBase* Moved = Inventory.Items[OldNetPositin].Item;
+	UIFItemBase* Swapped = Inventory.Items[NewNetPostion].Item;
+	const bool bAccepted = NewNetPostion != OldNetPositin
+		&& Moved
+		&& AcceptItem(Moved, NewNetPostion)
+		&& (!Swapped || AcceptItem(Swapped, OldNetPositin));
+
+	if (bAccepted)
+	{
+		Inventory.Items[NewNetPostion].Item = Moved;
+		MarkSlotDirty(NewNetPostion);
+		Inventory.Items[OldNetPositin].Item = Swapped;
+		MarkSlotDirty(OldNetPositin);
+
+		Moved->OnServerItemChanged(NewNetPostion);
+		OnServerItemChanged(Moved, NewNetPostion);
+		ItemToJson(&Inventory.Items[NewNetPostion], JsonBuffer);
+		SendToBackend(JsonBuffer, NewNetPostion);
+		if (Swapped)
+		{
+			Swapped->OnServerItemChanged(OldNetPositin);
+			OnServerItemChanged(Swapped, OldNetPositin);
+			ItemToJson(&Inventory.Items[OldNetPositin], JsonBuffer);
+			SendToBackend(JsonBuffer, OldNetPositin);
+		}
+		else
+		{
+			RemoveFromBackend(OldNetPositin);
+		}
+
+		if (IsLocalOwner())
+		{
+			NotifyItemRemoved(Moved, OldNetPositin);
+			if (Swapped)
+			{
+				NotifyItemRemoved(Swapped, NewNetPostion);
+				NotifyItemAdded(OldNetPositin);
+			}
+			NotifyItemAdded(NewNetPostion);
+		}
+	}
+	if (PredictionKey != 0)
+	{
+		ClientPredictionAck(PredictionKey, bAccepted, nullptr);
+	}
 }
-bool UIFInventoryComponent::ServerMoveItemInInventory_Validate(uint8 NewNetPostion, uint8 OldNetPositin)
+bool UIFInventoryComponent::ServerMoveItemInInventory_Validate(uint8 NewNetPostion, uint8 OldNetPositin, uint16 PredictionKey)
 {
-	return true;
+	return NewNetPostion < Inventory.Items.Num() && OldNetPositin < Inventory.Items.Num();
 }
 
 void UIFInventoryComponent::AddAllItemsFromActor(class AIFItemActorBase* Source)
@@ -247,55 +375,64 @@ void UIFInventoryComponent::ClientAddItemFromEquipment_Implementation(class UIFE
 
 void UIFInventoryComponent::AddItemFromEquipmentAnySlot(class UIFEquipmentComponent* Source, uint8 SourceIndex)
 {
+	UIFItemBase* Item = Source ? Source->GetItem(SourceIndex) : nullptr;
+	if (!Item)
+		return;
+
+	const int32 FreeSlot = FindFreeSlot(Item);
+	if (FreeSlot == INDEX_NONE)
+		return;
+
 	if (GetOwnerRole() < ENetRole::ROLE_Authority)
 	{
-		UIFItemBase* Item = Source->GetItem(SourceIndex);
-		if (!Item)
+		if (IsSlotPredicted((uint8)FreeSlot) || Source->IsSlotPredicted(SourceIndex))
 			return;
-		ServerAddItemFromEquipmentAnySlot(Source, SourceIndex);
+
+		const uint16 PredictionKey = FIFPrediction::NewKey();
+		//local copy, replaced by replicated item once server adds it.
+		PredictSlot((uint8)FreeSlot, DuplicateObject<UIFItemBase>(Item, this), PredictionKey);
+		Source->PredictSlot(SourceIndex, nullptr, PredictionKey);
+		ServerAddItemFromEquipmentAnySlot(Source, SourceIndex, (uint8)FreeSlot, PredictionKey);
 		return;
 	}
+	ServerAddItemFromEquipmentAnySlot_Implementation(Source, SourceIndex, (uint8)FreeSlot, 0);
 }
-void UIFInventoryComponent::ServerAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex)
+void UIFInventoryComponent::ServerAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex, uint16 PredictionKey)
 {
-	UIFItemBase* Item = Source->GetItem(SourceIndex);
-	if (!Item)
-		return;
+	UIFItemBase* Item = Source ? Source->GetItem(SourceIndex) : nullptr;
+	const bool bAccepted = Item
+		&& FIFPrediction::HaveSameOwner(this, Source)
+		&& Inventory.Items.IsValidIndex(InventoryIndex)
+		&& !Inventory.Items[InventoryIndex].Item
+		&& AcceptItem(Item, InventoryIndex);
 
-	uint8 FreeSlot = 0;
-	for (uint8 Idx = 0; Idx < InventoryItems.Num(); Idx++)
+	if (bAccepted)
 	{
-		if (InventoryItems[Idx].Item == nullptr)
+		Inventory.Items[InventoryIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
+		MarkSlotDirty(InventoryIndex);
+
+		Inventory.Items[InventoryIndex].Item->OnServerItemAdded(InventoryIndex);
+
+		OnServerItemAdded(Inventory.Items[InventoryIndex].Item, InventoryIndex);
+		if (IsLocalOwner())
 		{
-			FreeSlot = Idx;
-			break;
+			NotifyItemAdded(InventoryIndex);
 		}
-	}
+		//client has already removed it from equipment, as part of the same prediction.
+		Source->RemoveFromEquipmentOnServer(SourceIndex);
 
-	InventoryItems[FreeSlot].Item = DuplicateObject<UIFItemBase>(Item, this);
-	
-	InventoryItems[FreeSlot].Item->OnServerItemAdded(FreeSlot);
-	
-	OnServerItemAdded(InventoryItems[FreeSlot].Item, FreeSlot);
-	ClientAddItemFromEquipmentAnySlot(Source, SourceIndex, FreeSlot);
-
-	TSharedPtr<FJsonObject> Obj = ItemToJson(&InventoryItems[FreeSlot]);
-	SendToBackend(Obj, FreeSlot);
-}
-bool UIFInventoryComponent::ServerAddItemFromEquipmentAnySlot_Validate(class UIFEquipmentComponent* Source, uint8 SourceIndex)
-{
-	return true;
+		ItemToJson(&Inventory.Items[InventoryIndex], JsonBuffer);
+		SendToBackend(JsonBuffer, InventoryIndex);
+	}
+	if (PredictionKey != 0)
+	{
+		ClientPredictionAck(PredictionKey, bAccepted, Source);
+	}
 }
-void UIFInventoryComponent::ClientAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex)
+bool UIFInventoryComponent::ServerAddItemFromEquipmentAnySlot_Validate(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex, uint16 PredictionKey)
 {
-	UIFItemBase* Item = Source->GetItem(SourceIndex);
-
-	InventoryItems[InventoryIndex].Item = DuplicateObject<UIFItemBase>(Item, this);
-
-	InventoryItems[InventoryIndex].Item->OnItemAdded(InventoryIndex);
-	OnItemAdded(InventoryItems[InventoryIndex].Item, InventoryIndex);
-
-	Source->RemoveFromEquipment(SourceIndex);
+	//server removes item from Source, it must not be someone else equipment.
+	return !Source || FIFPrediction::HaveSameOwner(this, Source);
 }
 
 void UIFInventoryComponent::AddItemAnySlot(class UIFItemBase* Source)
@@ -303,161 +440,262 @@ void UIFInventoryComponent::AddItemAnySlot(class UIFItemBase* Source)
 	if (!Source)
 		return;
 
-	uint8 FreeSlot = 0;
-	for (uint8 Idx = 0; Idx < InventoryItems.Num(); Idx++)
-	{
-		if (InventoryItems[Idx].Item == nullptr)
-		{
-			FreeSlot = Idx;
-			break;
-		}
-	}
+	//inventory is full, Source stays where it is.
+	const int32 FreeSlot = FindFreeSlot(Source);
+	if (FreeSlot == INDEX_NONE)
+		return;
 
-	InventoryItems[FreeSlot].Item = DuplicateObject<UIFItemBase>(Source, this);
+	Inventory.Items[FreeSlot].Item = DuplicateObject<UIFItemBase>(Source, this);
+	MarkSlotDirty(FreeSlot);
 	Source->MarkPendingKill();
 
-	TSharedPtr<FJsonObject> Obj = ItemToJson(&InventoryItems[FreeSlot]);
-	SendToBackend(Obj, FreeSlot);
+	ItemToJson(&Inventory.Items[FreeSlot], JsonBuffer);
+	SendToBackend(JsonBuffer, FreeSlot);
 
-	FString OutputString = JsonItemToString(Obj);
+	Inventory.Items[FreeSlot].Item->OnServerItemAdded(FreeSlot);
+	OnServerItemAdded(Inventory.Items[FreeSlot].Item, FreeSlot);
 
-	InventoryItems[FreeSlot].Item->OnServerItemAdded(FreeSlot);
-	OnServerItemAdded(InventoryItems[FreeSlot].Item, FreeSlot);
+	if (IsLocalOwner())
+	{
+		NotifyItemAdded(FreeSlot);
+	}
+}
 
-	ClientAddAnySlot(OutputString, FreeSlot);
+void UIFInventoryComponent::RemoveItem(uint8 InIndex)
+{
+	if(GetOwnerRole() < ENetRole::ROLE_Authority)
+	{
+		if (!GetItem(InIndex) || IsSlotPredicted(InIndex))
+			return;
+		const uint16 PredictionKey = FIFPrediction::NewKey();
+		PredictSlot(InIndex, nullptr, PredictionKey);
+		ServerRemoveItem(InIndex, PredictionKey);
+		return;
+	}
+	RemoveItemOnServer(InIndex);
 }
-void UIFInventoryComponent::ClientAddAnySlot_Implementation(const FString& JsonData, uint8 InventoryIndex)
+void UIFInventoryComponent::ServerRemoveItem_Implementation(uint8 InIndex, uint16 PredictionKey)
 {
-	FIFItemData Item = JsonToItem(JsonData);
-
-	if (Item.Item)
+	const bool bRemoved = RemoveItemOnServer(InIndex);
+	if (PredictionKey != 0)
 	{
-		InventoryItems[InventoryIndex] = Item;
-		OnItemAddedEvent.Broadcast(InventoryIndex, InventoryIndex, Item.Item);
-		OnItemUpdatedEvent.Broadcast(InventoryIndex, InventoryIndex, Item.Item);
-		InventoryItems[Item.Index].Item->OnItemAdded(Item.Index);
-		OnItemAdded(InventoryItems[Item.Index].Item, Item.Index);
+		ClientPredictionAck(PredictionKey, bRemoved, nullptr);
 	}
 }
+bool UIFInventoryComponent::ServerRemoveItem_Validate(uint8 InIndex, uint16 PredictionKey)
+{
+	return InIndex < MaxSlots;
+}
+bool UIFInventoryComponent::RemoveItemOnServer(uint8 InIndex)
+{
+	if (!Inventory.Items.IsValidIndex(InIndex))
+		return false;
 
-void UIFInventoryComponent::RemoveItem(uint8 InIndex)
+	UIFItemBase* Item = Inventory.Items[InIndex].Item;
+	if (!Item)
+		return false;
+
+	OnServerItemRemoved(Item, InIndex);
+	Item->OnServerItemRemoved(InIndex);
+	if (IsLocalOwner())
+	{
+		NotifyItemRemoved(Item, InIndex);
+	}
+	Item->MarkPendingKill();
+
+	Inventory.Items[InIndex].Item = nullptr;
+	MarkSlotDirty(InIndex);
+	RemoveFromBackend(InIndex);
+	return true;
+}
+void UIFInventoryComponent::ClientPredictionAck_Implementation(uint16 PredictionKey, bool bAccepted, class UIFEquipmentComponent* Equipment)
 {
-	if(GetOwnerRole() < ENetRole::ROLE_Authority)
+	ResolvePrediction(PredictionKey, bAccepted);
+	if (Equipment)
 	{
-		ServerRemoveItem(InIndex);
+		Equipment->ResolvePrediction(PredictionKey, bAccepted);
+	}
+}
+void UIFInventoryComponent::PredictSlot(uint8 InIndex, UIFItemBase* InItem, uint16 PredictionKey)
+{
+	if (!Inventory.Items.IsValidIndex(InIndex))
 		return;
+
+	FIFPredictedSlot Predicted;
+	Predicted.OldItem = Inventory.Items[InIndex].Item;
+	Predicted.PredictionKey = PredictionKey;
+	Predicted.Index = InIndex;
+	PredictedSlots.Add(Predicted);
+
+	SetSlotLocal(InIndex, InItem);
+}
+bool UIFInventoryComponent::IsSlotPredicted(uint8 InIndex) const
+{
+	return PredictedSlots.ContainsByPredicate([InIndex](const FIFPredictedSlot& Predicted)
+	{
+		return Predicted.Index == InIndex;
+	});
+}
+void UIFInventoryComponent::ResolvePrediction(uint16 PredictionKey, bool bAccepted)
+{
+	//accepted slots keep predicted item, until replication brings the server one.
+	for (int32 Idx = PredictedSlots.Num() - 1; Idx >= 0; Idx--)
+	{
+		if (PredictedSlots[Idx].PredictionKey != PredictionKey)
+			continue;
+
+		const FIFPredictedSlot Predicted = PredictedSlots[Idx];
+		PredictedSlots.RemoveAt(Idx);
+		if (!bAccepted)
+		{
+			SetSlotLocal(Predicted.Index, Predicted.OldItem);
+		}
 	}
-	//remove from backend
-	OnItemRemoved(InventoryItems[InIndex].Item, InIndex);
-	if (InventoryItems[InIndex].Item)
-		InventoryItems[InIndex].Item->MarkPendingKill();
+}
+void UIFInventoryComponent::NotifyItemAdded(uint8 InIndex)
+{
+	UIFItemBase* Item = Inventory.Items[InIndex].Item;
+	Item->ClientPostItemDeserializeFromJson();
+	Item->OnItemAdded(InIndex);
+
+	OnItemAddedEvent.Broadcast(InIndex, InIndex, Item);
+	OnItemUpdatedEvent.Broadcast(InIndex, InIndex, Item);
 
-	InventoryItems[InIndex].Item = nullptr;
-	ClientRemoveItem(InIndex);
+	OnItemAdded(Item, InIndex);
+}
+void UIFInventoryComponent::NotifyItemRemoved(UIFItemBase* InItem, uint8 InIndex)
+{
+	InItem->OnItemRemoved(InIndex);
+	OnItemRemovedEvent.Broadcast(InIndex, InIndex, InItem);
+	OnItemRemoved(InItem, InIndex);
 }
-void UIFInventoryComponent::ServerRemoveItem_Implementation(uint8 InIndex)
+void UIFInventoryComponent::SetSlotLocal(uint8 InIndex, UIFItemBase* InItem)
 {
-	OnServerItemRemoved(InventoryItems[InIndex].Item, InIndex);
-	InventoryItems[InIndex].Item->OnServerItemRemoved(InIndex);
-	if (InventoryItems[InIndex].Item)
-		InventoryItems[InIndex].Item->MarkPendingKill();
+	FIFItemData& Slot = Inventory.Items[InIndex];
+	UIFItemBase* OldItem = Slot.LocalItem.Get();
+	Slot.Item = InItem;
+	Slot.LocalItem = InItem;
+	ItemSlotIndex.Set(InIndex, InItem);
+	if (OldItem == InItem)
+		return;
 
-	InventoryItems[InIndex].Item = nullptr;
-	
-	ClientRemoveItem(InIndex);
+	if (OldItem)
+	{
+		NotifyItemRemoved(OldItem, InIndex);
+	}
+	if (InItem)
+	{
+		NotifyItemAdded(InIndex);
+	}
 }
-bool UIFInventoryComponent::ServerRemoveItem_Validate(uint8 InIndex)
+void UIFInventoryComponent::MarkSlotDirty(uint8 InIndex)
 {
-	return true;
+	FIFItemData& Slot = Inventory.Items[InIndex];
+	Inventory.MarkItemDirty(Slot);
+	ItemSlotIndex.Set(InIndex, Slot.Item);
 }
-void UIFInventoryComponent::ClientRemoveItem_Implementation(uint8 InIndex)
+void UIFInventoryComponent::OnSlotReplicated(uint8 InIndex)
 {
-	InventoryItems[InIndex].Item->OnItemRemoved(InIndex);
-	OnItemRemoved(InventoryItems[InIndex].Item, InIndex);
-	if (InventoryItems[InIndex].Item)
-		InventoryItems[InIndex].Item->MarkPendingKill();
+	//before notifications, so handlers already see the new slot content in lookups.
+	if (Inventory.Items.IsValidIndex(InIndex))
+	{
+		ItemSlotIndex.Set(InIndex, Inventory.Items[InIndex].Item);
+	}
 
-	InventoryItems[InIndex].Item = nullptr;
-	
+	//server state wins over anything predicted on this slot.
+	PredictedSlots.RemoveAll([InIndex](const FIFPredictedSlot& Predicted)
+	{
+		return Predicted.Index == InIndex;
+	});
+}
+bool UIFInventoryComponent::IsLocalOwner() const
+{
+	if (APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		return Pawn->IsLocallyControlled();
+	}
+	if (APlayerController* PC = Cast<APlayerController>(GetOwner()))
+	{
+		return PC->IsLocalController();
+	}
+	return GetNetMode() == ENetMode::NM_Standalone;
 }
 void UIFInventoryComponent::OnItemLoadedFreeSlot(TSoftClassPtr<class UIFItemBase> InItem)
 {
-	
-	uint8 FreeIndex = 0;
+	UClass* ItemClass = InItem.Get();
+	if (!ItemClass)
+		return;
 
-	for (uint8 Idx = 0; Idx < InventoryItems.Num(); Idx++)
+	const int32 FreeIndex = FindFreeSlot(ItemClass->GetDefaultObject<UIFItemBase>());
+	if (FreeIndex == INDEX_NONE)
 	{
-		if (!InventoryItems[Idx].Item)
-		{
-			FreeIndex = Idx;
-			break;
-		}
+		UE_LOG(IFLog, Warning, TEXT("Inventory %s is full, %s not added."), *GetName(), *ItemClass->GetName());
+		return;
 	}
-	AddItem(InItem, FreeIndex);
+	AddItem(InItem, (uint8)FreeIndex);
 }
 void UIFInventoryComponent::OnItemLoaded(TSoftClassPtr<class UIFItemBase> InItem, uint8 InNetIndex)
 {
 	AddItem(InItem, InNetIndex);
 }
 
-void UIFInventoryComponent::ClientSendJsonData_Implementation(const FString& Data)
+bool UIFInventoryComponent::ReplicateSubobjects(class UActorChannel *Channel, class FOutBunch *Bunch, FReplicationFlags *RepFlags)
 {
-	FIFItemData Item = JsonToItem(Data);
-	Item.Item->ClientPostItemDeserializeFromJson();
-	if (Item.Item)
-	{
-		Item.Item->OnItemAdded(Item.Index);
+	bool WroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
 
-		InventoryItems[Item.Index] = Item;
-		OnItemAddedEvent.Broadcast(Item.Index, Item.Index, Item.Item);
-		OnItemUpdatedEvent.Broadcast(Item.Index, Item.Index, Item.Item);
-
-		OnItemAdded(InventoryItems[Item.Index].Item, Item.Index);
+	for (const FIFItemData& Slot : Inventory.Items)
+	{
+		if (Slot.Item)
+			WroteSomething |= Channel->ReplicateSubobject(const_cast<UIFItemBase*>(Slot.Item), *Bunch, *RepFlags);
 	}
+
+	return WroteSomething;
 }
 
 void UIFInventoryComponent::AddItem(TSoftClassPtr<class UIFItemBase> InItem, uint8 ItemIndex)
 {
 	TSubclassOf<UIFItemBase> ItemClass = InItem.Get();
-	FIFItemData Item;
-	Item.Index = ItemIndex;
+	//modify slot in place, so it keeps it's replication id.
+	FIFItemData& Item = Inventory.Items[ItemIndex];
 	Item.Item = NewObject<UIFItemBase>(this, ItemClass);
 	Item.Item->OnServerItemLoaded();
+	MarkSlotDirty(Item.Index);
 
-	InventoryItems[Item.Index] = Item;
-	InventoryItems[Item.Index].Item->OnServerItemAdded(Item.Index);
-	OnServerItemAdded(InventoryItems[Item.Index].Item, Item.Index);
+	Item.Item->OnServerItemAdded(Item.Index);
+	OnServerItemAdded(Item.Item, Item.Index);
 
-	TSharedPtr<FJsonObject> Obj = ItemToJson(&InventoryItems[Item.Index]);
-	SendToBackend(Obj, Item.Index);
+	ItemToJson(&Item, JsonBuffer);
+	SendToBackend(JsonBuffer, Item.Index);
 
-	FString OutputString = JsonItemToString(Obj);
-
-	UE_LOG(IFLog, Log, TEXT("ItemLoaded %s "), *OutputString);
-	ClientSendJsonData(OutputString);
+	UE_LOG(IFLog, Log, TEXT("ItemLoaded %s "), *Item.Item->GetName());
+	if (IsLocalOwner())
+	{
+		NotifyItemAdded(Item.Index);
+	}
 
 	FStreamableManager& Manager = UAssetManager::GetStreamableManager();
 	Manager.Unload(InItem.ToSoftObjectPath());
 }
 
-TSharedPtr<FJsonObject> UIFInventoryComponent::ItemToJson(FIFItemData* Item)
+void UIFInventoryComponent::ItemToJson(FIFItemData* Item, FJsonUOBuffer& OutBuffer)
 {
-	typedef TJsonWriter< TCHAR, TPrettyJsonPrintPolicy<TCHAR> > FPrettyJsonStringWriter;
-	typedef TJsonWriterFactory< TCHAR, TPrettyJsonPrintPolicy<TCHAR> > FPrettyJsonStringWriterFactory;
-
-	TSharedPtr<FJsonObject> Obj = MakeShareable(new FJsonObject());
-	TSharedPtr<FJsonObject> UObj = MakeShareable(new FJsonObject());
+	//streamed directly into buffer, without building FJsonObject for every property.
+	TSharedRef<FJsonUOWriter> Writer = OutBuffer.CreateWriter();
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("index"), (int32)Item->Index);
 	if (Item->Item)
 	{
 		Item->Item->PreItemSerializeToJson();
-		FJsonUOSerialize::UObjectToJsonObject(Item->Item->GetClass(), Item->Item, UObj.ToSharedRef());
-		//UObj = Item->Item->SaveToJson();
+		const FString ItemField(TEXT("item"));
+		FJsonUOSerialize::UObjectToJsonWriter(Item->Item->GetClass(), Item->Item, *Writer, &ItemField);
 	}
-	Obj->Values.Add(FString("index"), MakeShareable(new FJsonValueNumber(Item->Index)));
-	Obj->Values.Add(FString("item"), MakeShareable(new FJsonValueObject(UObj)));
-	FakeBackend[Item->Index] = Obj;
-
-	return Obj;
+	else
+	{
+		Writer->WriteObjectStart(TEXT("item"));
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteObjectEnd();
+	Writer->Close();
 }
 FString UIFInventoryComponent::JsonItemToString(TSharedPtr<FJsonObject> Object)
 {
@@ -470,31 +708,118 @@ FString UIFInventoryComponent::JsonItemToString(TSharedPtr<FJsonObject> Object)
 
 	return OutputString;
 }
-void UIFInventoryComponent::SendToBackend(TSharedPtr<FJsonObject> JsonObj, int32 Idx)
+void UIFInventoryComponent::SendToBackend(const FJsonUOBuffer& Json, int32 Idx)
 {
-	FakeBackend[Idx] = JsonObj;
+	FIFInventoryBackend* Backend = FIFInventoryBackend::Get();
+	const FString& Id = GetCachedBackendId();
+	if (!Backend || Id.IsEmpty())
+		return;
+	//only copied and queued here, written on backend thread.
+	Backend->Save(Id, (uint8)Idx, Json);
 }
-
-FIFItemData UIFInventoryComponent::JsonToItem(const FString& JsonString)
+void UIFInventoryComponent::RemoveFromBackend(int32 Idx)
 {
-	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(JsonString);
+	FIFInventoryBackend* Backend = FIFInventoryBackend::Get();
+	const FString& Id = GetCachedBackendId();
+	if (!Backend || Id.IsEmpty())
+		return;
+	Backend->Remove(Id, (uint8)Idx);
+}
+void UIFInventoryComponent::LoadFromBackend()
+{
+	FIFInventoryBackend* Backend = FIFInventoryBackend::Get();
+	const FString& Id = GetCachedBackendId();
+	if (!Backend || Id.IsEmpty())
+		return;
+	Backend->Load(Id, FIFOnBackendLoaded::CreateUObject(this, &UIFInventoryComponent::OnBackendLoaded));
+}
+void UIFInventoryComponent::OnBackendLoaded(const TArray<FIFBackendRecord>& Records)
+{
+	for (const FIFBackendRecord& Record : Records)
+	{
+		//slot might have been filled while load was in flight, which is newer than stored one.
+		if (!Inventory.Items.IsValidIndex(Record.Slot) || Inventory.Items[Record.Slot].Item)
+			continue;
 
-	TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject());
+		FIFItemData Loaded = JsonToItem(Record.Json);
+		if (!Loaded.Item)
+		{
+			UE_LOG(IFLog, Warning, TEXT("Stored item in slot %d of %s can't be read."), Record.Slot, *BackendId);
+			continue;
+		}
 
-	bool bSuccessful = FJsonSerializer::Deserialize(Reader, Object);
+		FIFItemData& Item = Inventory.Items[Record.Slot];
+		Item.Item = Loaded.Item;
+		Item.Item->OnServerItemLoaded();
+		MarkSlotDirty(Item.Index);
 
-	TSharedPtr<FJsonObject> itemField = Object->GetObjectField("item");
-	FString objClassStr = itemField->GetStringField("objectClass");
-	int32 idx = Object->GetIntegerField("index");
+		Item.Item->OnServerItemAdded(Item.Index);
+		OnServerItemAdded(Item.Item, Item.Index);
+		if (IsLocalOwner())
+		{
+			NotifyItemAdded(Item.Index);
+		}
+	}
+}
+FString UIFInventoryComponent::GetBackendId() const
+{
+	APlayerState* PlayerState = nullptr;
+	if (APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		PlayerState = Pawn->PlayerState;
+	}
+	else if (AController* Controller = Cast<AController>(GetOwner()))
+	{
+		PlayerState = Controller->PlayerState;
+	}
+	if (!PlayerState || !PlayerState->UniqueId.IsValid())
+		return FString();
 
-	FSoftClassPath path(objClassStr);
+	return PlayerState->UniqueId->ToString() + TEXT("_") + GetName();
+}
+const FString& UIFInventoryComponent::GetCachedBackendId()
+{
+	if (BackendId.IsEmpty())
+	{
+		BackendId = GetBackendId();
+	}
+	return BackendId;
+}
 
-	UClass* itemCls = Cast<UClass>(path.TryLoad());
-	UObject* OutObj = nullptr;
-	FIFJsonSerializer::JsonObjectToUObject(itemField, OutObj, this);
+FIFItemData UIFInventoryComponent::JsonToItem(const FString& JsonString)
+{
 	FIFItemData Item;
-	Item.Index = idx;
-	Item.Item = Cast<UIFItemBase>(OutObj);
+
+	//pull parsed in place, item properties are written directly, without FJsonObject in between.
+	FBufferReader Archive((void*)*JsonString, JsonString.Len() * sizeof(TCHAR), false);
+	TSharedRef<FJsonUOReader> Reader = FJsonUOReader::Create(&Archive);
+	EJsonNotation Notation;
+	if (!Reader->ReadNext(Notation) || Notation != EJsonNotation::ObjectStart)
+	{
+		return Item;
+	}
+	while (Reader->ReadNext(Notation) && Notation != EJsonNotation::ObjectEnd && Notation != EJsonNotation::Error)
+	{
+		const FString& Field = Reader->GetIdentifier();
+		if (Notation == EJsonNotation::Number && Field == TEXT("index"))
+		{
+			Item.Index = (uint8)Reader->GetValueAsNumber();
+		}
+		else if (Notation == EJsonNotation::ObjectStart && Field == TEXT("item"))
+		{
+			Item.Item = Cast<UIFItemBase>(FJsonUODeserialize::ReadUObject(*Reader, this));
+		}
+		else
+		{
+			FJsonUODeserialize::SkipValue(*Reader, Notation);
+		}
+	}
 	
 	return Item;
-}
\ No newline at end of file
+}
+
+void UIFInventoryComponent::GetLifetimeReplicatedProps(TArray< class FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(UIFInventoryComponent, Inventory, COND_OwnerOnly);
+}
@@ -11,14 +11,19 @@ bool UIFItemBase::CallRemoteFunction(UFunction* Function, void* Parameters, FOut
 	check(!HasAnyFlags(RF_ClassDefaultObject));
 	check(GetOuter() != NULL);
 
-	UIFInventoryComponent* Owner = CastChecked<UIFInventoryComponent>(GetOuter());
-	UNetDriver* NetDriver = Owner->GetOwner()->GetNetDriver();
+	AActor* Owner = GetOwningActor();
+	UNetDriver* NetDriver = Owner ? Owner->GetNetDriver() : nullptr;
 	if (NetDriver)
 	{
-		NetDriver->ProcessRemoteFunction(Owner->GetOwner(), Function, Parameters, OutParms, Stack, this);
+		NetDriver->ProcessRemoteFunction(Owner, Function, Parameters, OutParms, Stack, this);
 		return true;
 	}
 
 	return false;
 }
 
+AActor* UIFItemBase::GetOwningActor() const
+{
+	return GetTypedOuter<AActor>();
+}
+
@@ -0,0 +1,337 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "IFRecordLog.h"
+#include "IFInventoryBackend.h"
+
+#include "HAL/PlatformFilemanager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+
+namespace IFRecordLog
+{
+	const uint32 FileMagic = 0x474C4649; //IFLG
+	const uint32 FileVersion = 1;
+	const int64 FileHeaderSize = 8;
+
+	const uint32 RecordMagic = 0x43524649; //IFRC
+	const int64 RecordHeaderSize = 16;
+	const uint8 FlagTombstone = 1;
+
+	/* Logs smaller than that are never compacted. */
+	const int64 MinCompactSize = 64 * 1024;
+
+	inline uint32 ReadUInt32(const uint8* Data)
+	{
+		uint32 Value;
+		FMemory::Memcpy(&Value, Data, sizeof(uint32));
+		return Value;
+	}
+	inline void WriteUInt32(uint8* Data, uint32 Value)
+	{
+		FMemory::Memcpy(Data, &Value, sizeof(uint32));
+	}
+}
+
+FIFRecordLog::FIFRecordLog(const FString& InFilename)
+	: Filename(InFilename)
+	, FileSize(0)
+	, LiveBytes(0)
+	, bNeedsFlush(false)
+	, bLastReadMapped(false)
+{
+	Index.SetNum(256);
+}
+
+FIFRecordLog::~FIFRecordLog()
+{
+	Flush();
+}
+
+bool FIFRecordLog::Open()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	int64 ValidEnd = 0;
+	const FString TempFilename = Filename + TEXT(".tmp");
+	if (!PlatformFile.FileExists(*Filename) && PlatformFile.FileExists(*TempFilename))
+	{
+		//crashed after compacted log has been written, but before it replaced old one.
+		PlatformFile.MoveFile(*Filename, *TempFilename);
+	}
+	if (PlatformFile.FileExists(*Filename))
+	{
+		int64 ReadSize = 0;
+		const bool bRead = ReadFile([this, &ValidEnd, &ReadSize](const uint8* Data, int64 Size)
+		{
+			ReadSize = Size;
+			ValidEnd = Scan(Data, Size);
+		});
+		if (!bRead)
+		{
+			//don't truncate log we just failed to read.
+			UE_LOG(LogIFBackend, Error, TEXT("%s: can't read."), *Filename);
+			return false;
+		}
+		FileSize = ReadSize;
+
+		if (ValidEnd == INDEX_NONE)
+		{
+			//might be written by newer version, leave it alone.
+			UE_LOG(LogIFBackend, Error, TEXT("%s: unknown log format, not opened."), *Filename);
+			FileSize = 0;
+			return false;
+		}
+		if (ValidEnd < FileSize)
+		{
+			UE_LOG(LogIFBackend, Warning, TEXT("%s: dropping %lld bytes of damaged tail."), *Filename, FileSize - ValidEnd);
+			FileSize = ValidEnd;
+			//rewrite, so new records are not appended after garbage.
+			return Compact();
+		}
+	}
+	else
+	{
+		PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+	}
+	return OpenWriter();
+}
+
+void FIFRecordLog::Append(uint8 Slot, const TArray<uint8>& Payload, bool bTombstone)
+{
+	if (!Writer)
+		return;
+
+	RecordBuffer.Reset();
+	WriteRecord(Slot, Payload.GetData(), (uint32)Payload.Num(), bTombstone, RecordBuffer);
+	if (!Writer->Write(RecordBuffer.GetData(), RecordBuffer.Num()))
+	{
+		UE_LOG(LogIFBackend, Error, TEXT("%s: failed to append record for slot %d."), *Filename, Slot);
+		return;
+	}
+
+	FIFRecordLocation& Location = Index[Slot];
+	if (Location.Offset != INDEX_NONE)
+	{
+		LiveBytes -= IFRecordLog::RecordHeaderSize + Location.Size;
+	}
+	Location.Offset = FileSize;
+	Location.Size = (uint32)Payload.Num();
+	Location.bTombstone = bTombstone;
+	LiveBytes += RecordBuffer.Num();
+	FileSize += RecordBuffer.Num();
+	bNeedsFlush = true;
+}
+
+void FIFRecordLog::Flush()
+{
+	if (!bNeedsFlush || !Writer)
+		return;
+
+	Writer->Flush();
+	bNeedsFlush = false;
+}
+
+bool FIFRecordLog::ReadLive(TArray<FIFBackendRecord>& OutRecords)
+{
+	if (LiveBytes == 0)
+		return true;
+
+	//writer shares file for reading only, some platforms refuse to open it again while it is open.
+	Flush();
+	Writer.Reset();
+
+	const bool bRead = ReadFile([this, &OutRecords](const uint8* Data, int64 Size)
+	{
+		for (int32 Slot = 0; Slot < Index.Num(); Slot++)
+		{
+			const FIFRecordLocation& Location = Index[Slot];
+			if (!Location.IsLive())
+				continue;
+
+			const int64 PayloadOffset = Location.Offset + IFRecordLog::RecordHeaderSize;
+			if (PayloadOffset + Location.Size > Size)
+				continue;
+
+			FUTF8ToTCHAR Converted((const ANSICHAR*)(Data + PayloadOffset), Location.Size);
+			FIFBackendRecord& Record = OutRecords[OutRecords.AddDefaulted()];
+			Record.Slot = (uint8)Slot;
+			Record.Json = FString(Converted.Length(), Converted.Get());
+		}
+	});
+	return OpenWriter() && bRead;
+}
+
+bool FIFRecordLog::ShouldCompact() const
+{
+	return FileSize > IFRecordLog::MinCompactSize && FileSize - LiveBytes > LiveBytes;
+}
+
+bool FIFRecordLog::Compact()
+{
+	Flush();
+	Writer.Reset();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	//tombstones are not needed anymore, slot without record is empty.
+	TArray<uint8> Compacted;
+	Compacted.Reserve(IFRecordLog::FileHeaderSize + LiveBytes);
+	Compacted.AddUninitialized(IFRecordLog::FileHeaderSize);
+	IFRecordLog::WriteUInt32(Compacted.GetData(), IFRecordLog::FileMagic);
+	IFRecordLog::WriteUInt32(Compacted.GetData() + 4, IFRecordLog::FileVersion);
+
+	TArray<FIFRecordLocation> NewIndex;
+	NewIndex.SetNum(Index.Num());
+
+	const bool bRead = FileSize == 0 || ReadFile([this, &Compacted, &NewIndex](const uint8* Data, int64 Size)
+	{
+		for (int32 Slot = 0; Slot < Index.Num(); Slot++)
+		{
+			const FIFRecordLocation& Location = Index[Slot];
+			if (!Location.IsLive() || Location.Offset + IFRecordLog::RecordHeaderSize + Location.Size > Size)
+				continue;
+
+			NewIndex[Slot].Offset = Compacted.Num();
+			NewIndex[Slot].Size = Location.Size;
+			WriteRecord((uint8)Slot, Data + Location.Offset + IFRecordLog::RecordHeaderSize, Location.Size, false, Compacted);
+		}
+	});
+
+	if (!bRead || !FFileHelper::SaveArrayToFile(Compacted, *TempFilename))
+	{
+		UE_LOG(LogIFBackend, Error, TEXT("%s: compaction failed, keeping old log."), *Filename);
+		return OpenWriter();
+	}
+	//replaced only after new file is complete, so crash in between keeps old log.
+	PlatformFile.DeleteFile(*Filename);
+	if (!PlatformFile.MoveFile(*Filename, *TempFilename))
+	{
+		UE_LOG(LogIFBackend, Error, TEXT("%s: failed to replace log with compacted one."), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogIFBackend, Verbose, TEXT("%s: compacted %lld -> %d bytes."), *Filename, FileSize, Compacted.Num());
+	Index = MoveTemp(NewIndex);
+	FileSize = Compacted.Num();
+	LiveBytes = FileSize - IFRecordLog::FileHeaderSize;
+	return OpenWriter();
+}
+
+bool FIFRecordLog::OpenWriter()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const bool bNewFile = FileSize == 0;
+	Writer.Reset(PlatformFile.OpenWrite(*Filename, !bNewFile, true));
+	if (!Writer)
+	{
+		UE_LOG(LogIFBackend, Error, TEXT("%s: can't open for writing."), *Filename);
+		return false;
+	}
+	if (bNewFile)
+	{
+		uint8 Header[IFRecordLog::FileHeaderSize];
+		IFRecordLog::WriteUInt32(Header, IFRecordLog::FileMagic);
+		IFRecordLog::WriteUInt32(Header + 4, IFRecordLog::FileVersion);
+		Writer->Write(Header, IFRecordLog::FileHeaderSize);
+		FileSize = IFRecordLog::FileHeaderSize;
+		bNeedsFlush = true;
+	}
+	return true;
+}
+
+bool FIFRecordLog::ReadFile(TFunctionRef<void(const uint8* Data, int64 Size)> Visitor)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	bLastReadMapped = false;
+	{
+		//region must be released before handle.
+		TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Filename));
+		if (MappedFile && MappedFile->GetFileSize() > 0)
+		{
+			TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+			if (Region)
+			{
+				bLastReadMapped = true;
+				Visitor(Region->GetMappedPtr(), Region->GetMappedSize());
+				return true;
+			}
+		}
+	}
+
+	//platform without mapped files.
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename))
+		return false;
+
+	Visitor(Bytes.GetData(), Bytes.Num());
+	return true;
+}
+
+int64 FIFRecordLog::Scan(const uint8* Data, int64 Size)
+{
+	for (FIFRecordLocation& Location : Index)
+	{
+		Location = FIFRecordLocation();
+	}
+	LiveBytes = 0;
+
+	if (Size < IFRecordLog::FileHeaderSize)
+	{
+		//crashed before header has been written, nothing to lose.
+		return 0;
+	}
+	if (IFRecordLog::ReadUInt32(Data) != IFRecordLog::FileMagic
+		|| IFRecordLog::ReadUInt32(Data + 4) != IFRecordLog::FileVersion)
+	{
+		return INDEX_NONE;
+	}
+
+	int64 Offset = IFRecordLog::FileHeaderSize;
+	while (Offset + IFRecordLog::RecordHeaderSize <= Size)
+	{
+		const uint8* Header = Data + Offset;
+		const uint32 PayloadSize = IFRecordLog::ReadUInt32(Header + 4);
+		const uint32 Crc = IFRecordLog::ReadUInt32(Header + 8);
+		const uint8 Slot = Header[12];
+		const uint8 Flags = Header[13];
+
+		if (IFRecordLog::ReadUInt32(Header) != IFRecordLog::RecordMagic
+			|| Offset + IFRecordLog::RecordHeaderSize + PayloadSize > Size
+			|| FCrc::MemCrc32(Header + IFRecordLog::RecordHeaderSize, (int32)PayloadSize) != Crc)
+		{
+			break;
+		}
+
+		FIFRecordLocation& Location = Index[Slot];
+		if (Location.Offset != INDEX_NONE)
+		{
+			LiveBytes -= IFRecordLog::RecordHeaderSize + Location.Size;
+		}
+		Location.Offset = Offset;
+		Location.Size = PayloadSize;
+		Location.bTombstone = (Flags & IFRecordLog::FlagTombstone) != 0;
+		LiveBytes += IFRecordLog::RecordHeaderSize + PayloadSize;
+
+		Offset += IFRecordLog::RecordHeaderSize + PayloadSize;
+	}
+	return Offset;
+}
+
+void FIFRecordLog::WriteRecord(uint8 Slot, const uint8* Payload, uint32 Size, bool bTombstone, TArray<uint8>& Out)
+{
+	const int32 Start = Out.AddUninitialized(IFRecordLog::RecordHeaderSize + Size);
+	uint8* Header = Out.GetData() + Start;
+	IFRecordLog::WriteUInt32(Header, IFRecordLog::RecordMagic);
+	IFRecordLog::WriteUInt32(Header + 4, Size);
+	IFRecordLog::WriteUInt32(Header + 8, FCrc::MemCrc32(Payload, (int32)Size));
+	Header[12] = Slot;
+	Header[13] = bTombstone ? IFRecordLog::FlagTombstone : 0;
+	Header[14] = 0;
+	Header[15] = 0;
+	if (Size > 0)
+	{
+		FMemory::Memcpy(Header + IFRecordLog::RecordHeaderSize, Payload, Size);
+	}
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+struct FIFBackendRecord;
+
+/* Where latest record of slot starts in file. */
+struct FIFRecordLocation
+{
+	int64 Offset;
+	uint32 Size;
+	bool bTombstone;
+
+	FIFRecordLocation()
+		: Offset(INDEX_NONE)
+		, Size(0)
+		, bTombstone(false)
+	{}
+
+	inline bool IsLive() const
+	{
+		return Offset != INDEX_NONE && !bTombstone;
+	}
+};
+
+/*
+	Append only log of inventory slot records of single player.
+
+	File is header followed by records: [Magic, PayloadSize, Crc, Slot, Flags, Padding][Payload].
+	Record appended later for the same slot replaces earlier one, record with Tombstone flag removes slot.
+	Index keeps only latest record per slot, log is rewritten with only those once dead records outweigh them.
+
+	Existing file is read through read only memory mapping, new records are appended through file handle.
+	Not thread safe, owned by backend worker thread.
+*/
+class FIFRecordLog
+{
+	FString Filename;
+	TUniquePtr<IFileHandle> Writer;
+	/* Latest record for each slot. */
+	TArray<FIFRecordLocation> Index;
+	/* Scratch, so appending does not allocate for every record. */
+	TArray<uint8> RecordBuffer;
+
+	int64 FileSize;
+	/* Bytes taken by records referenced from Index. */
+	int64 LiveBytes;
+	bool bNeedsFlush;
+	bool bLastReadMapped;
+
+public:
+	FIFRecordLog(const FString& InFilename);
+	~FIFRecordLog();
+
+	/*
+		Scans existing file and builds index. Torn tail left by crash is cut off by compaction.
+		Returns false if file can't be opened for writing or has unknown header, such file is never modified.
+	*/
+	bool Open();
+
+	void Append(uint8 Slot, const TArray<uint8>& Payload, bool bTombstone);
+	/* Pushes appended records to disk. */
+	void Flush();
+
+	/* Latest payload of every live slot. */
+	bool ReadLive(TArray<FIFBackendRecord>& OutRecords);
+
+	/* Dead records take more space than live ones. */
+	bool ShouldCompact() const;
+	/* Rewrites file with only records referenced from index. */
+	bool Compact();
+
+	inline const FString& GetFilename() const { return Filename; }
+	inline int64 GetFileSize() const { return FileSize; }
+	/* False if last read had to fall back to loading whole file. */
+	inline bool WasLastReadMapped() const { return bLastReadMapped; }
+
+private:
+	bool OpenWriter();
+	/* Calls Visitor with whole file content, mapped if platform supports it. */
+	bool ReadFile(TFunctionRef<void(const uint8* Data, int64 Size)> Visitor);
+	/* Returns offset past last valid record, INDEX_NONE if header is not known. */
+	int64 Scan(const uint8* Data, int64 Size);
+	void WriteRecord(uint8 Slot, const uint8* Payload, uint32 Size, bool bTombstone, TArray<uint8>& Out);
+};
@@ -2,6 +2,11 @@
 
 #include "IFTypes.h"
 #include "JsonObjectConverter.h"
+#include "JsonUODeserialize.h"
+#include "IFItemBase.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetConnection.h"
 
 
 bool FIFJsonSerializer::ConvertScalarJsonValueToUProperty(TSharedPtr<FJsonValue> JsonValue, UProperty* Property, void* OutValue)
@@ -361,33 +366,25 @@ bool FIFJsonSerializer::JsonValueToUProperty(TSharedPtr<FJsonValue> JsonValue, U
 
 bool FIFJsonSerializer::JsonAttributesToUObject(const TMap< FString, TSharedPtr<FJsonValue> >& JsonAttributes, const UStruct* StructDefinition, void* OutStruct)
 {
-	// iterate over the struct properties
-	for (TFieldIterator<UProperty> PropIt(StructDefinition); PropIt; ++PropIt)
+	// iterate over json values, properties are found through cached, case insensitive name table
+	for (auto It = JsonAttributes.CreateConstIterator(); It; ++It)
 	{
-		UProperty* Property = *PropIt;
-		FString PropertyName = Property->GetName();
-
-		// find a json value matching this property name
-		TSharedPtr<FJsonValue> JsonValue;
-		for (auto It = JsonAttributes.CreateConstIterator(); It; ++It)
-		{
-			// use case insensitive search sincd FName may change caseing strangely on us
-			if (PropertyName.Equals(It.Key(), ESearchCase::IgnoreCase))
-			{
-				JsonValue = It.Value();
-				break;
-			}
-		}
+		const TSharedPtr<FJsonValue>& JsonValue = It.Value();
 		if (!JsonValue.IsValid() || JsonValue->IsNull())
 		{
 			// we allow values to not be found since this mirrors the typical UObject mantra that all the fields are optional when deserializing
 			continue;
 		}
+		UProperty* Property = FJsonUODeserialize::FindProperty(StructDefinition, It.Key());
+		if (!Property)
+		{
+			continue;
+		}
 
 		void* Value = Property->ContainerPtrToValuePtr<uint8>(OutStruct);
 		if (!JsonValueToUProperty(JsonValue, Property, Value))
 		{
-			UE_LOG(LogJson, Error, TEXT("JsonObjectToUStruct - Unable to parse %s.%s from JSON"), *StructDefinition->GetName(), *PropertyName);
+			UE_LOG(LogJson, Error, TEXT("JsonObjectToUStruct - Unable to parse %s.%s from JSON"), *StructDefinition->GetName(), *Property->GetName());
 			return false;
 		}
 	}
@@ -410,23 +407,16 @@ void FIFJsonSerializer::JsonObjectToUObject(TSharedPtr<FJsonObject> Object, UObj
 	if (itemCls)
 	{
 		OutObject = NewObject<UObject>(Outer, itemCls);
-		for (TFieldIterator<UProperty> PropIt(itemCls); PropIt; ++PropIt)
+		for (auto It = Object->Values.CreateConstIterator(); It; ++It)
 		{
-			UProperty* Property = *PropIt;
-			FString PropertyName = Property->GetName();
-			TSharedPtr<FJsonValue> JsonValue;
-			for (auto It = Object->Values.CreateConstIterator(); It; ++It)
-			{
-				// use case insensitive search sincd FName may change caseing strangely on us
-				if (PropertyName.Equals(It.Key(), ESearchCase::IgnoreCase))
-				{
-					JsonValue = It.Value();
-					break;
-				}
-			}
+			const TSharedPtr<FJsonValue>& JsonValue = It.Value();
 			if (!JsonValue.IsValid())
 				continue;
 
+			UProperty* Property = FJsonUODeserialize::FindProperty(itemCls, It.Key());
+			if (!Property)
+				continue;
+
 			if(UObjectProperty* ObjectProp = Cast<UObjectProperty>(Property))
 			{
 				const TSharedPtr<FJsonObject>* Obj;
@@ -464,6 +454,141 @@ void FIFJsonSerializer::JsonObjectToUObject(TSharedPtr<FJsonObject> Object, UObj
 		}
 	}
 }
+UObject* FIFJsonSerializer::JsonStringToUObject(const FString& Json, UObject* Outer)
+{
+	return FJsonUODeserialize::JsonStringToUObject(Json, Outer);
+}
+
+void FIFItemIndex::Set(uint8 Slot, const UIFItemBase* Item)
+{
+	if (Slots.Num() <= Slot)
+	{
+		Slots.SetNum(Slot + 1);
+	}
+
+	FIndexedSlot& Indexed = Slots[Slot];
+	for (const FObjectKey& Class : Indexed.Classes)
+	{
+		if (TArray<uint8>* Group = ByClass.Find(Class))
+		{
+			if (RemoveFromGroup(*Group, Slot))
+			{
+				ByClass.Remove(Class);
+			}
+		}
+	}
+	for (const FGameplayTag& Tag : Indexed.Tags)
+	{
+		if (TArray<uint8>* Group = ByTag.Find(Tag))
+		{
+			if (RemoveFromGroup(*Group, Slot))
+			{
+				ByTag.Remove(Tag);
+			}
+		}
+	}
+	Indexed.Classes.Reset();
+	Indexed.Tags.Reset();
+
+	if (!Item)
+		return;
+
+	//class hierarchy of items is shallow, so query for any super class is single lookup.
+	for (const UClass* Class = Item->GetClass(); Class; Class = Class->GetSuperClass())
+	{
+		Indexed.Classes.Add(FObjectKey(Class));
+		AddToGroup(ByClass.FindOrAdd(FObjectKey(Class)), Slot);
+		if (Class == UIFItemBase::StaticClass())
+			break;
+	}
+	for (const FGameplayTag& ItemTag : Item->ItemTags)
+	{
+		const FGameplayTagContainer WithParents = ItemTag.GetGameplayTagParents();
+		for (const FGameplayTag& Tag : WithParents)
+		{
+			if (Indexed.Tags.Contains(Tag))
+				continue;
+			Indexed.Tags.Add(Tag);
+			AddToGroup(ByTag.FindOrAdd(Tag), Slot);
+		}
+	}
+}
+void FIFItemIndex::Reset()
+{
+	ByClass.Reset();
+	ByTag.Reset();
+	Slots.Reset();
+}
+const TArray<uint8>& FIFItemIndex::FindByClass(const UClass* ItemClass) const
+{
+	static const TArray<uint8> Empty;
+	const TArray<uint8>* Group = ByClass.Find(FObjectKey(ItemClass));
+	return Group ? *Group : Empty;
+}
+const TArray<uint8>& FIFItemIndex::FindByTag(const FGameplayTag& Tag) const
+{
+	static const TArray<uint8> Empty;
+	const TArray<uint8>* Group = ByTag.Find(Tag);
+	return Group ? *Group : Empty;
+}
+int32 FIFItemIndex::LowerBound(const TArray<uint8>& Group, uint8 Slot)
+{
+	int32 Low = 0;
+	int32 High = Group.Num();
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Group[Mid] < Slot)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+	return Low;
+}
+void FIFItemIndex::AddToGroup(TArray<uint8>& Group, uint8 Slot)
+{
+	const int32 Position = LowerBound(Group, Slot);
+	if (Position < Group.Num() && Group[Position] == Slot)
+		return;
+	Group.Insert(Slot, Position);
+}
+bool FIFItemIndex::RemoveFromGroup(TArray<uint8>& Group, uint8 Slot)
+{
+	const int32 Position = LowerBound(Group, Slot);
+	if (Position < Group.Num() && Group[Position] == Slot)
+	{
+		Group.RemoveAt(Position, 1, false);
+	}
+	return Group.Num() == 0;
+}
+
+uint16 FIFPrediction::NewKey()
+{
+	static uint16 LastKey = 0;
+	LastKey++;
+	if (LastKey == 0)
+	{
+		LastKey++;
+	}
+	return LastKey;
+}
+bool FIFPrediction::HaveSameOwner(const UActorComponent* A, const UActorComponent* B)
+{
+	const AActor* OwnerA = A ? A->GetOwner() : nullptr;
+	const AActor* OwnerB = B ? B->GetOwner() : nullptr;
+	if (!OwnerA || !OwnerB)
+		return false;
+	if (OwnerA == OwnerB)
+		return true;
+	//components can live on different actors of the same player (pawn, player state).
+	const UNetConnection* Connection = OwnerA->GetNetConnection();
+	return Connection && Connection == OwnerB->GetNetConnection();
+}
+
 IFTypes::IFTypes()
 {
 }
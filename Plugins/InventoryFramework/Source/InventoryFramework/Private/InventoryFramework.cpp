@@ -1,6 +1,7 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "InventoryFramework.h"
+#include "IFInventoryBackend.h"
 
 
 
@@ -9,12 +10,15 @@
 void FInventoryFrameworkModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FIFInventoryBackend::Startup();
 }
 
 void FInventoryFrameworkModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	//writes saves which are still queued.
+	FIFInventoryBackend::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
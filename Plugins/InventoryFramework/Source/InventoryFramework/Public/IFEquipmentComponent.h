@@ -31,6 +31,10 @@ protected:
 	FIFItemEvent OnItemUpdatedEvent;
 	FIFItemEvent OnItemRemovedEvent;
 
+	/* Slots changed on client which server has not confirmed yet. */
+	UPROPERTY()
+		TArray<FIFPredictedSlot> PredictedSlots;
+
 public:	
 	// Sets default values for this component's properties
 	UIFEquipmentComponent();
@@ -45,6 +49,8 @@ public:
 
 	inline UIFItemBase* GetItem(uint8 InLocalIndex)
 	{
+		if (!EquipmentItems.IsValidIndex(InLocalIndex))
+			return nullptr;
 		return EquipmentItems[InLocalIndex].Item;
 		//return Inventory.Items[InLocalIndex].Item;
 	}
@@ -62,27 +68,36 @@ public:
 		//return Cast<T>(Inventory.Items[InLocalIndex].Item);
 	}
 		
+	/* Predicted on owning client, both in this equipment and in Source. */
 	void AddItemFromInventory(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
 	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerAddItemFromInventory(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
-	void ServerAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
-	bool ServerAddItemFromInventory_Validate(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
-	/*
-	Confirm that change can be made and do the same change on client.
-	We do not predict inventory modifications. Clients MUST wait for server to make changes and send confirmation back.
-	*/
-	UFUNCTION(Client, Reliable)
-		void ClientAddItemFromInventory(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
-	void ClientAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex);
+		void ServerAddItemFromInventory(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex, uint16 PredictionKey);
+	void ServerAddItemFromInventory_Implementation(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex, uint16 PredictionKey);
+	bool ServerAddItemFromInventory_Validate(class UIFInventoryComponent* Source, uint8 SourceIndex, uint8 EquipmentIndex, uint16 PredictionKey);
 
+	/* Predicted on owning client. */
 	void RemoveFromEquipment(uint8 EquipmentIndex);
 	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRemoveFromEquipment(uint8 EquipmentIndex);
-	void ServerRemoveFromEquipment_Implementation(uint8 EquipmentIndex);
-	bool ServerRemoveFromEquipment_Validate(uint8 EquipmentIndex);
+		void ServerRemoveFromEquipment(uint8 EquipmentIndex, uint16 PredictionKey);
+	void ServerRemoveFromEquipment_Implementation(uint8 EquipmentIndex, uint16 PredictionKey);
+	bool ServerRemoveFromEquipment_Validate(uint8 EquipmentIndex, uint16 PredictionKey);
+	/* Removes item with server notifications. Returns false if slot was empty. Never call on clients. */
+	bool RemoveFromEquipmentOnServer(uint8 EquipmentIndex);
+
+	/*
+		Server response to every predicted operation started by this equipment. Rejected predictions are rolled back,
+		Inventory is the other side of operation if it had one.
+	*/
 	UFUNCTION(Client, Reliable)
-		void ClientRemoveFromEquipment(uint8 EquipmentIndex);
-	void ClientRemoveFromEquipment_Implementation(uint8 EquipmentIndex);
+		void ClientPredictionAck(uint16 PredictionKey, bool bAccepted, class UIFInventoryComponent* Inventory);
+	void ClientPredictionAck_Implementation(uint16 PredictionKey, bool bAccepted, class UIFInventoryComponent* Inventory);
+
+	/* Sets slot locally and remembers previous item, until prediction is resolved. */
+	void PredictSlot(uint8 InIndex, UIFItemBase* InItem, uint16 PredictionKey);
+	/* Slot waits for server response. New predictions on it are refused, so each one can be rolled back on its own. */
+	bool IsSlotPredicted(uint8 InIndex) const;
+	/* Confirms or rolls back slots predicted with key. */
+	void ResolvePrediction(uint16 PredictionKey, bool bAccepted);
 
 	/*
 		Called on client, before request to server is send to add item to Equipment component.
@@ -101,4 +116,8 @@ public:
 	inline FIFItemEvent& GetOnItemAdded() { return OnItemAddedEvent; }
 	inline FIFItemEvent& GetOnItemUpdated() { return OnItemUpdatedEvent; }
 	inline FIFItemEvent& GetOnItemRemoved() { return OnItemRemovedEvent; }
+
+protected:
+	/* Changes slot on client only, with client notifications. */
+	void SetSlotLocal(uint8 InIndex, UIFItemBase* InItem);
 };
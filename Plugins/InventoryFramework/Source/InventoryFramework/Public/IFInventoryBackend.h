@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+
+class FJsonUOBuffer;
+class FIFRecordLog;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogIFBackend, Log, All);
+
+struct FIFBackendRecord
+{
+	uint8 Slot;
+	/* Item json, as written by UIFInventoryComponent::ItemToJson */
+	FString Json;
+
+	FIFBackendRecord()
+		: Slot(0)
+	{}
+};
+
+/* Called on game thread with every stored slot of player. */
+DECLARE_DELEGATE_OneParam(FIFOnBackendLoaded, const TArray<FIFBackendRecord>&);
+
+enum class EIFBackendCommand : uint8
+{
+	Save,
+	Remove,
+	Load,
+	Close
+};
+
+struct FIFBackendCommand
+{
+	EIFBackendCommand Type;
+	FString PlayerId;
+	uint8 Slot;
+	/* Utf8 json. */
+	TArray<uint8> Payload;
+	FIFOnBackendLoaded OnLoaded;
+
+	FIFBackendCommand()
+		: Type(EIFBackendCommand::Save)
+		, Slot(0)
+	{}
+	FIFBackendCommand(EIFBackendCommand InType, const FString& InPlayerId, uint8 InSlot)
+		: Type(InType)
+		, PlayerId(InPlayerId)
+		, Slot(InSlot)
+	{}
+};
+
+/*
+	Local inventory storage. Every player has own append only record log in Saved/Inventory
+	(or in directory passed as -IFBackendDir=).
+
+	Game thread only converts json to utf8 and queues it, files are written, flushed and compacted
+	on worker thread. Commands are executed in order they were queued, so load queued after save sees it.
+	Commands queued before shutdown are still written.
+
+	Owned by InventoryFramework module.
+*/
+class INVENTORYFRAMEWORK_API FIFInventoryBackend : public FRunnable
+{
+	static TUniquePtr<FIFInventoryBackend> Instance;
+
+	FString Directory;
+
+	TQueue<FIFBackendCommand, EQueueMode::Mpsc> Commands;
+	FEvent* WorkEvent;
+	FRunnableThread* Thread;
+	FThreadSafeBool bStopping;
+	FThreadSafeCounter PendingCommands;
+
+	/* Worker thread only. */
+	TMap<FString, TUniquePtr<FIFRecordLog>> Logs;
+
+public:
+	FIFInventoryBackend(const FString& InDirectory);
+	virtual ~FIFInventoryBackend();
+
+	static void Startup();
+	static void Shutdown();
+	/* nullptr before module startup and after shutdown. */
+	static FIFInventoryBackend* Get();
+
+	void Save(const FString& PlayerId, uint8 Slot, const FJsonUOBuffer& Json);
+	void Remove(const FString& PlayerId, uint8 Slot);
+	void Load(const FString& PlayerId, const FIFOnBackendLoaded& OnLoaded);
+	/* Flushes and closes player log, it will be opened again on next command. */
+	void Close(const FString& PlayerId);
+
+	/* Commands not yet written. */
+	inline int32 GetPendingCommands() const { return PendingCommands.GetValue(); }
+
+	/* FRunnable Begin */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	/* FRunnable End */
+
+private:
+	void Enqueue(FIFBackendCommand& Command);
+	void Execute(FIFBackendCommand& Command);
+	FIFRecordLog* FindOrOpenLog(const FString& PlayerId);
+	/* Flushes logs written since last call and compacts those which grew too much. */
+	void FlushLogs();
+	FString GetLogFilename(const FString& PlayerId) const;
+};
@@ -7,6 +7,7 @@
 #include "Components/ActorComponent.h"
 #include "IFTypes.h"
 #include "IFItemBase.h"
+#include "JsonUOSerialize.h"
 #include "IFInventoryComponent.generated.h"
 
 //NetIndex, LocalIndex
@@ -26,16 +27,33 @@ protected:
 	FIFItemEvent OnItemRemovedEvent;
 	FIFOnInventoryChanged OnInventoryChanged;
 
-	/* Array faking an database backend (where data is stored as json like DynamoDB, GameSparks, CosmosDB, MongoDB */
-	TArray<TSharedPtr<FJsonObject>> FakeBackend;
+	/* Slots by item class and tag. Updated on every slot change, on server and client alike. */
+	FIFItemIndex ItemSlotIndex;
+
+	/*
+		For every item class seen, which slots accept it (AcceptedClasses and AcceptedSlotClasses combined).
+		Built on first use of class, accepted classes are not expected to change after BeginPlay.
+	*/
+	TMap<FObjectKey, TBitArray<>> AcceptedSlots;
+
+	/* Slots changed on client which server has not confirmed yet. */
+	UPROPERTY()
+		TArray<FIFPredictedSlot> PredictedSlots;
+
+	/* Key of this inventory in FIFInventoryBackend, resolved on first use. Empty if inventory is not persisted. */
+	FString BackendId;
+
+	/* Items are serialized into it, reused so it doesn't allocate for every item. */
+	FJsonUOBuffer JsonBuffer;
 
 	/* Key is deserialized from Json and it stored in backend. */
 	//UPROPERTY()
 	//	TMap<uint8, FIFItem> InventoryItems;
 
 
-	UPROPERTY()
-		TArray<FIFItemData> InventoryItems;
+	/* Replicated only to owner. */
+	UPROPERTY(Replicated)
+		FIFItemContainer Inventory;
 	/*
 		Which items this inventory accept.
 	*/
@@ -70,6 +88,7 @@ protected:
 	virtual void InitializeComponent() override;;
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	// Called every frame
@@ -88,38 +107,63 @@ public:
 
 	inline const FIFItemData& GetSlot(uint8 Idx)
 	{
-		return InventoryItems[Idx];;
+		return Inventory.Items[Idx];
 	}
 
+	/* Slots are replicated, so on client they might not exist yet. */
 	inline UIFItemBase* GetItem(uint8 InLocalIndex)
 	{
-		return InventoryItems[InLocalIndex].Item;
-		//return Inventory.Items[InLocalIndex].Item;
+		if (!Inventory.Items.IsValidIndex(InLocalIndex))
+			return nullptr;
+		return Inventory.Items[InLocalIndex].Item;
 	}
 	template<typename T>
 	T* GetItem(uint8 InLocalIndex)
 	{
-		return Cast<T>(InventoryItems[InLocalIndex].Item);
-		//return Cast<T>(Inventory.Items[InLocalIndex].Item);
+		return Cast<T>(GetItem(InLocalIndex));
 	}
 
 	TArray<uint8> GetLocalItemIdxs(TSubclassOf<UIFItemBase> ItemClass);
 
+	/* Sorted slots which items are ItemClass or its subclass. Doesn't walk slots. */
+	inline const TArray<uint8>& GetSlotsByClass(TSubclassOf<UIFItemBase> ItemClass) const
+	{
+		return ItemSlotIndex.FindByClass(ItemClass);
+	}
+	/* Sorted slots which items have Tag, or tag which is child of Tag. Doesn't walk slots. */
+	inline const TArray<uint8>& GetSlotsByTag(const FGameplayTag& Tag) const
+	{
+		return ItemSlotIndex.FindByTag(Tag);
+	}
+
 	template<typename T>
 	TArray<T*> GetItems(TSubclassOf<T> ItemClass)
 	{
+		const TArray<uint8>& Slots = GetSlotsByClass(ItemClass);
+		TArray<T*> Items;
+		Items.Reserve(Slots.Num());
+		for (uint8 Idx : Slots)
+		{
+			Items.Add(Cast<T>(Inventory.Items[Idx].Item));
+		}
+
+		return Items;
+	}
+	template<typename T>
+	TArray<T*> GetItemsByTag(const FGameplayTag& Tag)
+	{
+		const TArray<uint8>& Slots = GetSlotsByTag(Tag);
 		TArray<T*> Items;
-		TArray<uint8> Idxs;
-		for (uint8 Idx = 0; Idx < InventoryItems.Num(); Idx++)
+		Items.Reserve(Slots.Num());
+		for (uint8 Idx : Slots)
 		{
-			if (InventoryItems[Idx].Item && InventoryItems[Idx].Item->IsA(ItemClass))
+			if (T* Item = Cast<T>(Inventory.Items[Idx].Item))
 			{
-				Items.Add(Cast<T>(InventoryItems[Idx].Item));
+				Items.Add(Item);
 			}
 		}
 
 		return Items;
-		//return Inventory.GetItems<T>(ItemClass);
 	}
 
 	/* 
@@ -127,16 +171,21 @@ public:
 		First check if inventory accepts, If it passes it will check slot.
 	*/
 	bool AcceptItem(UIFItemBase* Item, uint8 InLocaLIndex);
+	/* Bit per slot, set if slot accepts ItemClass. */
+	const TBitArray<>& GetAcceptedSlots(UClass* ItemClass);
+	/* First empty slot which accepts item, INDEX_NONE if there is none. */
+	int32 FindFreeSlot(UIFItemBase* Item);
 	/*
 		Move item from old position to new position.
 		If there was already item in new position it will be swapped with the moved item;
+		Predicted on owning client.
 	*/
 	void MoveItemInInventory(uint8 NewLocalPostion, uint8 OldLocalPositin);
 	
 	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerMoveItemInInventory(uint8 NewNetPostion, uint8 OldNetPositin);
-	void ServerMoveItemInInventory_Implementation(uint8 NewNetPostion, uint8 OldNetPositin);
-	bool ServerMoveItemInInventory_Validate(uint8 NewNetPostion, uint8 OldNetPositin);
+		void ServerMoveItemInInventory(uint8 NewNetPostion, uint8 OldNetPositin, uint16 PredictionKey);
+	void ServerMoveItemInInventory_Implementation(uint8 NewNetPostion, uint8 OldNetPositin, uint16 PredictionKey);
+	bool ServerMoveItemInInventory_Validate(uint8 NewNetPostion, uint8 OldNetPositin, uint16 PredictionKey);
 	/* 
 		Adds new item at slot specified slot 
 		Source - Droped item from which we will transfer item
@@ -168,37 +217,21 @@ public:
 		void ServerAddItemFromEquipment(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
 	void ServerAddItemFromEquipment_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
 	bool ServerAddItemFromEquipment_Validate(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
-	/*
-		Confirm that change can be made and do the same change on client.
-		We do not predict inventory modifications. Clients MUST wait for server to make changes and send confirmation back.
-	*/
 	UFUNCTION(Client, Reliable)
 		void ClientAddItemFromEquipment(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
 	void ClientAddItemFromEquipment_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
 
+	/* Predicted on owning client, both in this inventory and in Source. */
 	void AddItemFromEquipmentAnySlot(class UIFEquipmentComponent* Source, uint8 SourceIndex);
+	/* InventoryIndex is free slot client has predicted, rejected if it's not free on server. */
 	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerAddItemFromEquipmentAnySlot(class UIFEquipmentComponent* Source, uint8 SourceIndex);
-	void ServerAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex);
-	bool ServerAddItemFromEquipmentAnySlot_Validate(class UIFEquipmentComponent* Source, uint8 SourceIndex);
-	/*
-	Confirm that change can be made and do the same change on client.
-	We do not predict inventory modifications. Clients MUST wait for server to make changes and send confirmation back.
-	*/
-	UFUNCTION(Client, Reliable)
-		void ClientAddItemFromEquipmentAnySlot(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
-	void ClientAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex);
+		void ServerAddItemFromEquipmentAnySlot(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex, uint16 PredictionKey);
+	void ServerAddItemFromEquipmentAnySlot_Implementation(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex, uint16 PredictionKey);
+	bool ServerAddItemFromEquipmentAnySlot_Validate(class UIFEquipmentComponent* Source, uint8 SourceIndex, uint8 InventoryIndex, uint16 PredictionKey);
 
 
 	//never call on clients.
 	void AddItemAnySlot(class UIFItemBase* Source);
-	/*
-	Confirm that change can be made and do the same change on client.
-	We do not predict inventory modifications. Clients MUST wait for server to make changes and send confirmation back.
-	*/
-	UFUNCTION(Client, Reliable)
-		void ClientAddAnySlot(const FString& JsonData, uint8 InventoryIndex);
-	void ClientAddAnySlot_Implementation(const FString& JsonData, uint8 InventoryIndex);
 
 
 	virtual void OnItemAdded(UIFItemBase* Item, uint8 LocalIndex) {};
@@ -210,14 +243,29 @@ public:
 	virtual void OnServerItemChanged(UIFItemBase* Item, uint8 LocalIndex) {};
 	virtual void OnServerItemRemoved(UIFItemBase* Item, uint8 LocalIndex) {};
 
+	/* Predicted on owning client. */
 	void RemoveItem(uint8 InIndex);
 	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRemoveItem(uint8 InIndex);
-	void ServerRemoveItem_Implementation(uint8 InIndex);
-	bool ServerRemoveItem_Validate(uint8 InIndex);
+		void ServerRemoveItem(uint8 InIndex, uint16 PredictionKey);
+	void ServerRemoveItem_Implementation(uint8 InIndex, uint16 PredictionKey);
+	bool ServerRemoveItem_Validate(uint8 InIndex, uint16 PredictionKey);
+	/* Removes item with server notifications. Returns false if slot was empty. Never call on clients. */
+	bool RemoveItemOnServer(uint8 InIndex);
+
+	/*
+		Server response to every predicted operation started by this inventory. Rejected predictions are rolled back,
+		Equipment is the other side of operation if it had one.
+	*/
 	UFUNCTION(Client, Reliable)
-		void ClientRemoveItem(uint8 Index);
-	void ClientRemoveItem_Implementation(uint8 InIndex);
+		void ClientPredictionAck(uint16 PredictionKey, bool bAccepted, class UIFEquipmentComponent* Equipment);
+	void ClientPredictionAck_Implementation(uint16 PredictionKey, bool bAccepted, class UIFEquipmentComponent* Equipment);
+
+	/* Sets slot locally and remembers previous item, until prediction is resolved. */
+	void PredictSlot(uint8 InIndex, UIFItemBase* InItem, uint16 PredictionKey);
+	/* Slot waits for server response. New predictions on it are refused, so each one can be rolled back on its own. */
+	bool IsSlotPredicted(uint8 InIndex) const;
+	/* Confirms or rolls back slots predicted with key. */
+	void ResolvePrediction(uint16 PredictionKey, bool bAccepted);
 
 
 	UFUNCTION()
@@ -227,17 +275,40 @@ public:
 		void OnItemLoaded(TSoftClassPtr<class UIFItemBase> InItem, uint8 InNetIndex);
 
 	FSimpleMulticastDelegate& GetOnInventoryRead();
-	
 
-	UFUNCTION(Client, Reliable)
-		void ClientSendJsonData(const FString& Data);
-	void ClientSendJsonData_Implementation(const FString& Data);
+	virtual bool ReplicateSubobjects(class UActorChannel *Channel, class FOutBunch *Bunch, FReplicationFlags *RepFlags) override;
 
 	protected:
+		/*
+			Client side notifications, called from replication.
+			On listen server/standalone they are called directly for local owner.
+		*/
+		void NotifyItemAdded(uint8 InIndex);
+		void NotifyItemRemoved(UIFItemBase* InItem, uint8 InIndex);
+		/* Changes slot on client only and sends notifications the same way replication would. */
+		void SetSlotLocal(uint8 InIndex, UIFItemBase* InItem);
+		/* Marks slot for replication and updates ItemSlotIndex. Server only. */
+		void MarkSlotDirty(uint8 InIndex);
+		/* Server state of slot arrived, predictions made on it are outdated. */
+		void OnSlotReplicated(uint8 InIndex);
+		/* True if owner of this inventory is controlled on this machine. */
+		bool IsLocalOwner() const;
+
 		void AddItem(TSoftClassPtr<class UIFItemBase> InItem, uint8 ItemIndex);
-		TSharedPtr<FJsonObject> ItemToJson(FIFItemData* Item);
+		/* Replaces content of OutBuffer with item. */
+		void ItemToJson(FIFItemData* Item, FJsonUOBuffer& OutBuffer);
 		FString JsonItemToString(TSharedPtr<FJsonObject> Object);
-		void SendToBackend(TSharedPtr<FJsonObject> JsonObj, int32 Idx);
+		void SendToBackend(const FJsonUOBuffer& Json, int32 Idx);
+		void RemoveFromBackend(int32 Idx);
+		/* Requests stored items, they are added to slots which are still empty. */
+		void LoadFromBackend();
+		void OnBackendLoaded(const TArray<struct FIFBackendRecord>& Records);
+		/*
+			Unique net id of owning player and component name, so player can have more than one persisted inventory.
+			Empty when owner has no player or id is not valid yet.
+		*/
+		virtual FString GetBackendId() const;
+		const FString& GetCachedBackendId();
 
 		FIFItemData JsonToItem(const FString& JsonString);
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
 #include "UObject/NoExportTypes.h"
+#include "GameplayTagContainer.h"
 #include "IFItemBase.generated.h"
 
 
@@ -24,6 +25,13 @@ public:
 	UPROPERTY()
 		uint8 NetIndex;
 
+	/*
+		Inventory indexes items by these tags (and their parents), see UIFInventoryComponent::GetSlotsByTag.
+		Read when item enters slot, not saved nor replicated, so set them in defaults.
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item")
+		FGameplayTagContainer ItemTags;
+
 	bool IsNameStableForNetworking() const override
 	{
 		return false;
@@ -36,6 +44,12 @@ public:
 	
 	bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
 
+	/*
+		Actor which owns component containing this item.
+		Replicated items are outered directly to actor on clients, so don't assume outer is component.
+	*/
+	class AActor* GetOwningActor() const;
+
 	/*
 		Called just fater NewObject<> On server or in standalone.
 	*/
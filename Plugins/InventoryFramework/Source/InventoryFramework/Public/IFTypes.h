@@ -9,13 +9,20 @@
 #include "Serialization/JsonReader.h"
 #include "Policies/PrettyJsonPrintPolicy.h"
 #include "Serialization/JsonSerializer.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/ObjectKey.h"
+#include "GameplayTagContainer.h"
 #include "IFTypes.generated.h"
 
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FIFItemEvent, uint8, uint8, class UIFItemBase*);
 DECLARE_MULTICAST_DELEGATE(FIFOnInventoryChanged);
 
+/*
+	Single inventory slot. Slots are created once on server and never removed, so
+	replication only sends slots which item changed.
+*/
 USTRUCT(BlueprintType)
-struct INVENTORYFRAMEWORK_API FIFItemData
+struct INVENTORYFRAMEWORK_API FIFItemData : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 public:
@@ -24,8 +31,116 @@ public:
 
 	UPROPERTY(BlueprintReadOnly)
 		uint8 Index;
+
+	/* Item client had in this slot before last update. Not replicated. */
+	TWeakObjectPtr<class UIFItemBase> LocalItem;
+
+	FIFItemData()
+		: Item(nullptr)
+		, Index(0)
+	{}
+
+	void PreReplicatedRemove(const struct FIFItemContainer& InArraySerializer);
+	void PostReplicatedAdd(const struct FIFItemContainer& InArraySerializer);
+	void PostReplicatedChange(const struct FIFItemContainer& InArraySerializer);
+};
+
+/*
+	Replicated inventory slots. Items are replicated as subobjects of owning actor,
+	so only changed item properties are send, and class is send as net guid instead of path.
+*/
+USTRUCT()
+struct INVENTORYFRAMEWORK_API FIFItemContainer : public FFastArraySerializer
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+		TArray<FIFItemData> Items;
+
+	TWeakObjectPtr<class UIFInventoryComponent> IC;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FIFItemData, FIFItemContainer>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits< FIFItemContainer > : public TStructOpsTypeTraitsBase2<FIFItemContainer>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+
+/*
+	Slot changed on owning client ahead of server. Kept until server acks prediction,
+	rejects it (slot is restored to OldItem), or replicates newer state of the slot.
+*/
+USTRUCT()
+struct INVENTORYFRAMEWORK_API FIFPredictedSlot
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY()
+		class UIFItemBase* OldItem;
+
+	UPROPERTY()
+		uint16 PredictionKey;
+
+	UPROPERTY()
+		uint8 Index;
+
+	FIFPredictedSlot()
+		: OldItem(nullptr)
+		, PredictionKey(0)
+		, Index(0)
+	{}
 };
 
+/*
+	Slots grouped by item class (and all its super classes) and by item tag (and all its parent tags).
+	Updated per slot change, so lookups don't walk every slot. Slots in every group are sorted.
+*/
+struct INVENTORYFRAMEWORK_API FIFItemIndex
+{
+	/* Replaces whatever was indexed in slot with Item, which can be null. */
+	void Set(uint8 Slot, const class UIFItemBase* Item);
+	void Reset();
+
+	const TArray<uint8>& FindByClass(const UClass* ItemClass) const;
+	const TArray<uint8>& FindByTag(const FGameplayTag& Tag) const;
+
+private:
+	/* Groups slot has been added to, so it can be removed after item is gone. */
+	struct FIndexedSlot
+	{
+		TArray<FObjectKey> Classes;
+		TArray<FGameplayTag> Tags;
+	};
+
+	TMap<FObjectKey, TArray<uint8>> ByClass;
+	TMap<FGameplayTag, TArray<uint8>> ByTag;
+	TArray<FIndexedSlot> Slots;
+
+	static int32 LowerBound(const TArray<uint8>& Group, uint8 Slot);
+	static void AddToGroup(TArray<uint8>& Group, uint8 Slot);
+	/* Returns true if group is empty afterwards. */
+	static bool RemoveFromGroup(TArray<uint8>& Group, uint8 Slot);
+};
+
+struct INVENTORYFRAMEWORK_API FIFPrediction
+{
+	/*
+		Unique on this client across all inventories and equipments, so single key can cover
+		operation which changes more than one of them. 0 is never returned, it means not predicted.
+	*/
+	static uint16 NewKey();
+	/* Both components belong to the same player, so one of them can move items out of other one. */
+	static bool HaveSameOwner(const class UActorComponent* A, const class UActorComponent* B);
+};
 
 USTRUCT(BlueprintType)
 struct INVENTORYFRAMEWORK_API FIFSlotAcceptedClasses
@@ -44,6 +159,11 @@ struct INVENTORYFRAMEWORK_API FIFJsonSerializer
 	static bool JsonValueToUProperty(TSharedPtr<FJsonValue> JsonValue, UProperty* Property, void* OutValue);
 	static void JsonObjectToUObject(TSharedPtr<FJsonObject> Object, UObject*& OutObject, UObject* Outer);
 	static bool JsonAttributesToUObject(const TMap< FString, TSharedPtr<FJsonValue> >& JsonAttributes, const UStruct* StructDefinition, void* OutStruct);
+	/*
+		Reads object straight from Json string, without building FJsonObject.
+		Field names are resolved once per class, values are written directly to properties.
+	*/
+	static UObject* JsonStringToUObject(const FString& Json, UObject* Outer);
 };
 
 
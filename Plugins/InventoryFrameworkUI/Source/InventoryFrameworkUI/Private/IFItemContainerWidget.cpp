@@ -6,7 +6,13 @@
 
 void UIFItemContainerWidget::SetInventory(UIFInventoryComponent* InInventory)
 {
+	UnbindInventory();
 	Inventory = InInventory;
+	if (!InInventory)
+		return;
+
+	InInventory->GetOnItemUpdated().AddUObject(this, &UIFItemContainerWidget::NativeOnItemUpdated);
+	InInventory->GetOnItemRemoved().AddUObject(this, &UIFItemContainerWidget::NativeOnItemRemoved);
 }
 
 void UIFItemContainerWidget::CreateInventory()
@@ -17,4 +23,42 @@ void UIFItemContainerWidget::CreateInventory()
 void UIFItemContainerWidget::NativeOnInventoryCreated()
 {
 	BP_OnInventoryCreated();
-}
\ No newline at end of file
+}
+
+void UIFItemContainerWidget::NativeDestruct()
+{
+	UnbindInventory();
+	Super::NativeDestruct();
+}
+
+void UIFItemContainerWidget::MoveItem(uint8 FromLocalIndex, uint8 ToLocalIndex)
+{
+	if (!Inventory.IsValid())
+		return;
+
+	Inventory->MoveItemInInventory(ToLocalIndex, FromLocalIndex);
+}
+
+void UIFItemContainerWidget::NativeOnItemUpdated(uint8 NetIndex, uint8 LocalIndex, class UIFItemBase* Item)
+{
+	if (InventoryWidgets.IsValidIndex(LocalIndex) && InventoryWidgets[LocalIndex])
+	{
+		InventoryWidgets[LocalIndex]->OnItemChanged(NetIndex, LocalIndex, Item);
+	}
+}
+void UIFItemContainerWidget::NativeOnItemRemoved(uint8 NetIndex, uint8 LocalIndex, class UIFItemBase* Item)
+{
+	if (InventoryWidgets.IsValidIndex(LocalIndex) && InventoryWidgets[LocalIndex])
+	{
+		InventoryWidgets[LocalIndex]->OnItemRemoved(NetIndex, LocalIndex, Item);
+	}
+}
+
+void UIFItemContainerWidget::UnbindInventory()
+{
+	if (!Inventory.IsValid())
+		return;
+
+	Inventory->GetOnItemUpdated().RemoveAll(this);
+	Inventory->GetOnItemRemoved().RemoveAll(this);
+}
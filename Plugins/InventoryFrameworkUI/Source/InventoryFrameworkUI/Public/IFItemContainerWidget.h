@@ -23,10 +23,20 @@ protected:
 		TSubclassOf<class UIFItemWidget> ItemClass;
 
 public:
+	/*
+		Item widgets follow inventory events, so predicted changes are shown without waiting for server.
+		Added items are broadcast as updated as well, so only updates and removals are followed.
+	*/
 	void SetInventory(UIFInventoryComponent* InInventory);
 
 	void CreateInventory();
 
+	virtual void NativeDestruct() override;
+
+	/* Drop of dragged item. Applied immediately on owning client, rolled back if server rejects it. */
+	UFUNCTION(BlueprintCallable, Category = "InventoryFramework")
+		void MoveItem(uint8 FromLocalIndex, uint8 ToLocalIndex);
+
 	/*
 		Called after all widgets in InvetoryWidgets array has been created.
 	*/
@@ -34,4 +44,9 @@ public:
 
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Inventory Created"))
 		void BP_OnInventoryCreated();
+
+protected:
+	void NativeOnItemUpdated(uint8 NetIndex, uint8 LocalIndex, class UIFItemBase* Item);
+	void NativeOnItemRemoved(uint8 NetIndex, uint8 LocalIndex, class UIFItemBase* Item);
+	void UnbindInventory();
 };
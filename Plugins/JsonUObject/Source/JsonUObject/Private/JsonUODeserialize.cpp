@@ -1,11 +1,668 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "JsonUODeserialize.h"
+#include "JsonGlobals.h"
+#include "JsonObjectConverter.h"
+#include "Serialization/BufferReader.h"
+#include "UObject/UnrealType.h"
 
-JsonUODeserialize::JsonUODeserialize()
+enum class EJsonUOReadKind : uint8
 {
+	Enum,
+	NumericEnum,
+	Float,
+	Integer,
+	/* Numeric property which is neither integer nor floating point. */
+	UnsupportedNumeric,
+	Bool,
+	String,
+	Text,
+	Array,
+	Set,
+	Map,
+	Object,
+	Struct,
+	/* Imported from string with ImportText. */
+	Other
+};
+
+struct FJsonUOReadProperty
+{
+	UProperty* Property;
+	EJsonUOReadKind Kind;
+	UEnum* Enum;
+	const FJsonUOReadPlan* StructPlan;
+	/* Element of array and set, key and value of map. */
+	TArray<FJsonUOReadProperty> Inner;
+
+	FJsonUOReadProperty()
+		: Property(nullptr)
+		, Kind(EJsonUOReadKind::Other)
+		, Enum(nullptr)
+		, StructPlan(nullptr)
+	{}
+};
+
+struct FJsonUOReadPlan
+{
+	/* Case insensitive, the same as FString keys are. */
+	TMap<FString, int32> FieldIndex;
+	TArray<FJsonUOReadProperty> Fields;
+};
+
+TMap<FObjectKey, TUniquePtr<FJsonUOReadPlan>> FJsonUODeserialize::ReadPlans;
+TMap<FString, TWeakObjectPtr<UClass>> FJsonUODeserialize::ClassByPath;
+
+UObject* FJsonUODeserialize::JsonStringToUObject(const FString& Json, UObject* Outer)
+{
+	//reads string in place, without copying it.
+	FBufferReader Archive((void*)*Json, Json.Len() * sizeof(TCHAR), false);
+	TSharedRef<FJsonUOReader> Reader = FJsonUOReader::Create(&Archive);
+
+	EJsonNotation Notation;
+	if (!Reader->ReadNext(Notation) || Notation != EJsonNotation::ObjectStart)
+	{
+		UE_LOG(LogJson, Error, TEXT("JsonStringToUObject - Json is not an object"));
+		return nullptr;
+	}
+	return ReadUObject(*Reader, Outer);
+}
+
+UObject* FJsonUODeserialize::ReadUObject(FJsonUOReader& Reader, UObject* Outer)
+{
+	EJsonNotation Notation;
+	//empty object stands for no object.
+	if (!Reader.ReadNext(Notation) || Notation == EJsonNotation::ObjectEnd)
+	{
+		return nullptr;
+	}
+	if (Notation != EJsonNotation::String || !Reader.GetIdentifier().Equals(TEXT("objectClass"), ESearchCase::IgnoreCase))
+	{
+		UE_LOG(LogJson, Error, TEXT("ReadUObject - objectClass must be first field of object"));
+		SkipValue(Reader, Notation);
+		Reader.SkipObject();
+		return nullptr;
+	}
+
+	UClass* ObjectClass = FindClass(Reader.GetValueAsString());
+	if (!ObjectClass)
+	{
+		UE_LOG(LogJson, Error, TEXT("ReadUObject - Unable to load class %s"), *Reader.GetValueAsString());
+		Reader.SkipObject();
+		return nullptr;
+	}
+
+	UObject* Object = NewObject<UObject>(Outer, ObjectClass);
+	if (!ReadFields(Reader, GetReadPlan(ObjectClass), Object, Object))
+	{
+		UE_LOG(LogJson, Error, TEXT("ReadUObject - Some properties of %s could not be read"), *ObjectClass->GetName());
+	}
+	return Object;
+}
+
+bool FJsonUODeserialize::ReadUStruct(FJsonUOReader& Reader, const UStruct* StructDefinition, void* OutStruct, UObject* Outer)
+{
+	return ReadFields(Reader, GetReadPlan(StructDefinition), OutStruct, Outer);
+}
+
+void FJsonUODeserialize::SkipValue(FJsonUOReader& Reader, EJsonNotation Notation)
+{
+	if (Notation == EJsonNotation::ObjectStart)
+	{
+		Reader.SkipObject();
+	}
+	else if (Notation == EJsonNotation::ArrayStart)
+	{
+		Reader.SkipArray();
+	}
+}
+
+UProperty* FJsonUODeserialize::FindProperty(const UStruct* StructDefinition, const FString& InName)
+{
+	const FJsonUOReadPlan& Plan = GetReadPlan(StructDefinition);
+	const int32* Idx = Plan.FieldIndex.Find(InName);
+	return Idx ? Plan.Fields[*Idx].Property : nullptr;
+}
+
+const FJsonUOReadPlan& FJsonUODeserialize::GetReadPlan(const UStruct* StructDefinition)
+{
+	const FObjectKey Key(StructDefinition);
+	if (TUniquePtr<FJsonUOReadPlan>* Existing = ReadPlans.Find(Key))
+	{
+		return **Existing;
+	}
+
+	//added before it's built, so struct which contains itself (through array) finds it instead of recursing.
+	FJsonUOReadPlan* Plan = ReadPlans.Add(Key, MakeUnique<FJsonUOReadPlan>()).Get();
+	for (TFieldIterator<UProperty> It(StructDefinition); It; ++It)
+	{
+		UProperty* Property = *It;
+		//first one wins, the same as with linear search.
+		if (Plan->FieldIndex.Contains(Property->GetName()))
+		{
+			continue;
+		}
+		const int32 Idx = Plan->Fields.AddDefaulted();
+		BuildPropertyPlan(Property, Plan->Fields[Idx]);
+		Plan->FieldIndex.Add(Property->GetName(), Idx);
+	}
+	return *Plan;
+}
+
+void FJsonUODeserialize::ResetPlans()
+{
+	ReadPlans.Empty();
+	ClassByPath.Empty();
+}
+
+void FJsonUODeserialize::BuildPropertyPlan(UProperty* Property, FJsonUOReadProperty& OutPlan)
+{
+	OutPlan.Property = Property;
+	if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Enum;
+		OutPlan.Enum = EnumProperty->GetEnum();
+	}
+	else if (UNumericProperty *NumericProperty = Cast<UNumericProperty>(Property))
+	{
+		if (NumericProperty->IsEnum())
+		{
+			OutPlan.Kind = EJsonUOReadKind::NumericEnum;
+			OutPlan.Enum = NumericProperty->GetIntPropertyEnum();
+		}
+		else if (NumericProperty->IsFloatingPoint())
+		{
+			OutPlan.Kind = EJsonUOReadKind::Float;
+		}
+		else if (NumericProperty->IsInteger())
+		{
+			OutPlan.Kind = EJsonUOReadKind::Integer;
+		}
+		else
+		{
+			OutPlan.Kind = EJsonUOReadKind::UnsupportedNumeric;
+		}
+	}
+	else if (Cast<UBoolProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Bool;
+	}
+	else if (Cast<UStrProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::String;
+	}
+	else if (Cast<UTextProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Text;
+	}
+	else if (UArrayProperty *ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Array;
+		BuildPropertyPlan(ArrayProperty->Inner, OutPlan.Inner[OutPlan.Inner.AddDefaulted()]);
+	}
+	else if (USetProperty* SetProperty = Cast<USetProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Set;
+		BuildPropertyPlan(SetProperty->ElementProp, OutPlan.Inner[OutPlan.Inner.AddDefaulted()]);
+	}
+	else if (UMapProperty* MapProperty = Cast<UMapProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Map;
+		OutPlan.Inner.AddDefaulted(2);
+		BuildPropertyPlan(MapProperty->KeyProp, OutPlan.Inner[0]);
+		BuildPropertyPlan(MapProperty->ValueProp, OutPlan.Inner[1]);
+	}
+	else if (Cast<UObjectProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Object;
+	}
+	else if (UStructProperty *StructProperty = Cast<UStructProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOReadKind::Struct;
+		OutPlan.StructPlan = &GetReadPlan(StructProperty->Struct);
+	}
+	else
+	{
+		OutPlan.Kind = EJsonUOReadKind::Other;
+	}
+}
+
+UClass* FJsonUODeserialize::FindClass(const FString& InPath)
+{
+	if (TWeakObjectPtr<UClass>* Cached = ClassByPath.Find(InPath))
+	{
+		if (UClass* Class = Cached->Get())
+		{
+			return Class;
+		}
+	}
+
+	UClass* Class = Cast<UClass>(FSoftClassPath(InPath).TryLoad());
+	if (Class)
+	{
+		ClassByPath.Add(InPath, Class);
+	}
+	return Class;
+}
+
+bool FJsonUODeserialize::ReadFields(FJsonUOReader& Reader, const FJsonUOReadPlan& Plan, void* OutStruct, UObject* Outer)
+{
+	bool bSuccess = true;
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
+	{
+		if (Notation == EJsonNotation::ObjectEnd)
+		{
+			return bSuccess;
+		}
+		if (Notation == EJsonNotation::Error)
+		{
+			break;
+		}
+
+		const int32* Idx = Plan.FieldIndex.Find(Reader.GetIdentifier());
+		if (!Idx)
+		{
+			//includes objectClass of nested structs.
+			SkipValue(Reader, Notation);
+			continue;
+		}
+		const FJsonUOReadProperty& Field = Plan.Fields[*Idx];
+		if (!ReadProperty(Reader, Notation, Field, Field.Property->ContainerPtrToValuePtr<uint8>(OutStruct), Outer))
+		{
+			UE_LOG(LogJson, Error, TEXT("ReadUStruct - Unable to parse %s from JSON"), *Field.Property->GetName());
+			bSuccess = false;
+		}
+	}
+
+	UE_LOG(LogJson, Error, TEXT("ReadUStruct - %s"), *Reader.GetErrorMessage());
+	return false;
+}
+
+bool FJsonUODeserialize::ReadProperty(FJsonUOReader& Reader, EJsonNotation Notation, const FJsonUOReadProperty& Plan, void* OutValue, UObject* Outer)
+{
+	//missing and null values keep their defaults.
+	if (Notation == EJsonNotation::Null)
+	{
+		return true;
+	}
+
+	const bool bArrayOrSet = Plan.Kind == EJsonUOReadKind::Array || Plan.Kind == EJsonUOReadKind::Set;
+	if (Plan.Property->ArrayDim == 1 || bArrayOrSet || Notation != EJsonNotation::ArrayStart)
+	{
+		return ReadScalar(Reader, Notation, Plan, OutValue, Outer);
+	}
+
+	//native array
+	bool bSuccess = true;
+	int32 Index = 0;
+	while (Reader.ReadNext(Notation) && Notation != EJsonNotation::ArrayEnd)
+	{
+		if (Notation == EJsonNotation::Error)
+		{
+			return false;
+		}
+		if (Index >= Plan.Property->ArrayDim)
+		{
+			UE_LOG(LogJson, Warning, TEXT("Ignoring excess properties when deserializing %s"), *Plan.Property->GetName());
+			SkipValue(Reader, Notation);
+			continue;
+		}
+		if (Notation != EJsonNotation::Null)
+		{
+			bSuccess &= ReadScalar(Reader, Notation, Plan, (uint8*)OutValue + Index * Plan.Property->ElementSize, Outer);
+		}
+		Index++;
+	}
+	return bSuccess;
+}
+
+bool FJsonUODeserialize::ReadScalar(FJsonUOReader& Reader, EJsonNotation Notation, const FJsonUOReadProperty& Plan, void* OutValue, UObject* Outer)
+{
+	UProperty* Property = Plan.Property;
+	switch (Plan.Kind)
+	{
+	case EJsonUOReadKind::Enum:
+	case EJsonUOReadKind::NumericEnum:
+	{
+		UNumericProperty* NumericProperty = Plan.Kind == EJsonUOReadKind::Enum
+			? static_cast<UEnumProperty*>(Property)->GetUnderlyingProperty()
+			: static_cast<UNumericProperty*>(Property);
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadKey(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		if (Notation == EJsonNotation::Number)
+		{
+			NumericProperty->SetIntPropertyValue(OutValue, (int64)Reader.GetValueAsNumber());
+			return true;
+		}
+		break;
+	}
+	case EJsonUOReadKind::Float:
+	case EJsonUOReadKind::Integer:
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadKey(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		if (Notation == EJsonNotation::Number)
+		{
+			UNumericProperty* NumericProperty = static_cast<UNumericProperty*>(Property);
+			if (Plan.Kind == EJsonUOReadKind::Float)
+			{
+				NumericProperty->SetFloatingPointPropertyValue(OutValue, Reader.GetValueAsNumber());
+			}
+			else
+			{
+				NumericProperty->SetIntPropertyValue(OutValue, (int64)Reader.GetValueAsNumber());
+			}
+			return true;
+		}
+		break;
+	case EJsonUOReadKind::Bool:
+		if (Notation == EJsonNotation::Boolean)
+		{
+			static_cast<UBoolProperty*>(Property)->SetPropertyValue(OutValue, Reader.GetValueAsBoolean());
+			return true;
+		}
+		if (Notation == EJsonNotation::Number)
+		{
+			static_cast<UBoolProperty*>(Property)->SetPropertyValue(OutValue, Reader.GetValueAsNumber() != 0);
+			return true;
+		}
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadKey(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		break;
+	case EJsonUOReadKind::String:
+		if (Notation == EJsonNotation::String)
+		{
+			static_cast<UStrProperty*>(Property)->SetPropertyValue(OutValue, Reader.GetValueAsString());
+			return true;
+		}
+		if (Notation == EJsonNotation::Number)
+		{
+			static_cast<UStrProperty*>(Property)->SetPropertyValue(OutValue, FString::SanitizeFloat(Reader.GetValueAsNumber()));
+			return true;
+		}
+		if (Notation == EJsonNotation::Boolean)
+		{
+			static_cast<UStrProperty*>(Property)->SetPropertyValue(OutValue, Reader.GetValueAsBoolean() ? TEXT("true") : TEXT("false"));
+			return true;
+		}
+		break;
+	case EJsonUOReadKind::Text:
+		if (Notation == EJsonNotation::String)
+		{
+			// assume this string is already localized, so import as invariant
+			static_cast<UTextProperty*>(Property)->SetPropertyValue(OutValue, FText::FromString(Reader.GetValueAsString()));
+			return true;
+		}
+		if (Notation == EJsonNotation::ObjectStart)
+		{
+			FText Text;
+			if (!ReadTextObject(Reader, Text))
+			{
+				UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Attempted to import FText from JSON object with invalid keys for property %s"), *Property->GetNameCPP());
+				return false;
+			}
+			static_cast<UTextProperty*>(Property)->SetPropertyValue(OutValue, Text);
+			return true;
+		}
+		break;
+	case EJsonUOReadKind::Array:
+	{
+		if (Notation != EJsonNotation::ArrayStart)
+		{
+			break;
+		}
+		const FJsonUOReadProperty& ElementPlan = Plan.Inner[0];
+		FScriptArrayHelper Helper(static_cast<UArrayProperty*>(Property), OutValue);
+		Helper.EmptyValues();
+
+		bool bSuccess = true;
+		while (Reader.ReadNext(Notation) && Notation != EJsonNotation::ArrayEnd)
+		{
+			if (Notation == EJsonNotation::Error)
+			{
+				return false;
+			}
+			//null elements keep their slot, with default value.
+			const int32 NewIndex = Helper.AddValue();
+			if (Notation != EJsonNotation::Null && !ReadProperty(Reader, Notation, ElementPlan, Helper.GetRawPtr(NewIndex), Outer))
+			{
+				UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to deserialize array element [%d] for property %s"), NewIndex, *Property->GetNameCPP());
+				bSuccess = false;
+			}
+		}
+		return bSuccess;
+	}
+	case EJsonUOReadKind::Set:
+	{
+		if (Notation != EJsonNotation::ArrayStart)
+		{
+			break;
+		}
+		const FJsonUOReadProperty& ElementPlan = Plan.Inner[0];
+		FScriptSetHelper Helper(static_cast<USetProperty*>(Property), OutValue);
+		Helper.EmptyElements();
+
+		bool bSuccess = true;
+		while (Reader.ReadNext(Notation) && Notation != EJsonNotation::ArrayEnd)
+		{
+			if (Notation == EJsonNotation::Error)
+			{
+				return false;
+			}
+			if (Notation == EJsonNotation::Null)
+			{
+				continue;
+			}
+			const int32 NewIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
+			if (!ReadProperty(Reader, Notation, ElementPlan, Helper.GetElementPtr(NewIndex), Outer))
+			{
+				UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to deserialize set element for property %s"), *Property->GetNameCPP());
+				bSuccess = false;
+			}
+		}
+		Helper.Rehash();
+		return bSuccess;
+	}
+	case EJsonUOReadKind::Map:
+	{
+		if (Notation != EJsonNotation::ObjectStart)
+		{
+			break;
+		}
+		const FJsonUOReadProperty& KeyPlan = Plan.Inner[0];
+		const FJsonUOReadProperty& ValuePlan = Plan.Inner[1];
+		FScriptMapHelper Helper(static_cast<UMapProperty*>(Property), OutValue);
+		Helper.EmptyValues();
+
+		bool bSuccess = true;
+		while (Reader.ReadNext(Notation) && Notation != EJsonNotation::ObjectEnd)
+		{
+			if (Notation == EJsonNotation::Error)
+			{
+				return false;
+			}
+			if (Notation == EJsonNotation::Null)
+			{
+				continue;
+			}
+			const int32 NewIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
+			const bool bKeySuccess = ReadKey(Reader.GetIdentifier(), KeyPlan, Helper.GetKeyPtr(NewIndex));
+			const bool bValueSuccess = ReadProperty(Reader, Notation, ValuePlan, Helper.GetValuePtr(NewIndex), Outer);
+			if (!(bKeySuccess && bValueSuccess))
+			{
+				UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to deserialize map element [key: %s] for property %s"), *Reader.GetIdentifier(), *Property->GetNameCPP());
+				bSuccess = false;
+			}
+		}
+		Helper.Rehash();
+		return bSuccess;
+	}
+	case EJsonUOReadKind::Object:
+		if (Notation == EJsonNotation::ObjectStart)
+		{
+			static_cast<UObjectProperty*>(Property)->SetObjectPropertyValue(OutValue, ReadUObject(Reader, Outer));
+			return true;
+		}
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadKey(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		break;
+	case EJsonUOReadKind::Struct:
+		if (Notation == EJsonNotation::ObjectStart)
+		{
+			return ReadFields(Reader, *Plan.StructPlan, OutValue, Outer);
+		}
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadStructFromString(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		break;
+	case EJsonUOReadKind::Other:
+		if (Notation == EJsonNotation::String)
+		{
+			return ReadKey(Reader.GetValueAsString(), Plan, OutValue);
+		}
+		break;
+	default:
+		break;
+	}
+
+	UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to import property type %s from JSON value for property %s"), *Property->GetClass()->GetName(), *Property->GetNameCPP());
+	SkipValue(Reader, Notation);
+	return false;
+}
+
+bool FJsonUODeserialize::ReadKey(const FString& Key, const FJsonUOReadProperty& Plan, void* OutValue)
+{
+	UProperty* Property = Plan.Property;
+	switch (Plan.Kind)
+	{
+	case EJsonUOReadKind::Enum:
+	case EJsonUOReadKind::NumericEnum:
+	{
+		int64 IntValue = Plan.Enum->GetValueByName(FName(*Key));
+		if (IntValue == INDEX_NONE)
+		{
+			UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable import enum %s from string value %s for property %s"), *Plan.Enum->CppType, *Key, *Property->GetNameCPP());
+			return false;
+		}
+		UNumericProperty* NumericProperty = Plan.Kind == EJsonUOReadKind::Enum
+			? static_cast<UEnumProperty*>(Property)->GetUnderlyingProperty()
+			: static_cast<UNumericProperty*>(Property);
+		NumericProperty->SetIntPropertyValue(OutValue, IntValue);
+		return true;
+	}
+	case EJsonUOReadKind::Float:
+		static_cast<UNumericProperty*>(Property)->SetFloatingPointPropertyValue(OutValue, FCString::Atod(*Key));
+		return true;
+	case EJsonUOReadKind::Integer:
+		// parse string -> int64 ourselves so we don't lose any precision going through double
+		static_cast<UNumericProperty*>(Property)->SetIntPropertyValue(OutValue, FCString::Atoi64(*Key));
+		return true;
+	case EJsonUOReadKind::Bool:
+		static_cast<UBoolProperty*>(Property)->SetPropertyValue(OutValue, Key.ToBool());
+		return true;
+	case EJsonUOReadKind::String:
+		static_cast<UStrProperty*>(Property)->SetPropertyValue(OutValue, Key);
+		return true;
+	case EJsonUOReadKind::Text:
+		static_cast<UTextProperty*>(Property)->SetPropertyValue(OutValue, FText::FromString(Key));
+		return true;
+	case EJsonUOReadKind::Struct:
+		return ReadStructFromString(Key, Plan, OutValue);
+	case EJsonUOReadKind::UnsupportedNumeric:
+		UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to set numeric property type %s for property %s"), *Property->GetClass()->GetName(), *Property->GetNameCPP());
+		return false;
+	default:
+		// Default to expect a string for everything else
+		if (Property->ImportText(*Key, OutValue, 0, NULL) == NULL)
+		{
+			UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable import property type %s from string value for property %s"), *Property->GetClass()->GetName(), *Property->GetNameCPP());
+			return false;
+		}
+		return true;
+	}
+}
+
+bool FJsonUODeserialize::ReadStructFromString(const FString& InString, const FJsonUOReadProperty& Plan, void* OutValue)
+{
+	static const FName NAME_DateTime(TEXT("DateTime"));
+	static const FName NAME_Color(TEXT("Color"));
+	static const FName NAME_LinearColor(TEXT("LinearColor"));
+
+	UStructProperty* StructProperty = static_cast<UStructProperty*>(Plan.Property);
+	const FName StructName = StructProperty->Struct->GetFName();
+	if (StructName == NAME_LinearColor)
+	{
+		FLinearColor& ColorOut = *(FLinearColor*)OutValue;
+		ColorOut = FColor::FromHex(InString);
+	}
+	else if (StructName == NAME_Color)
+	{
+		FColor& ColorOut = *(FColor*)OutValue;
+		ColorOut = FColor::FromHex(InString);
+	}
+	else if (StructName == NAME_DateTime)
+	{
+		FDateTime& DateTimeOut = *(FDateTime*)OutValue;
+		if (InString == TEXT("min"))
+		{
+			DateTimeOut = FDateTime::MinValue();
+		}
+		else if (InString == TEXT("max"))
+		{
+			DateTimeOut = FDateTime::MaxValue();
+		}
+		else if (InString == TEXT("now"))
+		{
+			DateTimeOut = FDateTime::UtcNow();
+		}
+		else if (!FDateTime::ParseIso8601(*InString, DateTimeOut) && !FDateTime::Parse(InString, DateTimeOut))
+		{
+			UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to import FDateTime for property %s"), *StructProperty->GetNameCPP());
+			return false;
+		}
+	}
+	else
+	{
+		const TCHAR* ImportTextPtr = *InString;
+		UScriptStruct::ICppStructOps* TheCppStructOps = StructProperty->Struct->GetCppStructOps();
+		if (!TheCppStructOps || !TheCppStructOps->HasImportTextItem()
+			|| !TheCppStructOps->ImportTextItem(ImportTextPtr, OutValue, PPF_None, nullptr, (FOutputDevice*)GWarn))
+		{
+			// Fall back to trying the tagged property approach if custom ImportTextItem couldn't get it done
+			StructProperty->ImportText(ImportTextPtr, OutValue, PPF_None, nullptr);
+		}
+	}
+	return true;
 }
 
-JsonUODeserialize::~JsonUODeserialize()
+bool FJsonUODeserialize::ReadTextObject(FJsonUOReader& Reader, FText& OutText)
 {
+	//localized text is rare, so culture matching is left to FJsonObjectConverter.
+	TSharedRef<FJsonObject> Object = MakeShareable(new FJsonObject());
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation) && Notation != EJsonNotation::ObjectEnd)
+	{
+		if (Notation == EJsonNotation::Error)
+		{
+			return false;
+		}
+		if (Notation == EJsonNotation::String)
+		{
+			Object->SetStringField(Reader.GetIdentifier(), Reader.GetValueAsString());
+		}
+		else
+		{
+			SkipValue(Reader, Notation);
+		}
+	}
+	return FJsonObjectConverter::GetTextFromObject(Object, OutText);
 }
@@ -216,4 +216,410 @@ bool FJsonUOSerialize::UStructToJsonAttributes(const UStruct* StructDefinition,
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+enum class EJsonUOPropertyKind : uint8
+{
+	Enum,
+	NumericEnum,
+	Float,
+	Integer,
+	Bool,
+	String,
+	Text,
+	Array,
+	Set,
+	Map,
+	Object,
+	/* Struct with ExportTextItem, written as string. */
+	ExportedStruct,
+	Struct,
+	/* Written as string from ExportTextItem. */
+	Other,
+	/* UObjectToJsonObject can't convert it either. */
+	Unsupported
+};
+
+struct FJsonUOPropertyPlan
+{
+	UProperty* Property;
+	EJsonUOPropertyKind Kind;
+	UEnum* Enum;
+	const FJsonUOStructPlan* StructPlan;
+	/* Element of array and set, key and value of map. */
+	TArray<FJsonUOPropertyPlan> Inner;
+
+	FJsonUOPropertyPlan()
+		: Property(nullptr)
+		, Kind(EJsonUOPropertyKind::Unsupported)
+		, Enum(nullptr)
+		, StructPlan(nullptr)
+	{}
+};
+
+struct FJsonUOStructPlan
+{
+	FString PathName;
+	/* Field names, the same order as Properties. */
+	TArray<FString> Names;
+	TArray<FJsonUOPropertyPlan> Properties;
+};
+
+TMap<FObjectKey, TUniquePtr<FJsonUOStructPlan>> FJsonUOSerialize::StructPlans;
+
+bool FJsonUOSerialize::UObjectToJsonWriter(const UStruct* StructDefinition, const void* Struct, FJsonUOWriter& Writer, const FString* Identifier)
+{
+	WriteStruct(GetStructPlan(StructDefinition), Struct, Writer, Identifier);
+	return true;
+}
+
+bool FJsonUOSerialize::UObjectToJsonBuffer(const UStruct* StructDefinition, const void* Struct, FJsonUOBuffer& OutBuffer)
+{
+	TSharedRef<FJsonUOWriter> Writer = OutBuffer.CreateWriter();
+	UObjectToJsonWriter(StructDefinition, Struct, *Writer);
+	return Writer->Close();
+}
+
+const FJsonUOStructPlan& FJsonUOSerialize::GetStructPlan(const UStruct* StructDefinition)
+{
+	const FObjectKey Key(StructDefinition);
+	if (TUniquePtr<FJsonUOStructPlan>* Existing = StructPlans.Find(Key))
+	{
+		return **Existing;
+	}
+
+	//added before it's built, so struct which contains itself (through array) finds it instead of recursing.
+	FJsonUOStructPlan* Plan = StructPlans.Add(Key, MakeUnique<FJsonUOStructPlan>()).Get();
+	Plan->PathName = StructDefinition->GetPathName();
+	for (TFieldIterator<UProperty> It(StructDefinition); It; ++It)
+	{
+		UProperty* Property = *It;
+		if (!Property->HasAnyPropertyFlags(CPF_SaveGame))
+		{
+			continue;
+		}
+		Plan->Names.Add(Property->GetName());
+		BuildPropertyPlan(Property, Plan->Properties[Plan->Properties.AddDefaulted()]);
+	}
+	return *Plan;
+}
+
+void FJsonUOSerialize::ResetPlans()
+{
+	StructPlans.Empty();
+}
+
+void FJsonUOSerialize::BuildPropertyPlan(UProperty* Property, FJsonUOPropertyPlan& OutPlan)
+{
+	//the same decisions ConvertScalarUPropertyToJsonValue makes for every value.
+	OutPlan.Property = Property;
+	if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Enum;
+		OutPlan.Enum = EnumProperty->GetEnum();
+	}
+	else if (UNumericProperty *NumericProperty = Cast<UNumericProperty>(Property))
+	{
+		if (UEnum* EnumDef = NumericProperty->GetIntPropertyEnum())
+		{
+			OutPlan.Kind = EJsonUOPropertyKind::NumericEnum;
+			OutPlan.Enum = EnumDef;
+		}
+		else if (NumericProperty->IsFloatingPoint())
+		{
+			OutPlan.Kind = EJsonUOPropertyKind::Float;
+		}
+		else if (NumericProperty->IsInteger())
+		{
+			OutPlan.Kind = EJsonUOPropertyKind::Integer;
+		}
+	}
+	else if (Cast<UBoolProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Bool;
+	}
+	else if (Cast<UStrProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::String;
+	}
+	else if (Cast<UTextProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Text;
+	}
+	else if (UArrayProperty *ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Array;
+		BuildPropertyPlan(ArrayProperty->Inner, OutPlan.Inner[OutPlan.Inner.AddDefaulted()]);
+	}
+	else if (USetProperty* SetProperty = Cast<USetProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Set;
+		BuildPropertyPlan(SetProperty->ElementProp, OutPlan.Inner[OutPlan.Inner.AddDefaulted()]);
+	}
+	else if (UMapProperty* MapProperty = Cast<UMapProperty>(Property))
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Map;
+		OutPlan.Inner.AddDefaulted(2);
+		BuildPropertyPlan(MapProperty->KeyProp, OutPlan.Inner[0]);
+		BuildPropertyPlan(MapProperty->ValueProp, OutPlan.Inner[1]);
+	}
+	else if (Cast<UObjectProperty>(Property))
+	{
+		//plan of object is picked by it's runtime class.
+		OutPlan.Kind = EJsonUOPropertyKind::Object;
+	}
+	else if (UStructProperty *StructProperty = Cast<UStructProperty>(Property))
+	{
+		UScriptStruct::ICppStructOps* TheCppStructOps = StructProperty->Struct->GetCppStructOps();
+		if (StructProperty->Struct != FJsonObjectWrapper::StaticStruct() && TheCppStructOps && TheCppStructOps->HasExportTextItem())
+		{
+			OutPlan.Kind = EJsonUOPropertyKind::ExportedStruct;
+		}
+		else
+		{
+			OutPlan.Kind = EJsonUOPropertyKind::Struct;
+			OutPlan.StructPlan = &GetStructPlan(StructProperty->Struct);
+		}
+	}
+	else
+	{
+		OutPlan.Kind = EJsonUOPropertyKind::Other;
+	}
+}
+
+void FJsonUOSerialize::WriteStruct(const FJsonUOStructPlan& Plan, const void* Struct, FJsonUOWriter& Writer, const FString* Identifier)
+{
+	if (Identifier)
+	{
+		Writer.WriteObjectStart(*Identifier);
+	}
+	else
+	{
+		Writer.WriteObjectStart();
+	}
+	Writer.WriteValue(TEXT("objectClass"), Plan.PathName);
+
+	for (int32 Idx = 0; Idx < Plan.Properties.Num(); Idx++)
+	{
+		const FJsonUOPropertyPlan& PropertyPlan = Plan.Properties[Idx];
+		const void* Value = PropertyPlan.Property->ContainerPtrToValuePtr<uint8>(Struct);
+		if (PropertyPlan.Property->ArrayDim == 1)
+		{
+			if (!WriteScalar(PropertyPlan, Value, Writer, &Plan.Names[Idx]))
+			{
+				UClass* PropClass = PropertyPlan.Property->GetClass();
+				UE_LOG(LogJson, Error, TEXT("UObjectToJsonWriter - Unhandled property type '%s': %s"), *PropClass->GetName(), *PropertyPlan.Property->GetPathName());
+			}
+		}
+		else
+		{
+			WriteProperty(PropertyPlan, Value, Writer, &Plan.Names[Idx]);
+		}
+	}
+
+	Writer.WriteObjectEnd();
+}
+
+void FJsonUOSerialize::WriteProperty(const FJsonUOPropertyPlan& Plan, const void* Value, FJsonUOWriter& Writer, const FString* Identifier)
+{
+	if (Plan.Property->ArrayDim == 1)
+	{
+		WriteScalar(Plan, Value, Writer, Identifier);
+		return;
+	}
+
+	if (Identifier)
+	{
+		Writer.WriteArrayStart(*Identifier);
+	}
+	else
+	{
+		Writer.WriteArrayStart();
+	}
+	for (int Index = 0; Index != Plan.Property->ArrayDim; ++Index)
+	{
+		if (!WriteScalar(Plan, (const uint8*)Value + Index * Plan.Property->ElementSize, Writer, nullptr))
+		{
+			Writer.WriteNull();
+		}
+	}
+	Writer.WriteArrayEnd();
+}
+
+namespace JsonUOSerialize
+{
+	template<typename ValueType>
+	inline void WriteValue(FJsonUOWriter& Writer, const FString* Identifier, ValueType Value)
+	{
+		if (Identifier)
+		{
+			Writer.WriteValue(*Identifier, Value);
+		}
+		else
+		{
+			Writer.WriteValue(Value);
+		}
+	}
+}
+
+bool FJsonUOSerialize::WriteScalar(const FJsonUOPropertyPlan& Plan, const void* Value, FJsonUOWriter& Writer, const FString* Identifier)
+{
+	using JsonUOSerialize::WriteValue;
+	switch (Plan.Kind)
+	{
+	case EJsonUOPropertyKind::Enum:
+	{
+		UEnumProperty* EnumProperty = static_cast<UEnumProperty*>(Plan.Property);
+		WriteValue(Writer, Identifier, Plan.Enum->GetNameStringByValue(EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value)));
+		return true;
+	}
+	case EJsonUOPropertyKind::NumericEnum:
+		WriteValue(Writer, Identifier, Plan.Enum->GetNameStringByValue(static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Value)));
+		return true;
+	case EJsonUOPropertyKind::Float:
+		WriteValue(Writer, Identifier, static_cast<UNumericProperty*>(Plan.Property)->GetFloatingPointPropertyValue(Value));
+		return true;
+	case EJsonUOPropertyKind::Integer:
+		WriteValue(Writer, Identifier, static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Value));
+		return true;
+	case EJsonUOPropertyKind::Bool:
+		WriteValue(Writer, Identifier, static_cast<UBoolProperty*>(Plan.Property)->GetPropertyValue(Value));
+		return true;
+	case EJsonUOPropertyKind::String:
+		WriteValue<const FString&>(Writer, Identifier, static_cast<UStrProperty*>(Plan.Property)->GetPropertyValue(Value));
+		return true;
+	case EJsonUOPropertyKind::Text:
+		WriteValue(Writer, Identifier, static_cast<UTextProperty*>(Plan.Property)->GetPropertyValue(Value).ToString());
+		return true;
+	case EJsonUOPropertyKind::Array:
+	{
+		const FJsonUOPropertyPlan& ElementPlan = Plan.Inner[0];
+		FScriptArrayHelper Helper(static_cast<UArrayProperty*>(Plan.Property), Value);
+		if (Identifier)
+		{
+			Writer.WriteArrayStart(*Identifier);
+		}
+		else
+		{
+			Writer.WriteArrayStart();
+		}
+		for (int32 i = 0, n = Helper.Num(); i < n; ++i)
+		{
+			WriteProperty(ElementPlan, Helper.GetRawPtr(i), Writer, nullptr);
+		}
+		Writer.WriteArrayEnd();
+		return true;
+	}
+	case EJsonUOPropertyKind::Set:
+	{
+		const FJsonUOPropertyPlan& ElementPlan = Plan.Inner[0];
+		FScriptSetHelper Helper(static_cast<USetProperty*>(Plan.Property), Value);
+		if (Identifier)
+		{
+			Writer.WriteArrayStart(*Identifier);
+		}
+		else
+		{
+			Writer.WriteArrayStart();
+		}
+		for (int32 i = 0, n = Helper.Num(); n; ++i)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				WriteProperty(ElementPlan, Helper.GetElementPtr(i), Writer, nullptr);
+				--n;
+			}
+		}
+		Writer.WriteArrayEnd();
+		return true;
+	}
+	case EJsonUOPropertyKind::Map:
+	{
+		const FJsonUOPropertyPlan& KeyPlan = Plan.Inner[0];
+		const FJsonUOPropertyPlan& ValuePlan = Plan.Inner[1];
+		FScriptMapHelper Helper(static_cast<UMapProperty*>(Plan.Property), Value);
+		if (Identifier)
+		{
+			Writer.WriteObjectStart(*Identifier);
+		}
+		else
+		{
+			Writer.WriteObjectStart();
+		}
+		for (int32 i = 0, n = Helper.Num(); n; ++i)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				FString KeyString = MapKeyToString(KeyPlan, Helper.GetKeyPtr(i));
+				if (KeyString.IsEmpty())
+				{
+					UE_LOG(LogJson, Error, TEXT("Unable to convert key to string for property %s."), *Plan.Property->GetName())
+					KeyString = FString::Printf(TEXT("Unparsed Key %d"), i);
+				}
+				WriteProperty(ValuePlan, Helper.GetValuePtr(i), Writer, &KeyString);
+				--n;
+			}
+		}
+		Writer.WriteObjectEnd();
+		return true;
+	}
+	case EJsonUOPropertyKind::Object:
+	{
+		UObject* Object = static_cast<UObjectProperty*>(Plan.Property)->GetObjectPropertyValue(Value);
+		if (!Object)
+		{
+			return false;
+		}
+		WriteStruct(GetStructPlan(Object->GetClass()), Object, Writer, Identifier);
+		return true;
+	}
+	case EJsonUOPropertyKind::ExportedStruct:
+	{
+		FString OutValueStr;
+		static_cast<UStructProperty*>(Plan.Property)->Struct->GetCppStructOps()->ExportTextItem(OutValueStr, Value, nullptr, nullptr, PPF_None, nullptr);
+		WriteValue<const FString&>(Writer, Identifier, OutValueStr);
+		return true;
+	}
+	case EJsonUOPropertyKind::Struct:
+		WriteStruct(*Plan.StructPlan, Value, Writer, Identifier);
+		return true;
+	case EJsonUOPropertyKind::Other:
+	{
+		FString StringValue;
+		Plan.Property->ExportTextItem(StringValue, Value, NULL, NULL, PPF_None);
+		WriteValue<const FString&>(Writer, Identifier, StringValue);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+FString FJsonUOSerialize::MapKeyToString(const FJsonUOPropertyPlan& Plan, const void* Key)
+{
+	//string form of values UObjectToJsonObject uses as map keys.
+	switch (Plan.Kind)
+	{
+	case EJsonUOPropertyKind::Enum:
+		return Plan.Enum->GetNameStringByValue(static_cast<UEnumProperty*>(Plan.Property)->GetUnderlyingProperty()->GetSignedIntPropertyValue(Key));
+	case EJsonUOPropertyKind::NumericEnum:
+		return Plan.Enum->GetNameStringByValue(static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Key));
+	//numbers go through double, the same as FJsonValueNumber::AsString.
+	case EJsonUOPropertyKind::Float:
+		return FString::SanitizeFloat(static_cast<UNumericProperty*>(Plan.Property)->GetFloatingPointPropertyValue(Key), 0);
+	case EJsonUOPropertyKind::Integer:
+		return FString::SanitizeFloat((double)static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Key), 0);
+	case EJsonUOPropertyKind::Bool:
+		return static_cast<UBoolProperty*>(Plan.Property)->GetPropertyValue(Key) ? TEXT("true") : TEXT("false");
+	case EJsonUOPropertyKind::String:
+		return static_cast<UStrProperty*>(Plan.Property)->GetPropertyValue(Key);
+	case EJsonUOPropertyKind::Text:
+		return static_cast<UTextProperty*>(Plan.Property)->GetPropertyValue(Key).ToString();
+	default:
+	{
+		FString KeyString;
+		Plan.Property->ExportTextItem(KeyString, Key, nullptr, nullptr, 0);
+		return KeyString;
+	}
+	}
+}
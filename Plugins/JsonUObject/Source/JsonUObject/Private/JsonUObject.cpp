@@ -1,18 +1,36 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "JsonUObject.h"
+#include "JsonUOSerialize.h"
+#include "JsonUODeserialize.h"
+#include "UObject/UObjectGlobals.h"
 
 #define LOCTEXT_NAMESPACE "FJsonUObjectModule"
 
 void FJsonUObjectModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+#if WITH_EDITOR
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FJsonUObjectModule::OnObjectsReplaced);
+#endif
 }
 
 void FJsonUObjectModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+#endif
+	FJsonUOSerialize::ResetPlans();
+	FJsonUODeserialize::ResetPlans();
+}
+
+void FJsonUObjectModule::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects)
+{
+	//reinstancing after blueprint compile or hot reload, cached properties and offsets may be gone.
+	FJsonUOSerialize::ResetPlans();
+	FJsonUODeserialize::ResetPlans();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -4,12 +4,57 @@
 
 #include "CoreMinimal.h"
 
+#include "Serialization/JsonTypes.h"
+#include "Serialization/JsonReader.h"
+#include "UObject/ObjectKey.h"
+
+typedef TJsonReader<TCHAR> FJsonUOReader;
+
+struct FJsonUOReadProperty;
+struct FJsonUOReadPlan;
+
 /**
- * 
+ *	Reads JSON written by FJsonUOSerialize straight from TJsonReader, without building FJsonObject tree.
+ *	Fields are resolved through per UStruct name -> property table, built on first use.
+ *	Objects are created from their "objectClass" field, which must be first field of object.
+ *
+ *	Game thread only.
  */
-class JSONUOBJECT_API JsonUODeserialize
+class JSONUOBJECT_API FJsonUODeserialize
 {
+	static TMap<FObjectKey, TUniquePtr<FJsonUOReadPlan>> ReadPlans;
+	static TMap<FString, TWeakObjectPtr<UClass>> ClassByPath;
+
 public:
-	JsonUODeserialize();
-	~JsonUODeserialize();
+	/* Creates object from Json. Returns nullptr if it's not object, or class can't be loaded. */
+	static UObject* JsonStringToUObject(const FString& Json, UObject* Outer);
+
+	/* Cached plans point at properties, which are recreated by blueprint compile and hot reload. */
+	static void ResetPlans();
+
+	/*
+		Reader must have just read ObjectStart of object. Reads it to the end.
+		Nested objects are created with the new object as their outer.
+	*/
+	static UObject* ReadUObject(FJsonUOReader& Reader, UObject* Outer);
+	/* Reader must have just read ObjectStart. Reads remaining fields into Struct. Unknown fields are skipped. */
+	static bool ReadUStruct(FJsonUOReader& Reader, const UStruct* StructDefinition, void* OutStruct, UObject* Outer);
+	/* Skips value, which Notation has just been read. */
+	static void SkipValue(FJsonUOReader& Reader, EJsonNotation Notation);
+
+	/* Property of StructDefinition, which name is case insensitive equal to InName. */
+	static UProperty* FindProperty(const UStruct* StructDefinition, const FString& InName);
+
+private:
+	static const FJsonUOReadPlan& GetReadPlan(const UStruct* StructDefinition);
+	static void BuildPropertyPlan(UProperty* Property, FJsonUOReadProperty& OutPlan);
+	static UClass* FindClass(const FString& InPath);
+
+	static bool ReadFields(FJsonUOReader& Reader, const FJsonUOReadPlan& Plan, void* OutStruct, UObject* Outer);
+	static bool ReadProperty(FJsonUOReader& Reader, EJsonNotation Notation, const FJsonUOReadProperty& Plan, void* OutValue, UObject* Outer);
+	static bool ReadScalar(FJsonUOReader& Reader, EJsonNotation Notation, const FJsonUOReadProperty& Plan, void* OutValue, UObject* Outer);
+	/* Map keys are always strings. */
+	static bool ReadKey(const FString& Key, const FJsonUOReadProperty& Plan, void* OutValue);
+	static bool ReadStructFromString(const FString& InString, const FJsonUOReadProperty& Plan, void* OutValue);
+	static bool ReadTextObject(FJsonUOReader& Reader, FText& OutText);
 };
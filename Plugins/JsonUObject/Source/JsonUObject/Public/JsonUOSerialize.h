@@ -10,16 +10,81 @@
 #include "Serialization/JsonReader.h"
 #include "Policies/PrettyJsonPrintPolicy.h"
 #include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/ObjectKey.h"
+
+typedef TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>> FJsonUOWriter;
+
+struct FJsonUOPropertyPlan;
+struct FJsonUOStructPlan;
+
+/*
+	Output of FJsonUOSerialize streaming functions. Holds TCHARs written by FJsonUOWriter.
+	Keeps it's allocation between uses, so it's meant to be kept around and reused.
+*/
+class JSONUOBJECT_API FJsonUOBuffer
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Archive;
+
+public:
+	FJsonUOBuffer()
+		: Archive(Bytes)
+	{}
+	FJsonUOBuffer(const FJsonUOBuffer&) = delete;
+	FJsonUOBuffer& operator=(const FJsonUOBuffer&) = delete;
+
+	/* Clears buffer and returns writer appending to it. Buffer must outlive writer. */
+	TSharedRef<FJsonUOWriter> CreateWriter()
+	{
+		Bytes.Reset();
+		Archive.Seek(0);
+		return FJsonUOWriter::Create(&Archive);
+	}
+
+	inline const TCHAR* GetData() const { return reinterpret_cast<const TCHAR*>(Bytes.GetData()); }
+	/* Number of characters. */
+	inline int32 Len() const { return Bytes.Num() / sizeof(TCHAR); }
+	inline const TArray<uint8>& GetBytes() const { return Bytes; }
+	inline FString ToString() const { return FString(Len(), GetData()); }
+};
 
 /**
  * 
  */
 class JSONUOBJECT_API FJsonUOSerialize
 {
+	/*
+		Per UStruct list of serialized properties, with their conversion already decided.
+		Built on first use, game thread only. Dropped by ResetPlans when properties are recreated.
+	*/
+	static TMap<FObjectKey, TUniquePtr<FJsonUOStructPlan>> StructPlans;
+
 public:
 	static bool UObjectToJsonObject(const UStruct* StructDefinition, const void* Struct, TSharedRef<FJsonObject> OutJsonObject);
+
+	/*
+		Writes the same JSON as UObjectToJsonObject, directly to Writer, without building FJsonObject tree.
+		If Identifier is set, object is written as field of currently open object.
+	*/
+	static bool UObjectToJsonWriter(const UStruct* StructDefinition, const void* Struct, FJsonUOWriter& Writer, const FString* Identifier = nullptr);
+	/* Replaces content of OutBuffer with object. */
+	static bool UObjectToJsonBuffer(const UStruct* StructDefinition, const void* Struct, FJsonUOBuffer& OutBuffer);
+
+	/* Plans point at properties, which are recreated by blueprint compile and hot reload. */
+	static void ResetPlans();
+
 private:
 	static TSharedPtr<FJsonValue> ConvertScalarUPropertyToJsonValue(UProperty* Property, const void* Value);
 	static TSharedPtr<FJsonValue> UPropertyToJsonValue(UProperty* Property, const void* Value);
 	static bool UStructToJsonAttributes(const UStruct* StructDefinition, const void* Struct, TMap< FString, TSharedPtr<FJsonValue> >& OutJsonAttributes);
+
+	static const FJsonUOStructPlan& GetStructPlan(const UStruct* StructDefinition);
+	static void BuildPropertyPlan(UProperty* Property, FJsonUOPropertyPlan& OutPlan);
+
+	static void WriteStruct(const FJsonUOStructPlan& Plan, const void* Struct, FJsonUOWriter& Writer, const FString* Identifier);
+	static void WriteProperty(const FJsonUOPropertyPlan& Plan, const void* Value, FJsonUOWriter& Writer, const FString* Identifier);
+	/* Returns false if value is skipped, same as when UObjectToJsonObject can't convert it. */
+	static bool WriteScalar(const FJsonUOPropertyPlan& Plan, const void* Value, FJsonUOWriter& Writer, const FString* Identifier);
+	static FString MapKeyToString(const FJsonUOPropertyPlan& Plan, const void* Key);
 };
@@ -12,4 +12,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects);
+
+	FDelegateHandle ObjectsReplacedHandle;
 };
@@ -1,18 +1,23 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "SpectrAI.h"
+#include "SpectrSpatialRegistry.h"
+#include "Engine/World.h"
 
 #define LOCTEXT_NAMESPACE "FSpectrAIModule"
 
 void FSpectrAIModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FSpectrSpatialRegistry::OnWorldCleanup);
 }
 
 void FSpectrAIModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	FSpectrSpatialRegistry::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
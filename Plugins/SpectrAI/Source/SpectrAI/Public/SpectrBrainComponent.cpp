@@ -5,16 +5,63 @@
 #include "AIController.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
 
-bool operator==(const FSpectrNode& Other, const USpectrAction*& Action)
+static int32 GSpectrMaxConcurrentPlans = 4;
+static FAutoConsoleVariableRef CVarSpectrMaxConcurrentPlans(
+	TEXT("spectr.MaxConcurrentPlans"),
+	GSpectrMaxConcurrentPlans,
+	TEXT("Maximum number of agents which can search for plan at the same time. Others wait for free slot."),
+	ECVF_Default);
+
+/*
+	Limits number of plans searched at once. Only touched on game thread,
+	workers report back trough game thread task.
+*/
+struct FSpectrPlanScheduler
 {
-	return Other.Action == Action;
-}
+	static int32 NumInFlight;
+	static TArray<TWeakObjectPtr<USpectrBrainComponent>> Waiting;
+
+	static bool TryAcquire()
+	{
+		if (NumInFlight >= FMath::Max(GSpectrMaxConcurrentPlans, 1))
+			return false;
+		NumInFlight++;
+		return true;
+	}
+
+	static void Release()
+	{
+		NumInFlight--;
+		//hand slot to first agent which is still alive.
+		while (Waiting.Num() > 0)
+		{
+			TWeakObjectPtr<USpectrBrainComponent> Next = Waiting[0];
+			Waiting.RemoveAt(0, 1, false);
+			if (USpectrBrainComponent* Brain = Next.Get())
+			{
+				Brain->bPlanQueued = false;
+				Brain->RequestPlan();
+				break;
+			}
+		}
+	}
+};
+int32 FSpectrPlanScheduler::NumInFlight = 0;
+TArray<TWeakObjectPtr<USpectrBrainComponent>> FSpectrPlanScheduler::Waiting;
 
 USpectrBrainComponent::USpectrBrainComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	FSMState = ESpectrState::Idle;
+	MinReplanDelay = 0.2f;
+	MaxReplanDelay = 3.2f;
+	ReplanDelay = 0;
+	bPlanInFlight = false;
+	bPlanQueued = false;
 	if(Context)
 		CurrentContext = Cast<USpectrContext>(CreateDefaultSubobject(TEXT("CurrentContext"), Context, Context, true, false, false));
 }
@@ -39,6 +86,20 @@ void USpectrBrainComponent::BeginPlay()
 		Actions.Add(Action);
 	}
 }
+void USpectrBrainComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(NextPlanTimerHandle);
+	}
+	if (bPlanQueued)
+	{
+		FSpectrPlanScheduler::Waiting.Remove(this);
+		bPlanQueued = false;
+	}
+	//running search keeps its job alive, result is dropped once it finds this component gone.
+	Super::EndPlay(EndPlayReason);
+}
 void USpectrBrainComponent::StarPlanning()
 {
 	//no point of running planner on clients.
@@ -46,51 +107,96 @@ void USpectrBrainComponent::StarPlanning()
 	{
 		return;
 	}
+	RequestPlan();
+}
+void USpectrBrainComponent::NextPlan()
+{
+	RequestPlan();
+}
+void USpectrBrainComponent::RequestPlan()
+{
+	if (bPlanInFlight || bPlanQueued)
+		return;
 
-	TArray<USpectrAction*> OutActionList;
-	if (AAIController* AIController = Cast<AAIController>(GetOwner()))
+	if (!FSpectrPlanScheduler::TryAcquire())
 	{
-		SpectrAI.Plan(Goal, CurrentState, OutActionList, Actions, CurrentContext, AIController);
+		bPlanQueued = true;
+		FSpectrPlanScheduler::Waiting.Add(this);
+		return;
 	}
-	for (int32 Idx = OutActionList.Num() - 1; Idx >= 0; Idx--)
+	LaunchPlan();
+}
+void USpectrBrainComponent::LaunchPlan()
+{
+	AAIController* AIController = Cast<AAIController>(GetOwner());
+	if (!PlanJob.IsValid())
 	{
-		FString name = OutActionList[Idx]->GetName();
-		
-		PendingPlan.Add(OutActionList[Idx]);
-		PendingPlan2.Enqueue(OutActionList[Idx]);
-
-		UE_LOG(LogTemp, Log, TEXT("Action Name: %s \n"), *name);
+		PlanJob = MakeShareable(new FSpectrPlanJob());
 	}
-	if (OutActionList.Num() == 0)
+	//snapshot on game thread, action conditions and scores can run blueprint code.
+	if (!AIController
+		|| !PlanJob->Snapshot.Build(Goal, CurrentState, Actions, CurrentContext, AIController)
+		|| PlanJob->Snapshot.IsSameProblem(FailedSnapshot))
 	{
-		FTimerManager& Timer = GetWorld()->GetTimerManager();
-		FTimerDelegate del = FTimerDelegate::CreateUObject(this, &USpectrBrainComponent::NextPlan);
-		Timer.SetTimer(NextPlanTimerHandle, del, 0.2f, false, 0.2f);
+		FSpectrPlanScheduler::Release();
+		OnPlanFailed();
+		return;
 	}
-	else
+
+	bPlanInFlight = true;
+	TSharedPtr<FSpectrPlanJob, ESPMode::ThreadSafe> Job = PlanJob;
+	TWeakObjectPtr<USpectrBrainComponent> WeakThis(this);
+	if (!FPlatformProcess::SupportsMultithreading())
 	{
-		ExecutePlan(nullptr);
+		Job->bFound = Job->Planner.Search(Job->Snapshot, Job->Result);
+		FSpectrPlanScheduler::Release();
+		OnPlanFinished();
+		return;
 	}
-	
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Job, WeakThis]()
+	{
+		Job->bFound = Job->Planner.Search(Job->Snapshot, Job->Result);
+		AsyncTask(ENamedThreads::GameThread, [Job, WeakThis]()
+		{
+			FSpectrPlanScheduler::Release();
+			if (USpectrBrainComponent* Brain = WeakThis.Get())
+			{
+				Brain->OnPlanFinished();
+			}
+		});
+	});
 }
-void USpectrBrainComponent::NextPlan()
+void USpectrBrainComponent::OnPlanFinished()
 {
-	TArray<USpectrAction*> OutActionList;
-	if (AAIController* AIController = Cast<AAIController>(GetOwner()))
+	bPlanInFlight = false;
+	if (!PlanJob->bFound || PlanJob->Result.Num() == 0)
 	{
-		SpectrAI.Plan(Goal, CurrentState, OutActionList, Actions, CurrentContext, AIController);
-	}
-	if (OutActionList.Num() == 0)
-	{
-		FTimerManager& Timer = GetWorld()->GetTimerManager();
-		FTimerDelegate del = FTimerDelegate::CreateUObject(this, &USpectrBrainComponent::NextPlan);
-		Timer.SetTimer(NextPlanTimerHandle, del, 0.2f, false, 0.2f);
+		FailedSnapshot = PlanJob->Snapshot;
+		OnPlanFailed();
+		return;
 	}
-	else
+	FailedSnapshot = FSpectrPlanSnapshot();
+	ReplanDelay = 0;
+
+	//result goes from last action to first one.
+	const TArray<FSpectrPlannerAction>& PlannedActions = PlanJob->Snapshot.Actions;
+	for (int32 Idx = PlanJob->Result.Num() - 1; Idx >= 0; Idx--)
 	{
-		ExecutePlan(nullptr);
+		USpectrAction* Action = PlannedActions[PlanJob->Result[Idx]].Action;
+		PendingPlan.Add(Action);
+		PendingPlan2.Enqueue(Action);
+
+		UE_LOG(LogTemp, Log, TEXT("Action Name: %s \n"), *Action->GetName());
 	}
-	
+	ExecutePlan(nullptr);
+}
+void USpectrBrainComponent::OnPlanFailed()
+{
+	ReplanDelay = ReplanDelay > 0 ? FMath::Min(ReplanDelay * 2, MaxReplanDelay) : MinReplanDelay;
+
+	FTimerManager& Timer = GetWorld()->GetTimerManager();
+	FTimerDelegate del = FTimerDelegate::CreateUObject(this, &USpectrBrainComponent::NextPlan);
+	Timer.SetTimer(NextPlanTimerHandle, del, ReplanDelay, false, ReplanDelay);
 }
 void USpectrBrainComponent::SelectGoal()
 {
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpectrInteractableComponent.h"
+#include "SpectrSpatialRegistry.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+USpectrInteractableComponent::USpectrInteractableComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bUpdateWhenMoved = false;
+}
+
+void USpectrInteractableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	AActor* Owner = GetOwner();
+	FSpectrSpatialRegistry::Get(GetWorld()).Register(Owner);
+
+	if (bUpdateWhenMoved && Owner->GetRootComponent())
+	{
+		Owner->GetRootComponent()->TransformUpdated.AddUObject(this, &USpectrInteractableComponent::OnOwnerMoved);
+	}
+}
+
+void USpectrInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AActor* Owner = GetOwner();
+	if (Owner->GetRootComponent())
+	{
+		Owner->GetRootComponent()->TransformUpdated.RemoveAll(this);
+	}
+	//registry can be already gone, if world is being cleaned up.
+	if (FSpectrSpatialRegistry* Registry = FSpectrSpatialRegistry::Find(GetWorld()))
+	{
+		Registry->Unregister(Owner);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void USpectrInteractableComponent::OnOwnerMoved(USceneComponent* InRoot, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	FSpectrSpatialRegistry::Get(GetWorld()).UpdateLocation(GetOwner());
+}
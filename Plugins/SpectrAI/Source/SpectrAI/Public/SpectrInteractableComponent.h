@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SpectrInteractableComponent.generated.h"
+
+/**
+ *	Registers owning actor in FSpectrSpatialRegistry for as long as it is playing,
+ *	so actions can find it without iterating all actors in world.
+ */
+UCLASS(ClassGroup = (SpectrAI), meta = (BlueprintSpawnableComponent))
+class SPECTRAI_API USpectrInteractableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	/* Update registry when owner's root component moves. Leave off for static interactables. */
+	UPROPERTY(EditAnywhere, Category = "Spectr AI")
+		bool bUpdateWhenMoved;
+
+	USpectrInteractableComponent(const FObjectInitializer& ObjectInitializer);
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+protected:
+	void OnOwnerMoved(USceneComponent* InRoot, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+};
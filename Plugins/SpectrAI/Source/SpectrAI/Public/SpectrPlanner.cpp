@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpectrPlanner.h"
+#include "SpectrAction.h"
+
+DECLARE_CYCLE_STAT(TEXT("SpectrAI.Plan"), STAT_SpectrPlan, STATGROUP_SpectrAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SpectrAI.ExpandedNodes"), STAT_SpectrExpandedNodes, STATGROUP_SpectrAI);
+
+namespace
+{
+	struct FSpectrOpenNodePredicate
+	{
+		const TArray<FSpectrPlanNode>& Nodes;
+		FSpectrOpenNodePredicate(const TArray<FSpectrPlanNode>& InNodes)
+			: Nodes(InNodes)
+		{}
+		bool operator()(int32 A, int32 B) const
+		{
+			const FSpectrPlanNode& NodeA = Nodes[A];
+			const FSpectrPlanNode& NodeB = Nodes[B];
+			if (NodeA.EstimatedCost != NodeB.EstimatedCost)
+			{
+				return NodeA.EstimatedCost < NodeB.EstimatedCost;
+			}
+			return NodeA.Score > NodeB.Score;
+		}
+	};
+}
+
+namespace SpectrPlanner
+{
+	bool AddTags(TMap<FGameplayTag, int32>& TagBits, const TMap<FGameplayTag, bool>& InTags)
+	{
+		for (const TPair<FGameplayTag, bool>& Tag : InTags)
+		{
+			if (TagBits.Contains(Tag.Key))
+				continue;
+			if (TagBits.Num() >= FSpectrPlanner::MaxTags)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("SpectrAI - plan uses more than %d tags, can't build plan."), FSpectrPlanner::MaxTags);
+				return false;
+			}
+			TagBits.Add(Tag.Key, TagBits.Num());
+		}
+		return true;
+	}
+
+	FSpectrStateCondition MakeCondition(const TMap<FGameplayTag, int32>& TagBits, const TMap<FGameplayTag, bool>& InTags)
+	{
+		FSpectrStateCondition Condition;
+		for (const TPair<FGameplayTag, bool>& Tag : InTags)
+		{
+			const uint64 Bit = uint64(1) << TagBits.FindChecked(Tag.Key);
+			Condition.Mask |= Bit;
+			if (Tag.Value)
+			{
+				Condition.Values |= Bit;
+			}
+		}
+		return Condition;
+	}
+
+	int32 Heuristic(const FSpectrPlanSnapshot& InSnapshot, const FSpectrWorldState& InState)
+	{
+		//single action can fix at most MaxGoalBitsPerAction goal bits, so this never overestimates.
+		const int32 Unsatisfied = InSnapshot.GoalCondition.CountUnsatisfied(InState);
+		if (Unsatisfied == 0 || InSnapshot.MaxGoalBitsPerAction == 0)
+			return 0;
+		return FMath::DivideAndRoundUp(Unsatisfied, InSnapshot.MaxGoalBitsPerAction) * InSnapshot.MinActionCost;
+	}
+}
+
+bool FSpectrPlanSnapshot::Build(const TMap<FGameplayTag, bool>& InGoal
+	, const TMap<FGameplayTag, bool>& InCurrentState
+	, const TArray<USpectrAction*>& InActions
+	, class USpectrContext* InContext
+	, class AAIController* AIController)
+{
+	check(IsInGameThread());
+	Actions.Reset();
+	GoalCondition = FSpectrStateCondition();
+	StartState = FSpectrWorldState();
+	MaxGoalBitsPerAction = 0;
+	MinActionCost = 0;
+	bValid = false;
+
+	TMap<FGameplayTag, int32> TagBits;
+	if (!SpectrPlanner::AddTags(TagBits, InGoal) || !SpectrPlanner::AddTags(TagBits, InCurrentState))
+		return false;
+
+	//actions which can't be used right now are not considered at all.
+	for (USpectrAction* Action : InActions)
+	{
+		if (!Action || !Action->NativeEvaluateCondition(InContext, AIController))
+			continue;
+		if (!SpectrPlanner::AddTags(TagBits, Action->PreConditions) || !SpectrPlanner::AddTags(TagBits, Action->Effects))
+			return false;
+
+		FSpectrPlannerAction& PlannerAction = Actions[Actions.AddDefaulted()];
+		PlannerAction.Action = Action;
+		PlannerAction.Cost = FMath::Max(Action->Cost, 0);
+		PlannerAction.Score = Action->NativeScore(InContext, AIController);
+	}
+
+	GoalCondition = SpectrPlanner::MakeCondition(TagBits, InGoal);
+	MinActionCost = MAX_int32;
+	for (FSpectrPlannerAction& PlannerAction : Actions)
+	{
+		PlannerAction.PreConditions = SpectrPlanner::MakeCondition(TagBits, PlannerAction.Action->PreConditions);
+		PlannerAction.Effects = SpectrPlanner::MakeCondition(TagBits, PlannerAction.Action->Effects);
+
+		const int32 GoalBits = FMath::CountBits(PlannerAction.Effects.Mask & GoalCondition.Mask);
+		MaxGoalBitsPerAction = FMath::Max(MaxGoalBitsPerAction, GoalBits);
+		MinActionCost = FMath::Min(MinActionCost, PlannerAction.Cost);
+	}
+	if (Actions.Num() == 0)
+	{
+		MinActionCost = 0;
+	}
+
+	StartState = SpectrPlanner::MakeCondition(TagBits, InCurrentState).Apply(FSpectrWorldState());
+	bValid = true;
+	return true;
+}
+
+bool FSpectrPlanSnapshot::IsSameProblem(const FSpectrPlanSnapshot& Other) const
+{
+	if (bValid != Other.bValid
+		|| !(StartState == Other.StartState)
+		|| !(GoalCondition == Other.GoalCondition)
+		|| Actions.Num() != Other.Actions.Num())
+	{
+		return false;
+	}
+	for (int32 Idx = 0; Idx < Actions.Num(); Idx++)
+	{
+		const FSpectrPlannerAction& A = Actions[Idx];
+		const FSpectrPlannerAction& B = Other.Actions[Idx];
+		if (A.Cost != B.Cost
+			|| !(A.PreConditions == B.PreConditions)
+			|| !(A.Effects == B.Effects))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FSpectrPlanner::Reset()
+{
+	Nodes.Reset();
+	OpenNodes.Reset();
+	ClosedNodes.Reset();
+}
+
+int32 FSpectrPlanner::AddNode(const FSpectrPlanSnapshot& InSnapshot, const FSpectrWorldState& InState, int32 InParent, int32 InAction, int32 InCost, float InScore)
+{
+	FSpectrPlanNode Node;
+	Node.State = InState;
+	Node.Parent = InParent;
+	Node.Action = InAction;
+	Node.Cost = InCost;
+	Node.EstimatedCost = InCost + SpectrPlanner::Heuristic(InSnapshot, InState);
+	Node.Score = InScore;
+	return Nodes.Add(Node);
+}
+
+bool FSpectrPlanner::Plan(const TMap<FGameplayTag, bool>& InGoal
+	, const TMap<FGameplayTag, bool>& InCurrentState
+	, const TArray<USpectrAction*>& InActions
+	, class USpectrContext* InContext
+	, class AAIController* AIController
+	, TArray<USpectrAction*>& OutPlan)
+{
+	OutPlan.Reset();
+
+	FSpectrPlanSnapshot Snapshot;
+	if (!Snapshot.Build(InGoal, InCurrentState, InActions, InContext, AIController))
+		return false;
+
+	TArray<int32> ActionIdxs;
+	if (!Search(Snapshot, ActionIdxs))
+		return false;
+
+	for (int32 ActionIdx : ActionIdxs)
+	{
+		OutPlan.Add(Snapshot.Actions[ActionIdx].Action);
+	}
+	return true;
+}
+
+bool FSpectrPlanner::Search(const FSpectrPlanSnapshot& InSnapshot, TArray<int32>& OutPlan)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SpectrPlan);
+	OutPlan.Reset();
+	Reset();
+
+	if (!InSnapshot.bValid)
+		return false;
+
+	const TArray<FSpectrPlannerAction>& PlannerActions = InSnapshot.Actions;
+	const FSpectrStateCondition& GoalCondition = InSnapshot.GoalCondition;
+	const FSpectrWorldState& StartState = InSnapshot.StartState;
+
+	FSpectrOpenNodePredicate Predicate(Nodes);
+	OpenNodes.HeapPush(AddNode(InSnapshot, StartState, INDEX_NONE, INDEX_NONE, 0, 0), Predicate);
+	ClosedNodes.Add(StartState, 0);
+
+	int32 Expanded = 0;
+	int32 GoalNode = INDEX_NONE;
+	while (OpenNodes.Num() && Expanded < MaxExpandedNodes)
+	{
+		int32 CurrentIdx = INDEX_NONE;
+		OpenNodes.HeapPop(CurrentIdx, Predicate, false);
+
+		//stale entry, state has been reached cheaper trough other node.
+		const FSpectrPlanNode Current = Nodes[CurrentIdx];
+		if (Current.Cost > ClosedNodes.FindChecked(Current.State))
+			continue;
+
+		if (GoalCondition.IsSatisfied(Current.State))
+		{
+			GoalNode = CurrentIdx;
+			break;
+		}
+		Expanded++;
+
+		for (int32 ActionIdx = 0; ActionIdx < PlannerActions.Num(); ActionIdx++)
+		{
+			const FSpectrPlannerAction& PlannerAction = PlannerActions[ActionIdx];
+			if (!PlannerAction.PreConditions.IsSatisfied(Current.State))
+				continue;
+
+			const FSpectrWorldState NewState = PlannerAction.Effects.Apply(Current.State);
+			if (NewState == Current.State)
+				continue;
+
+			const int32 NewCost = Current.Cost + PlannerAction.Cost;
+			const int32* BestCost = ClosedNodes.Find(NewState);
+			if (BestCost && NewCost >= *BestCost)
+				continue;
+
+			ClosedNodes.Add(NewState, NewCost);
+			OpenNodes.HeapPush(AddNode(InSnapshot, NewState, CurrentIdx, ActionIdx, NewCost, Current.Score + PlannerAction.Score), Predicate);
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_SpectrExpandedNodes, Expanded);
+
+	if (GoalNode == INDEX_NONE)
+		return false;
+
+	//walk back from goal, so plan ends up ordered from last action to first.
+	for (int32 NodeIdx = GoalNode; Nodes[NodeIdx].Parent != INDEX_NONE; NodeIdx = Nodes[NodeIdx].Parent)
+	{
+		OutPlan.Add(Nodes[NodeIdx].Action);
+	}
+	return true;
+}
@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTags.h"
+#include "GameplayTagContainer.h"
+
+DECLARE_STATS_GROUP(TEXT("SpectrAI"), STATGROUP_SpectrAI, STATCAT_Advanced);
+
+class USpectrAction;
+
+/*
+	World state packed into bits. Every tag used by planned goal, current state and actions
+	gets single bit. Tags which are not set in state are false.
+*/
+struct FSpectrWorldState
+{
+	uint64 Values;
+
+	FSpectrWorldState()
+		: Values(0)
+	{}
+	explicit FSpectrWorldState(uint64 InValues)
+		: Values(InValues)
+	{}
+
+	bool operator==(const FSpectrWorldState& Other) const
+	{
+		return Values == Other.Values;
+	}
+	friend uint32 GetTypeHash(const FSpectrWorldState& InState)
+	{
+		return GetTypeHash(InState.Values);
+	}
+};
+
+/*
+	Set of required (or applied) tag values. Only bits in Mask are considered.
+*/
+struct FSpectrStateCondition
+{
+	uint64 Mask;
+	uint64 Values;
+
+	FSpectrStateCondition()
+		: Mask(0)
+		, Values(0)
+	{}
+
+	inline bool IsSatisfied(const FSpectrWorldState& InState) const
+	{
+		return ((InState.Values ^ Values) & Mask) == 0;
+	}
+	inline FSpectrWorldState Apply(const FSpectrWorldState& InState) const
+	{
+		return FSpectrWorldState((InState.Values & ~Mask) | (Values & Mask));
+	}
+	/* Number of masked bits which differ from InState. */
+	inline int32 CountUnsatisfied(const FSpectrWorldState& InState) const
+	{
+		return FMath::CountBits((InState.Values ^ Values) & Mask);
+	}
+	bool operator==(const FSpectrStateCondition& Other) const
+	{
+		return Mask == Other.Mask && Values == Other.Values;
+	}
+};
+
+/* Action converted to bit conditions for single plan. */
+struct FSpectrPlannerAction
+{
+	USpectrAction* Action;
+	FSpectrStateCondition PreConditions;
+	FSpectrStateCondition Effects;
+	int32 Cost;
+	/* Used only to break ties between equally cheap plans. */
+	float Score;
+};
+
+/* Single step in search. Stored by value in planner arena, linked trough indexes. */
+struct FSpectrPlanNode
+{
+	FSpectrWorldState State;
+	int32 Parent;
+	int32 Action;
+	/* Cost from start. */
+	int32 Cost;
+	/* Cost + heuristic. */
+	int32 EstimatedCost;
+	float Score;
+};
+
+/*
+	Immutable input of single search. Action conditions and scores can call into blueprint,
+	so snapshot is built on game thread. After that it only contains plain data and
+	can be searched on any thread. Action pointers are only used to map result back on game thread.
+*/
+struct SPECTRAI_API FSpectrPlanSnapshot
+{
+	TArray<FSpectrPlannerAction> Actions;
+	FSpectrStateCondition GoalCondition;
+	FSpectrWorldState StartState;
+	/* Heuristic parameters. Most goal bits single action can change, and cheapest action cost. */
+	int32 MaxGoalBitsPerAction;
+	int32 MinActionCost;
+	/* False if inputs use more tags than planner can pack. */
+	bool bValid;
+
+	FSpectrPlanSnapshot()
+		: MaxGoalBitsPerAction(0)
+		, MinActionCost(0)
+		, bValid(false)
+	{}
+
+	/* Build snapshot from current agent state. Must be called on game thread. */
+	bool Build(const TMap<FGameplayTag, bool>& InGoal
+		, const TMap<FGameplayTag, bool>& InCurrentState
+		, const TArray<USpectrAction*>& InActions
+		, class USpectrContext* InContext
+		, class AAIController* AIController);
+
+	/* True if searching both snapshots must end with the same plan cost. Scores are ignored. */
+	bool IsSameProblem(const FSpectrPlanSnapshot& Other) const;
+};
+
+/*
+	Forward A* planner over packed world states.
+
+	Open list is binary heap of node indexes, closed set is hashed by state,
+	and nodes are kept in array which is reused between plans, so planning does not allocate
+	once it is warmed up.
+
+	Search only reads snapshot and planner's own arena, so it can run on worker thread,
+	as long as single planner is not used by two searches at once.
+*/
+struct SPECTRAI_API FSpectrPlanner
+{
+	static constexpr int32 MaxTags = 64;
+
+	/* Search gives up after expanding that many nodes. */
+	int32 MaxExpandedNodes;
+
+	FSpectrPlanner()
+		: MaxExpandedNodes(4096)
+	{}
+
+	/*
+		Find cheapest sequence of actions leading from InCurrentState to InGoal.
+		OutPlan is filled from last action to first one. Returns false if there is no plan.
+	*/
+	bool Plan(const TMap<FGameplayTag, bool>& InGoal
+		, const TMap<FGameplayTag, bool>& InCurrentState
+		, const TArray<USpectrAction*>& InActions
+		, class USpectrContext* InContext
+		, class AAIController* AIController
+		, TArray<USpectrAction*>& OutPlan);
+
+	/*
+		Thread safe part of planning. OutPlan contains indexes to InSnapshot.Actions,
+		ordered from last action to first one. Returns false if there is no plan.
+	*/
+	bool Search(const FSpectrPlanSnapshot& InSnapshot, TArray<int32>& OutPlan);
+
+private:
+	TArray<FSpectrPlanNode> Nodes;
+	TArray<int32> OpenNodes;
+	/* Cheapest known cost to reach state. */
+	TMap<FSpectrWorldState, int32> ClosedNodes;
+
+	void Reset();
+	int32 AddNode(const FSpectrPlanSnapshot& InSnapshot, const FSpectrWorldState& InState, int32 InParent, int32 InAction, int32 InCost, float InScore);
+};
+
+/*
+	Planner work item used by async planning. Owned trough shared pointer by both requesting agent
+	and running task, so agent can be destroyed while search is still running.
+	Reused by agent between plans, to keep search arena warm.
+*/
+struct FSpectrPlanJob
+{
+	FSpectrPlanSnapshot Snapshot;
+	FSpectrPlanner Planner;
+	/* Indexes to Snapshot.Actions, from last action to first one. */
+	TArray<int32> Result;
+	bool bFound;
+
+	FSpectrPlanJob()
+		: bFound(false)
+	{}
+};
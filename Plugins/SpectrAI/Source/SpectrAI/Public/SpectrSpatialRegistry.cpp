@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpectrSpatialRegistry.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+TMap<FObjectKey, TUniquePtr<FSpectrSpatialRegistry>> FSpectrSpatialRegistry::Registries;
+
+FSpectrSpatialRegistry& FSpectrSpatialRegistry::Get(UWorld* InWorld)
+{
+	check(InWorld);
+	TUniquePtr<FSpectrSpatialRegistry>& Registry = Registries.FindOrAdd(FObjectKey(InWorld));
+	if (!Registry.IsValid())
+	{
+		Registry = MakeUnique<FSpectrSpatialRegistry>();
+	}
+	return *Registry;
+}
+
+FSpectrSpatialRegistry* FSpectrSpatialRegistry::Find(UWorld* InWorld)
+{
+	TUniquePtr<FSpectrSpatialRegistry>* Registry = Registries.Find(FObjectKey(InWorld));
+	return Registry ? Registry->Get() : nullptr;
+}
+
+void FSpectrSpatialRegistry::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	Registries.Remove(FObjectKey(InWorld));
+}
+
+void FSpectrSpatialRegistry::Shutdown()
+{
+	Registries.Empty();
+}
+
+FSpectrSpatialRegistry::FSpectrSpatialRegistry(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+	, FreeEntry(INDEX_NONE)
+{
+}
+
+void FSpectrSpatialRegistry::LinkCell(FSpectrSpatialGrid& Grid, int32 EntryIdx)
+{
+	FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+	int32* CellHeadPtr = Grid.Cells.Find(Entry.Cell);
+	if (!CellHeadPtr)
+	{
+		CellHeadPtr = &Grid.Cells.Add(Entry.Cell, INDEX_NONE);
+	}
+	int32& CellHead = *CellHeadPtr;
+	Entry.CellPrev = INDEX_NONE;
+	Entry.CellNext = CellHead;
+	if (CellHead != INDEX_NONE)
+	{
+		Entries[CellHead].CellPrev = EntryIdx;
+	}
+	CellHead = EntryIdx;
+
+	Grid.MinCell.X = FMath::Min(Grid.MinCell.X, Entry.Cell.X);
+	Grid.MinCell.Y = FMath::Min(Grid.MinCell.Y, Entry.Cell.Y);
+	Grid.MaxCell.X = FMath::Max(Grid.MaxCell.X, Entry.Cell.X);
+	Grid.MaxCell.Y = FMath::Max(Grid.MaxCell.Y, Entry.Cell.Y);
+}
+
+void FSpectrSpatialRegistry::UnlinkCell(FSpectrSpatialGrid& Grid, int32 EntryIdx)
+{
+	FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+	if (Entry.CellPrev != INDEX_NONE)
+	{
+		Entries[Entry.CellPrev].CellNext = Entry.CellNext;
+	}
+	else if (Entry.CellNext != INDEX_NONE)
+	{
+		Grid.Cells.FindChecked(Entry.Cell) = Entry.CellNext;
+	}
+	else
+	{
+		Grid.Cells.Remove(Entry.Cell);
+	}
+	if (Entry.CellNext != INDEX_NONE)
+	{
+		Entries[Entry.CellNext].CellPrev = Entry.CellPrev;
+	}
+	Entry.CellPrev = INDEX_NONE;
+	Entry.CellNext = INDEX_NONE;
+}
+
+void FSpectrSpatialRegistry::Register(AActor* InActor)
+{
+	if (!InActor)
+		return;
+	if (EntryByActor.Contains(FObjectKey(InActor)))
+	{
+		UpdateLocation(InActor);
+		return;
+	}
+
+	int32 EntryIdx = FreeEntry;
+	if (EntryIdx != INDEX_NONE)
+	{
+		FreeEntry = Entries[EntryIdx].CellNext;
+		Entries[EntryIdx] = FSpectrSpatialEntry();
+	}
+	else
+	{
+		EntryIdx = Entries.AddDefaulted();
+	}
+
+	UClass* Class = InActor->GetClass();
+	FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+	Entry.Actor = InActor;
+	Entry.Class = Class;
+	Entry.Location = InActor->GetActorLocation();
+	Entry.Cell = GetCell(Entry.Location);
+
+	FSpectrSpatialGrid& Grid = Grids.FindOrAdd(Class);
+	Entry.ClassNext = Grid.Head;
+	if (Grid.Head != INDEX_NONE)
+	{
+		Entries[Grid.Head].ClassPrev = EntryIdx;
+	}
+	Grid.Head = EntryIdx;
+	LinkCell(Grid, EntryIdx);
+	Grid.Num++;
+
+	EntryByActor.Add(FObjectKey(InActor), EntryIdx);
+}
+
+void FSpectrSpatialRegistry::Unregister(AActor* InActor)
+{
+	int32 EntryIdx = INDEX_NONE;
+	if (!EntryByActor.RemoveAndCopyValue(FObjectKey(InActor), EntryIdx))
+		return;
+
+	FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+	UClass* Class = Entry.Class;
+	FSpectrSpatialGrid& Grid = Grids.FindChecked(Class);
+	UnlinkCell(Grid, EntryIdx);
+
+	if (Entry.ClassPrev != INDEX_NONE)
+	{
+		Entries[Entry.ClassPrev].ClassNext = Entry.ClassNext;
+	}
+	else
+	{
+		Grid.Head = Entry.ClassNext;
+	}
+	if (Entry.ClassNext != INDEX_NONE)
+	{
+		Entries[Entry.ClassNext].ClassPrev = Entry.ClassPrev;
+	}
+	Grid.Num--;
+	if (Grid.Num == 0)
+	{
+		Grids.Remove(Class);
+	}
+
+	//free entries are chained through CellNext.
+	Entry = FSpectrSpatialEntry();
+	Entry.CellNext = FreeEntry;
+	FreeEntry = EntryIdx;
+}
+
+void FSpectrSpatialRegistry::UpdateLocation(AActor* InActor)
+{
+	const int32* EntryIdx = EntryByActor.Find(FObjectKey(InActor));
+	if (!EntryIdx)
+		return;
+
+	FSpectrSpatialEntry& Entry = Entries[*EntryIdx];
+	Entry.Location = InActor->GetActorLocation();
+	const FIntPoint NewCell = GetCell(Entry.Location);
+	if (NewCell == Entry.Cell)
+		return;
+
+	FSpectrSpatialGrid& Grid = Grids.FindChecked(Entry.Class);
+	UnlinkCell(Grid, *EntryIdx);
+	Entry.Cell = NewCell;
+	LinkCell(Grid, *EntryIdx);
+}
+
+void FSpectrSpatialRegistry::VisitCell(const FSpectrSpatialGrid& Grid, const FIntPoint& InCell, const FVector& InOrigin
+	, float& InOutBestDistSq, AActor*& InOutBest) const
+{
+	const int32* CellHead = Grid.Cells.Find(InCell);
+	if (!CellHead)
+		return;
+
+	for (int32 EntryIdx = *CellHead; EntryIdx != INDEX_NONE; EntryIdx = Entries[EntryIdx].CellNext)
+	{
+		const FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+		const float DistSq = FVector::DistSquared(Entry.Location, InOrigin);
+		if (DistSq >= InOutBestDistSq)
+			continue;
+		if (AActor* Actor = Entry.Actor.Get())
+		{
+			InOutBestDistSq = DistSq;
+			InOutBest = Actor;
+		}
+	}
+}
+
+void FSpectrSpatialRegistry::FindNearestInGrid(const FSpectrSpatialGrid& Grid, const FVector& InOrigin, float InMaxRadius
+	, float& InOutBestDistSq, AActor*& InOutBest) const
+{
+	if (Grid.Num <= LinearScanNum)
+	{
+		for (int32 EntryIdx = Grid.Head; EntryIdx != INDEX_NONE; EntryIdx = Entries[EntryIdx].ClassNext)
+		{
+			const FSpectrSpatialEntry& Entry = Entries[EntryIdx];
+			const float DistSq = FVector::DistSquared(Entry.Location, InOrigin);
+			if (DistSq >= InOutBestDistSq)
+				continue;
+			if (AActor* Actor = Entry.Actor.Get())
+			{
+				InOutBestDistSq = DistSq;
+				InOutBest = Actor;
+			}
+		}
+		return;
+	}
+
+	//walk rings of cells around origin, until nothing closer can be in next ring.
+	const FIntPoint Center = GetCell(InOrigin);
+	int32 MaxRing = FMath::Max(
+		FMath::Max(Center.X - Grid.MinCell.X, Grid.MaxCell.X - Center.X),
+		FMath::Max(Center.Y - Grid.MinCell.Y, Grid.MaxCell.Y - Center.Y));
+	if (InMaxRadius > 0)
+	{
+		MaxRing = FMath::Min(MaxRing, FMath::CeilToInt(InMaxRadius / CellSize) + 1);
+	}
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		if (Ring == 0)
+		{
+			VisitCell(Grid, Center, InOrigin, InOutBestDistSq, InOutBest);
+		}
+		else
+		{
+			const int32 MinX = FMath::Max(Center.X - Ring, Grid.MinCell.X);
+			const int32 MaxX = FMath::Min(Center.X + Ring, Grid.MaxCell.X);
+			const int32 MinY = FMath::Max(Center.Y - Ring + 1, Grid.MinCell.Y);
+			const int32 MaxY = FMath::Min(Center.Y + Ring - 1, Grid.MaxCell.Y);
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				VisitCell(Grid, FIntPoint(X, Center.Y - Ring), InOrigin, InOutBestDistSq, InOutBest);
+				VisitCell(Grid, FIntPoint(X, Center.Y + Ring), InOrigin, InOutBestDistSq, InOutBest);
+			}
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				VisitCell(Grid, FIntPoint(Center.X - Ring, Y), InOrigin, InOutBestDistSq, InOutBest);
+				VisitCell(Grid, FIntPoint(Center.X + Ring, Y), InOrigin, InOutBestDistSq, InOutBest);
+			}
+		}
+		//every cell in next ring is at least Ring cells away from origin.
+		const float NextRingDist = Ring * CellSize;
+		if (InOutBestDistSq <= NextRingDist * NextRingDist)
+			break;
+	}
+}
+
+AActor* FSpectrSpatialRegistry::FindNearest(UClass* InClass, const FVector& InOrigin, float InMaxRadius) const
+{
+	AActor* Best = nullptr;
+	float BestDistSq = InMaxRadius > 0 ? FMath::Square(InMaxRadius) : MAX_flt;
+	for (const TPair<UClass*, FSpectrSpatialGrid>& Grid : Grids)
+	{
+		if (!Grid.Key->IsChildOf(InClass))
+			continue;
+		FindNearestInGrid(Grid.Value, InOrigin, InMaxRadius, BestDistSq, Best);
+	}
+	return Best;
+}
+
+void FSpectrSpatialRegistry::FindInRadius(UClass* InClass, const FVector& InOrigin, float InRadius, TArray<AActor*>& OutActors) const
+{
+	const float RadiusSq = FMath::Square(InRadius);
+	const FIntPoint RangeMin = GetCell(InOrigin - FVector(InRadius));
+	const FIntPoint RangeMax = GetCell(InOrigin + FVector(InRadius));
+
+	for (const TPair<UClass*, FSpectrSpatialGrid>& GridPair : Grids)
+	{
+		if (!GridPair.Key->IsChildOf(InClass))
+			continue;
+
+		const FSpectrSpatialGrid& Grid = GridPair.Value;
+		auto AddEntry = [&](const FSpectrSpatialEntry& Entry)
+		{
+			if (FVector::DistSquared(Entry.Location, InOrigin) > RadiusSq)
+				return;
+			if (AActor* Actor = Entry.Actor.Get())
+			{
+				OutActors.Add(Actor);
+			}
+		};
+
+		if (Grid.Num <= LinearScanNum)
+		{
+			for (int32 EntryIdx = Grid.Head; EntryIdx != INDEX_NONE; EntryIdx = Entries[EntryIdx].ClassNext)
+			{
+				AddEntry(Entries[EntryIdx]);
+			}
+			continue;
+		}
+
+		for (int32 X = FMath::Max(RangeMin.X, Grid.MinCell.X); X <= FMath::Min(RangeMax.X, Grid.MaxCell.X); X++)
+		{
+			for (int32 Y = FMath::Max(RangeMin.Y, Grid.MinCell.Y); Y <= FMath::Min(RangeMax.Y, Grid.MaxCell.Y); Y++)
+			{
+				const int32* CellHead = Grid.Cells.Find(FIntPoint(X, Y));
+				if (!CellHead)
+					continue;
+				for (int32 EntryIdx = *CellHead; EntryIdx != INDEX_NONE; EntryIdx = Entries[EntryIdx].CellNext)
+				{
+					AddEntry(Entries[EntryIdx]);
+				}
+			}
+		}
+	}
+}
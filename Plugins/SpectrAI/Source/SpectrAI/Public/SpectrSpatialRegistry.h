@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class UWorld;
+
+/* Registered actor. Linked into list of its cell and list of its class. */
+struct FSpectrSpatialEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+	UClass* Class;
+	FVector Location;
+	FIntPoint Cell;
+	int32 CellPrev;
+	int32 CellNext;
+	int32 ClassPrev;
+	int32 ClassNext;
+
+	FSpectrSpatialEntry()
+		: Class(nullptr)
+		, Location(FVector::ZeroVector)
+		, Cell(FIntPoint::ZeroValue)
+		, CellPrev(INDEX_NONE)
+		, CellNext(INDEX_NONE)
+		, ClassPrev(INDEX_NONE)
+		, ClassNext(INDEX_NONE)
+	{}
+};
+
+/* Uniform grid over XY plane for single actor class. */
+struct FSpectrSpatialGrid
+{
+	/* Cell -> first entry in cell. */
+	TMap<FIntPoint, int32> Cells;
+	/* First entry of this class. */
+	int32 Head;
+	int32 Num;
+	/* Cells which ever had entry in them. Searches never leave these bounds. */
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+
+	FSpectrSpatialGrid()
+		: Head(INDEX_NONE)
+		, Num(0)
+		, MinCell(MAX_int32, MAX_int32)
+		, MaxCell(MIN_int32, MIN_int32)
+	{}
+};
+
+/*
+	Per world registry of interactable actors, used by actions to find their targets.
+	Actors are bucketed by exact class into uniform grids, so queries only visit nearby cells of classes
+	they are asking for, instead of iterating every actor in world.
+
+	Game thread only.
+*/
+class SPECTRAI_API FSpectrSpatialRegistry
+{
+	static TMap<FObjectKey, TUniquePtr<FSpectrSpatialRegistry>> Registries;
+
+	/* Below that number of entries, class is scanned linearly instead of walking cells. */
+	static constexpr int32 LinearScanNum = 16;
+
+	float CellSize;
+	TArray<FSpectrSpatialEntry> Entries;
+	int32 FreeEntry;
+	TMap<FObjectKey, int32> EntryByActor;
+	TMap<UClass*, FSpectrSpatialGrid> Grids;
+
+public:
+	static FSpectrSpatialRegistry& Get(UWorld* InWorld);
+	/* Does not create registry, returns nullptr if world has none. */
+	static FSpectrSpatialRegistry* Find(UWorld* InWorld);
+	static void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+	static void Shutdown();
+
+	explicit FSpectrSpatialRegistry(float InCellSize = 2000.0f);
+
+	void Register(AActor* InActor);
+	void Unregister(AActor* InActor);
+	/* Call after registered actor has been moved. */
+	void UpdateLocation(AActor* InActor);
+
+	/*
+		Nearest registered actor which is InClass or it's child.
+		InMaxRadius <= 0 means there is no limit.
+	*/
+	AActor* FindNearest(UClass* InClass, const FVector& InOrigin, float InMaxRadius = 0) const;
+	/* All registered actors of InClass (or it's children) within InRadius. */
+	void FindInRadius(UClass* InClass, const FVector& InOrigin, float InRadius, TArray<AActor*>& OutActors) const;
+
+	template<typename T>
+	T* FindNearest(const FVector& InOrigin, float InMaxRadius = 0) const
+	{
+		return static_cast<T*>(FindNearest(T::StaticClass(), InOrigin, InMaxRadius));
+	}
+
+	inline int32 Num() const { return EntryByActor.Num(); }
+
+private:
+	inline FIntPoint GetCell(const FVector& InLocation) const
+	{
+		return FIntPoint(FMath::FloorToInt(InLocation.X / CellSize), FMath::FloorToInt(InLocation.Y / CellSize));
+	}
+	void LinkCell(FSpectrSpatialGrid& Grid, int32 EntryIdx);
+	void UnlinkCell(FSpectrSpatialGrid& Grid, int32 EntryIdx);
+
+	/* Nearest valid entry in single grid closer than InOutBestDistSq. */
+	void FindNearestInGrid(const FSpectrSpatialGrid& Grid, const FVector& InOrigin, float InMaxRadius
+		, float& InOutBestDistSq, AActor*& InOutBest) const;
+	void VisitCell(const FSpectrSpatialGrid& Grid, const FIntPoint& InCell, const FVector& InOrigin
+		, float& InOutBestDistSq, AActor*& InOutBest) const;
+};
@@ -4,7 +4,7 @@
 #include "AIController.h"
 #include "SpectrBrainComponent.h"
 #include "STestTree.h"
-#include "EngineUtils.h"
+#include "SpectrSpatialRegistry.h"
 
 bool USTestAction_ChopFirewood::NativeIsInRange(class AAIController* AIController)
 {
@@ -43,12 +43,8 @@ void USTestAction_ChopFirewood::NativeOnMoveFinished(class USpectrContext* InCon
 
 bool USTestAction_ChopFirewood::NativeEvaluateCondition(class USpectrContext* InContext, class AAIController* AIController)
 {
-	bool bFound = false;
-	for (TActorIterator<ASTestTree> ActorIt(AIController->GetWorld()); ActorIt; ++ActorIt)
-	{
-		TargetTree = *ActorIt;
-		bFound = true;
-		break;
-	}
-	return bFound;
+	APawn* Pawn = AIController->GetPawn();
+	const FVector Origin = Pawn ? Pawn->GetActorLocation() : AIController->GetActorLocation();
+	TargetTree = FSpectrSpatialRegistry::Get(AIController->GetWorld()).FindNearest<ASTestTree>(Origin);
+	return TargetTree != nullptr;
 }
\ No newline at end of file
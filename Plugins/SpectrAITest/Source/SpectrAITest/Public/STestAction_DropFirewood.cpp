@@ -4,7 +4,7 @@
 #include "AIController.h"
 #include "SpectrBrainComponent.h"
 #include "STestStorage.h"
-#include "EngineUtils.h"
+#include "SpectrSpatialRegistry.h"
 
 bool USTestAction_DropFirewood::NativeIsInRange(class AAIController* AIController)
 {
@@ -41,12 +41,8 @@ void USTestAction_DropFirewood::NativeExecute(class USpectrContext* InContext
 
 bool USTestAction_DropFirewood::NativeEvaluateCondition(class USpectrContext* InContext, class AAIController* AIController)
 {
-	bool bFound = false;
-	for (TActorIterator<ASTestStorage> ActorIt(AIController->GetWorld()); ActorIt; ++ActorIt)
-	{
-		TargetDropPoint = *ActorIt;
-		bFound = true;
-		break;
-	}
-	return bFound;
+	APawn* Pawn = AIController->GetPawn();
+	const FVector Origin = Pawn ? Pawn->GetActorLocation() : AIController->GetActorLocation();
+	TargetDropPoint = FSpectrSpatialRegistry::Get(AIController->GetWorld()).FindNearest<ASTestStorage>(Origin);
+	return TargetDropPoint != nullptr;
 }
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "AIController.h"
 #include "SpectrBrainComponent.h"
 #include "STestAxePickup.h"
-#include "EngineUtils.h"
+#include "SpectrSpatialRegistry.h"
 
 bool USTestAction_PickItemAxe::NativeIsInRange(class AAIController* AIController)
 {
@@ -41,12 +41,8 @@ void USTestAction_PickItemAxe::NativeExecute(class USpectrContext* InContext
 
 bool USTestAction_PickItemAxe::NativeEvaluateCondition(class USpectrContext* InContext, class AAIController* AIController)
 {
-	bool bFound = false;
-	for (TActorIterator<ASTestAxePickup> ActorIt(AIController->GetWorld()); ActorIt; ++ActorIt)
-	{
-		TargetItem = *ActorIt;
-		bFound = true;
-		break;
-	}
-	return bFound;
+	APawn* Pawn = AIController->GetPawn();
+	const FVector Origin = Pawn ? Pawn->GetActorLocation() : AIController->GetActorLocation();
+	TargetItem = FSpectrSpatialRegistry::Get(AIController->GetWorld()).FindNearest<ASTestAxePickup>(Origin);
+	return TargetItem != nullptr;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "STestStorage.h"
+#include "SpectrInteractableComponent.h"
 
 
 // Sets default values
@@ -9,6 +10,7 @@ ASTestStorage::ASTestStorage()
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	Interactable = CreateDefaultSubobject<USpectrInteractableComponent>(TEXT("Interactable"));
 }
 
 // Called when the game starts or when spawned
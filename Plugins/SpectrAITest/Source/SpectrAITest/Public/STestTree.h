@@ -12,6 +12,10 @@ class SPECTRAITEST_API ASTestTree : public AActor
 	GENERATED_BODY()
 	
 public:	
+	/* Makes actor discoverable by actions through FSpectrSpatialRegistry. */
+	UPROPERTY(VisibleAnywhere)
+		class USpectrInteractableComponent* Interactable;
+
 	// Sets default values for this actor's properties
 	ASTestTree();
 
@@ -542,12 +542,8 @@ void FWALandscapeGraphAssetEditor::GraphSettings()
 
 void FWALandscapeGraphAssetEditor::GenerateLandscape()
 {
-	
-	if (const UWALandscapeGraphSchema* Schema = Cast<UWALandscapeGraphSchema>(EditingGraph->EdGraph->GetSchema()))
-	{
-		TArray<uint16> out;
-		Schema->Output->GenerateHeightMap(out);
-	}
+	//only nodes changed since last generation are evaluated again.
+	EditingGraph->GenerateLandscape();
 	//LOG_WARNING(TEXT("FWALandscapeGraphAssetEditor::GraphSettings"));
 }
 
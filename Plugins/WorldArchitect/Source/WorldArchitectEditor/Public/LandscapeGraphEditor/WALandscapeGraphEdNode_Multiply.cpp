@@ -23,6 +23,8 @@ void UWALandscapeGraphEdNode_Multiply::PinConnectionListChanged(UEdGraphPin* Pin
 	{
 		if (Pin->PinType.PinCategory == UWALandscapeGraphEditorTypes::PinCategory_InputA)
 		{
+			//stays cleared if link has been broken.
+			ThisNode->InputA = nullptr;
 			//InputNode = Cast<UWALandscapeGraphEdNode_Output>(Pin->GetOwningNode());
 			for (UEdGraphPin* LinkedPin : Pin->LinkedTo)
 			{
@@ -41,6 +43,7 @@ void UWALandscapeGraphEdNode_Multiply::PinConnectionListChanged(UEdGraphPin* Pin
 		}
 		else if (Pin->PinType.PinCategory == UWALandscapeGraphEditorTypes::PinCategory_InputB)
 		{
+			ThisNode->InputB = nullptr;
 			for (UEdGraphPin* LinkedPin : Pin->LinkedTo)
 			{
 				if (LinkedPin->Direction == EEdGraphPinDirection::EGPD_Output
@@ -57,6 +60,7 @@ void UWALandscapeGraphEdNode_Multiply::PinConnectionListChanged(UEdGraphPin* Pin
 				}
 			}
 		}
+		ThisNode->MarkDirty();
 	}
 	else if (Pin->Direction == EEdGraphPinDirection::EGPD_Output)
 	{
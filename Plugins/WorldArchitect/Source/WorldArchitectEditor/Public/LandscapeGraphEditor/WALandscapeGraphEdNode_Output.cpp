@@ -19,6 +19,12 @@ void UWALandscapeGraphEdNode_Output::PinConnectionListChanged(UEdGraphPin* Pin)
 		if (Pin->PinType.PinCategory == UWALandscapeGraphEditorTypes::PinCategory_FinalInput)
 		{
 			InputNode = Cast<UWALandscapeGraphEdNode_Output>(Pin->GetOwningNode());
+			if (UWALandscapeNode_Output* ThisNode = Cast<UWALandscapeNode_Output>(InputNode->GenericGraphNode))
+			{
+				//stays cleared if link has been broken.
+				ThisNode->Heightmap = nullptr;
+				ThisNode->MarkDirty();
+			}
 			for (UEdGraphPin* LinkedPin : Pin->LinkedTo)
 			{
 				if (LinkedPin->Direction == EEdGraphPinDirection::EGPD_Output)
@@ -5,6 +5,8 @@
 UWALandscapeGraph::UWALandscapeGraph()
 {
 	NodeType = UWALandscapeNode::StaticClass();
+	SizeX = 505;
+	SizeY = 505;
 
 #if WITH_EDITORONLY_DATA
 	EdGraph = nullptr;
@@ -19,8 +21,21 @@ UWALandscapeGraph::~UWALandscapeGraph()
 void UWALandscapeGraph::ClearGraph()
 {
 }
-void UWALandscapeGraph::GenerateLandscape()
+const TArray<uint16>& UWALandscapeGraph::GenerateLandscape()
 {
-
+	return Evaluator.Evaluate(LandscapeOutput);
+}
+#if WITH_EDITOR
+void UWALandscapeGraph::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+	//size affects every generator.
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UWALandscapeGraph, SizeX)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(UWALandscapeGraph, SizeY))
+	{
+		Evaluator.MarkAllDirty(LandscapeOutput);
+	}
 }
+#endif
 #undef LOCTEXT_NAMESPACE
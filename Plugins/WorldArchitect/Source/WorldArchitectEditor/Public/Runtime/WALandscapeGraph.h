@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WALandscapeNode.h"
+#include "WALandscapeGraphEvaluator.h"
 #include "WALandscapeGraph.generated.h"
 
 UCLASS(Blueprintable)
@@ -23,6 +24,12 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "GenericGraph")
 		UWALandscapeNode* LandscapeOutput;
 
+	/* Size of heightmaps generated by nodes. */
+	UPROPERTY(EditAnywhere, Category = "GenericGraph")
+		int32 SizeX;
+	UPROPERTY(EditAnywhere, Category = "GenericGraph")
+		int32 SizeY;
+
 	UPROPERTY(BlueprintReadOnly, Category = "GenericGraph")
 	TArray<UWALandscapeNode*> RootNodes;
 
@@ -36,6 +43,13 @@ public:
 	UPROPERTY()
 	class UWALandscapeGraphSchema* Schema;
 //#endif
-	void GenerateLandscape();
+	/* Shared by all nodes of graph. */
+	FWALandscapeGraphEvaluator Evaluator;
+
+	const TArray<uint16>& GenerateLandscape();
 	void ClearGraph();
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 };
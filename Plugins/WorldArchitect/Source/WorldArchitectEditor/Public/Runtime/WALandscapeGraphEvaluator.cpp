@@ -0,0 +1,117 @@
+#include "WALandscapeGraphEvaluator.h"
+#include "WALandscapeNode.h"
+
+uint32 FWALandscapeGraphEvaluator::VersionCounter = 0;
+
+const TArray<uint16>& FWALandscapeGraphEvaluator::Evaluate(UWALandscapeNode* InTarget)
+{
+	static const TArray<uint16> Empty;
+	if (!InTarget)
+	{
+		return Empty;
+	}
+	//sorting is cheap compared to single node evaluation, so it's done every time
+	//instead of tracking graph edits.
+	Sort(InTarget);
+
+	for (int32 Idx = 0; Idx < SortedNodes.Num(); Idx++)
+	{
+		if (EvaluateNode(Idx))
+		{
+			SortedNodes[Idx]->OnHeightmapReady.Broadcast(*SortedNodes[Idx]->Result);
+		}
+	}
+
+	return InTarget->Result ? *InTarget->Result : Empty;
+}
+
+void FWALandscapeGraphEvaluator::MarkAllDirty(UWALandscapeNode* InTarget)
+{
+	Sort(InTarget);
+	for (UWALandscapeNode* Node : SortedNodes)
+	{
+		Node->MarkDirty();
+	}
+}
+
+void FWALandscapeGraphEvaluator::Sort(UWALandscapeNode* InTarget)
+{
+	SortedNodes.Reset();
+	SortedIndex.Reset();
+	NodesInProgress.Reset();
+	if (InTarget)
+	{
+		Visit(InTarget);
+	}
+}
+
+void FWALandscapeGraphEvaluator::Visit(UWALandscapeNode* InNode)
+{
+	if (SortedIndex.Contains(InNode))
+	{
+		return;
+	}
+	if (NodesInProgress.Contains(InNode))
+	{
+		//input of cycle is treated as not connected.
+		UE_LOG(LogTemp, Warning, TEXT("FWALandscapeGraphEvaluator: cycle in landscape graph at %s"), *InNode->GetName());
+		return;
+	}
+	NodesInProgress.Add(InNode);
+
+	TArray<UWALandscapeNode*> Inputs;
+	InNode->GetInputs(Inputs);
+	for (UWALandscapeNode* Input : Inputs)
+	{
+		if (Input)
+		{
+			Visit(Input);
+		}
+	}
+
+	NodesInProgress.Remove(InNode);
+	//post order, all inputs are already in.
+	SortedIndex.Add(InNode, SortedNodes.Add(InNode));
+}
+
+bool FWALandscapeGraphEvaluator::EvaluateNode(int32 InSortedIdx)
+{
+	UWALandscapeNode* InNode = SortedNodes[InSortedIdx];
+	NodeInputs.Reset();
+	InNode->GetInputs(NodeInputs);
+
+	bool bNeedsEvaluation = InNode->bDirty
+		|| InNode->OutputVersion == 0
+		|| InNode->InputVersions.Num() != NodeInputs.Num();
+
+	InputBuffers.Reset();
+	for (int32 Idx = 0; Idx < NodeInputs.Num(); Idx++)
+	{
+		UWALandscapeNode* Input = NodeInputs[Idx];
+		//input closing cycle comes after this node, it's treated as not connected.
+		const int32* InputIdx = Input ? SortedIndex.Find(Input) : nullptr;
+		const bool bUsable = InputIdx && *InputIdx < InSortedIdx && Input->Result;
+		InputBuffers.Add(bUsable ? Input->Result : nullptr);
+
+		const uint32 InputVersion = bUsable ? Input->OutputVersion : 0;
+		if (!bNeedsEvaluation && InNode->InputVersions[Idx] != InputVersion)
+		{
+			bNeedsEvaluation = true;
+		}
+	}
+
+	if (!bNeedsEvaluation)
+	{
+		return false;
+	}
+
+	InNode->Result = InNode->EvaluateNode(InputBuffers, InNode->CachedHeightmap);
+	InNode->bDirty = false;
+	InNode->OutputVersion = ++VersionCounter;
+	InNode->InputVersions.SetNumUninitialized(NodeInputs.Num());
+	for (int32 Idx = 0; Idx < NodeInputs.Num(); Idx++)
+	{
+		InNode->InputVersions[Idx] = InputBuffers[Idx] ? NodeInputs[Idx]->OutputVersion : 0;
+	}
+	return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWALandscapeNode;
+
+/*
+	Evaluates landscape graph in topological order, inputs before nodes using them.
+	Every node keeps it's last output, and versions of inputs it was computed from, so after editing
+	single node only that node and nodes downstream of it are evaluated again.
+	Buffers are passed between nodes by reference, never copied by evaluator.
+*/
+class WORLDARCHITECTEDITOR_API FWALandscapeGraphEvaluator
+{
+	/* Nodes upstream of last target, in evaluation order. */
+	TArray<UWALandscapeNode*> SortedNodes;
+	/* Node -> index in SortedNodes. */
+	TMap<UWALandscapeNode*, int32> SortedIndex;
+	/* Scratch, reused between evaluations. */
+	TSet<UWALandscapeNode*> NodesInProgress;
+	TArray<UWALandscapeNode*> NodeInputs;
+	TArray<const TArray<uint16>*> InputBuffers;
+
+	/* Incremented on every node evaluation, shared so versions are unique across nodes. */
+	static uint32 VersionCounter;
+
+public:
+	/* Evaluates what changed upstream of InTarget and returns it's output. */
+	const TArray<uint16>& Evaluate(UWALandscapeNode* InTarget);
+
+	/* Marks dirty every node upstream of InTarget. */
+	void MarkAllDirty(UWALandscapeNode* InTarget);
+
+	/* Sorted nodes from last Evaluate or MarkAllDirty. */
+	inline const TArray<UWALandscapeNode*>& GetSortedNodes() const { return SortedNodes; }
+
+private:
+	void Sort(UWALandscapeNode* InTarget);
+	void Visit(UWALandscapeNode* InNode);
+	/* Returns true if node has been evaluated. */
+	bool EvaluateNode(int32 InSortedIdx);
+};
@@ -1,8 +1,12 @@
 #include "WALandscapeNode.h"
 #include "WALandscapeGraph.h"
+#include "WALandscapeGraphEvaluator.h"
 #define LOCTEXT_NAMESPACE "GenericGraphNode"
 
 UWALandscapeNode::UWALandscapeNode()
+	: bDirty(true)
+	, Result(nullptr)
+	, OutputVersion(0)
 {
 	BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 1.0f);
 }
@@ -22,10 +26,34 @@ UWALandscapeGraph* UWALandscapeNode::GetGraph()
 	return Cast<UWALandscapeGraph>(GetOuter());
 }
 
-TArray<uint16> UWALandscapeNode::GenerateHeightmap()
+const TArray<uint16>& UWALandscapeNode::GenerateHeightmap()
 {
-	TArray<uint16> RetVal;
-	return RetVal;
+	if (UWALandscapeGraph* Graph = GetGraph())
+	{
+		return Graph->Evaluator.Evaluate(this);
+	}
+	//node without graph, nothing to share cache with.
+	FWALandscapeGraphEvaluator Evaluator;
+	return Evaluator.Evaluate(this);
 }
 
+void UWALandscapeNode::MarkDirty()
+{
+	bDirty = true;
+}
+
+const TArray<uint16>* UWALandscapeNode::EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out)
+{
+	Out.Reset();
+	return &Out;
+}
+
+#if WITH_EDITOR
+void UWALandscapeNode::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	MarkDirty();
+}
+#endif
+
 #undef LOCTEXT_NAMESPACE
@@ -40,6 +40,37 @@ public:
 	//////////////////////////////////////////////////////////////////////////
 	class UWALandscapeGraph* GetGraph();
 
+	/*
+		Output of this node. Only nodes upstream of this one, which are dirty or have dirty input
+		are evaluated again, rest is served from their caches.
+	*/
+	const TArray<uint16>& GenerateHeightmap();
 
-	virtual TArray<uint16> GenerateHeightmap();
+	/* Forces node to be evaluated again. Nodes downstream of it will follow. */
+	void MarkDirty();
+
+	/* Nodes which output is used by this node. Can contain nullptr for not connected inputs. */
+	virtual void GetInputs(TArray<UWALandscapeNode*>& OutInputs) const {};
+
+	/*
+		Computes output of this node. Inputs are in the same order as GetInputs(), nullptr for not connected ones.
+		Out is this node's own cache, with previous output still in it.
+		Returns buffer holding output, usually &Out, but node can pass one of it's inputs through.
+	*/
+	virtual const TArray<uint16>* EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out);
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	friend class FWALandscapeGraphEvaluator;
+
+	TArray<uint16> CachedHeightmap;
+	/* Buffer returned by last EvaluateNode. */
+	const TArray<uint16>* Result;
+	/* Changes every time node is evaluated. 0 if it never has been. */
+	uint32 OutputVersion;
+	/* Versions of inputs, this node has been evaluated with. */
+	TArray<uint32> InputVersions;
 };
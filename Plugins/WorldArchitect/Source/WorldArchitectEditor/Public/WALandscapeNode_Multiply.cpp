@@ -4,25 +4,30 @@
 
 
 
-TArray<uint16> UWALandscapeNode_Multiply::GenerateHeightmap()
+void UWALandscapeNode_Multiply::GetInputs(TArray<UWALandscapeNode*>& OutInputs) const
 {
-	TArray<uint16> OutputA;
-	TArray<uint16> OutputB;
-	TArray<uint16> RetVal;
+	OutInputs.Add(InputA);
+	OutInputs.Add(InputB);
+}
 
-	if (InputA && InputB)
+const TArray<uint16>* UWALandscapeNode_Multiply::EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out)
+{
+	const TArray<uint16>* OutputA = Inputs[0];
+	const TArray<uint16>* OutputB = Inputs[1];
+	if (!OutputA || !OutputB)
 	{
-		OutputA = InputA->GenerateHeightmap();
-	
-		OutputB = InputB->GenerateHeightmap();
-	
-		
-		RetVal.Init(0, OutputA.Num());
-		for (int32 Idx = 0; Idx < OutputA.Num(); Idx++)
-		{
-			RetVal[Idx] = OutputA[Idx] * OutputB[Idx];
-		}
+		Out.Reset();
+		return &Out;
+	}
 
+	const int32 Num = FMath::Min(OutputA->Num(), OutputB->Num());
+	Out.SetNumUninitialized(Num, false);
+	const uint16* A = OutputA->GetData();
+	const uint16* B = OutputB->GetData();
+	uint16* RetVal = Out.GetData();
+	for (int32 Idx = 0; Idx < Num; Idx++)
+	{
+		RetVal[Idx] = A[Idx] * B[Idx];
 	}
-	return RetVal;
+	return &Out;
 }
@@ -13,9 +13,6 @@ UCLASS()
 class WORLDARCHITECTEDITOR_API UWALandscapeNode_Multiply : public UWALandscapeNode
 {
 	GENERATED_BODY()
-protected:
-	TArray<uint16> InputACache;
-	TArray<uint16> InputBCache;
 public:
 	UPROPERTY(BlueprintReadOnly, Category = "GenericGraphNode")
 		UWALandscapeNode* InputA;
@@ -24,6 +21,7 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "GenericGraphNode")
 		UWALandscapeNode* Output;
 
-	virtual TArray<uint16> GenerateHeightmap() override;
+	virtual void GetInputs(TArray<UWALandscapeNode*>& OutInputs) const override;
+	virtual const TArray<uint16>* EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out) override;
 	
 };
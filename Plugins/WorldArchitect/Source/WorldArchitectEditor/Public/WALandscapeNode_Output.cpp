@@ -5,12 +5,17 @@
 
 
 
-TArray<uint16> UWALandscapeNode_Output::GenerateHeightmap()
+void UWALandscapeNode_Output::GetInputs(TArray<UWALandscapeNode*>& OutInputs) const
 {
-	TArray<uint16> RetVal;
-	if (Heightmap)
+	OutInputs.Add(Heightmap);
+}
+
+const TArray<uint16>* UWALandscapeNode_Output::EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out)
+{
+	if (Inputs[0])
 	{
-		RetVal = Heightmap->GenerateHeightmap();
+		return Inputs[0];
 	}
-	return RetVal;
-}
\ No newline at end of file
+	Out.Reset();
+	return &Out;
+}
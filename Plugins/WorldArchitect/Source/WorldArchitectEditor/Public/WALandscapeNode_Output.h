@@ -14,11 +14,11 @@ class WORLDARCHITECTEDITOR_API UWALandscapeNode_Output : public UWALandscapeNode
 {
 	GENERATED_BODY()
 public:
-	TArray<uint16> CachedHeightmap;
-
 	UPROPERTY(BlueprintReadOnly, Category = "GenericGraphNode")
 		UWALandscapeNode* Heightmap;
 
 public:
-	virtual TArray<uint16> GenerateHeightmap() override;
+	virtual void GetInputs(TArray<UWALandscapeNode*>& OutInputs) const override;
+	/* Passes input through, without copying it. */
+	virtual const TArray<uint16>* EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out) override;
 };
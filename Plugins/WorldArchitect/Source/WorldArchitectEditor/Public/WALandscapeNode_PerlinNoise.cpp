@@ -1,18 +1,52 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "WALandscapeNode_PerlinNoise.h"
+#include "Runtime/WALandscapeGraph.h"
+#include "Async/ParallelFor.h"
 
+UWALandscapeNode_PerlinNoise::UWALandscapeNode_PerlinNoise()
+	: Octaves(16)
+	, PeriodX(4)
+	, PeriodY(4)
+	, Amplitude(20000.f)
+{
+}
 
-
-TArray<uint16> UWALandscapeNode_PerlinNoise::GenerateHeightmap()
+const TArray<uint16>* UWALandscapeNode_PerlinNoise::EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out)
 {
-	TArray<uint16> RetVal;
-	if (bDirty)
-	{
-		return RetVal;
-	}
-	else
+	UWALandscapeGraph* Graph = GetGraph();
+	const int32 cols = Graph ? Graph->SizeX : 0;
+	const int32 rows = Graph ? Graph->SizeY : 0;
+
+	//reuses allocation from previous evaluation.
+	Out.SetNumUninitialized(cols * rows, false);
+	uint16* HeightData = Out.GetData();
+	ParallelFor(rows, [&](int32 Row)
 	{
-		return CachedHeightmap;
-	}
+		MS_ALIGN(16) float nx[4] GCC_ALIGN(16);
+		MS_ALIGN(16) float ny[4] GCC_ALIGN(16);
+		MS_ALIGN(16) float Noise[4] GCC_ALIGN(16);
+
+		const float RowY = Row / (float)rows; //normalized row
+		for (int32 Lane = 0; Lane < 4; Lane++)
+		{
+			ny[Lane] = RowY;
+		}
+		for (int32 Col = 0; Col < cols; Col += 4)
+		{
+			const int32 Lanes = FMath::Min(4, cols - Col);
+			for (int32 Lane = 0; Lane < 4; Lane++)
+			{
+				nx[Lane] = FMath::Min(Col + Lane, cols - 1) / (float)cols; //normalized col
+			}
+			FNoise::pnoiseOctaves4(nx, ny, Octaves, PeriodX, PeriodY, Noise);
+
+			uint16* RowData = HeightData + Row * cols + Col;
+			for (int32 Lane = 0; Lane < Lanes; Lane++)
+			{
+				RowData[Lane] = FMath::Clamp<float>((USHRT_MAX / 2.f) + (Noise[Lane] * Amplitude), 0.f, USHRT_MAX);
+			}
+		}
+	});
+	return &Out;
 }
@@ -15,9 +15,19 @@ class WORLDARCHITECTEDITOR_API UWALandscapeNode_PerlinNoise : public UWALandscap
 {
 	GENERATED_BODY()
 public:
-	TArray<uint16> CachedHeightmap;
+	UPROPERTY(EditAnywhere, Category = "Noise")
+		int32 Octaves;
+	UPROPERTY(EditAnywhere, Category = "Noise")
+		int32 PeriodX;
+	UPROPERTY(EditAnywhere, Category = "Noise")
+		int32 PeriodY;
+	UPROPERTY(EditAnywhere, Category = "Noise")
+		float Amplitude;
+
 public:
-	virtual TArray<uint16> GenerateHeightmap() override;
+	UWALandscapeNode_PerlinNoise();
+
+	virtual const TArray<uint16>* EvaluateNode(const TArray<const TArray<uint16>*>& Inputs, TArray<uint16>& Out) override;
 
 	uint16 PerlinNoise2D(float x, float y, float amp, int32 octaves, int32 px, int32 py)
 	{
@@ -26,4 +26,102 @@ unsigned char FNoise::perm[] = { 151,160,137,91,90,15,
 251,34,242,193,238,210,144,12,191,179,162,241, 81,51,145,235,249,14,239,107,
 49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,150,254,
 138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
-};
\ No newline at end of file
+};
+namespace
+{
+	/*
+	* Gradient for hash & 7, split into x and y factors, so grad(hash, x, y) == GradX * x + GradY * y.
+	* Factors are only +-1 and +-2, so products are exact and result matches scalar grad() bit for bit.
+	*/
+	const float GradX[8] = { 1.0f, -1.0f, 1.0f, -1.0f, 2.0f, 2.0f, -2.0f, -2.0f };
+	const float GradY[8] = { 2.0f, 2.0f, -2.0f, -2.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+
+	// same operation order as FADE
+	FORCEINLINE VectorRegister VectorFade(const VectorRegister& T)
+	{
+		const VectorRegister T3 = VectorMultiply(VectorMultiply(T, T), T);
+		const VectorRegister Inner = VectorSubtract(VectorMultiply(T, VectorSetFloat1(6.0f)), VectorSetFloat1(15.0f));
+		return VectorMultiply(T3, VectorAdd(VectorMultiply(T, Inner), VectorSetFloat1(10.0f)));
+	}
+
+	// same operation order as LERP
+	FORCEINLINE VectorRegister VectorNoiseLerp(const VectorRegister& T, const VectorRegister& A, const VectorRegister& B)
+	{
+		return VectorAdd(A, VectorMultiply(T, VectorSubtract(B, A)));
+	}
+
+	FORCEINLINE VectorRegister VectorGrad(const float* GX, const float* GY, const VectorRegister& X, const VectorRegister& Y)
+	{
+		return VectorAdd(VectorMultiply(VectorLoadAligned(GX), X), VectorMultiply(VectorLoadAligned(GY), Y));
+	}
+}
+
+void FNoise::pnoise4(const float* x, const float* y, int px, int py, float* Out)
+{
+	MS_ALIGN(16) float fx0[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float fy0[4] GCC_ALIGN(16);
+	// gradient factors for corners (x0, y0), (x0, y1), (x1, y0), (x1, y1)
+	MS_ALIGN(16) float gx[4][4] GCC_ALIGN(16);
+	MS_ALIGN(16) float gy[4][4] GCC_ALIGN(16);
+
+	// permutation lookups are gathers, so hashing is done per lane, everything else is vectorized.
+	for (int Lane = 0; Lane < 4; Lane++)
+	{
+		int ix0 = FASTFLOOR(x[Lane]);
+		int iy0 = FASTFLOOR(y[Lane]);
+		fx0[Lane] = x[Lane] - ix0;
+		fy0[Lane] = y[Lane] - iy0;
+		const int ix1 = ((ix0 + 1) % px) & 0xff;
+		const int iy1 = ((iy0 + 1) % py) & 0xff;
+		ix0 = (ix0 % px) & 0xff;
+		iy0 = (iy0 % py) & 0xff;
+
+		const int Hash[4] = {
+			perm[ix0 + perm[iy0]] & 7,
+			perm[ix0 + perm[iy1]] & 7,
+			perm[ix1 + perm[iy0]] & 7,
+			perm[ix1 + perm[iy1]] & 7
+		};
+		for (int Corner = 0; Corner < 4; Corner++)
+		{
+			gx[Corner][Lane] = GradX[Hash[Corner]];
+			gy[Corner][Lane] = GradY[Hash[Corner]];
+		}
+	}
+
+	const VectorRegister One = VectorSetFloat1(1.0f);
+	const VectorRegister FX0 = VectorLoadAligned(fx0);
+	const VectorRegister FY0 = VectorLoadAligned(fy0);
+	const VectorRegister FX1 = VectorSubtract(FX0, One);
+	const VectorRegister FY1 = VectorSubtract(FY0, One);
+
+	const VectorRegister T = VectorFade(FY0);
+	const VectorRegister S = VectorFade(FX0);
+
+	const VectorRegister N0 = VectorNoiseLerp(T, VectorGrad(gx[0], gy[0], FX0, FY0), VectorGrad(gx[1], gy[1], FX0, FY1));
+	const VectorRegister N1 = VectorNoiseLerp(T, VectorGrad(gx[2], gy[2], FX1, FY0), VectorGrad(gx[3], gy[3], FX1, FY1));
+
+	VectorStore(VectorMultiply(VectorSetFloat1(0.507f), VectorNoiseLerp(S, N0, N1)), Out);
+}
+
+void FNoise::pnoiseOctaves4(const float* x, const float* y, int octaves, int px, int py, float* Out)
+{
+	MS_ALIGN(16) float ox[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float oy[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float on[4] GCC_ALIGN(16);
+
+	const VectorRegister X = VectorMultiply(VectorLoad(x), VectorSetFloat1((float)px));
+	const VectorRegister Y = VectorMultiply(VectorLoad(y), VectorSetFloat1((float)py));
+	VectorRegister Sum = VectorZero();
+	for (int octave = 1; octave < octaves; octave *= 2)
+	{
+		const VectorRegister Octave = VectorSetFloat1((float)octave);
+		VectorStoreAligned(VectorMultiply(X, Octave), ox);
+		VectorStoreAligned(VectorMultiply(Y, Octave), oy);
+		pnoise4(ox, oy, px, py, on);
+
+		// octave is power of two, so multiplying by it's reciprocal is exact and same as dividing.
+		Sum = VectorAdd(Sum, VectorMultiply(VectorLoadAligned(on), VectorSetFloat1(1.0f / octave)));
+	}
+	VectorStore(Sum, Out);
+}
@@ -2,7 +2,7 @@
 
 #pragma once
 
-
+#include "CoreMinimal.h"
 
 class FNoise
 {
@@ -180,6 +180,18 @@ public:
 	}
 
 
+	//---------------------------------------------------------------------
+	/** 2D float Perlin periodic noise for four samples at once.
+	* Gives exactly the same values as calling pnoise(x, y, px, py) for every sample.
+	* x, y and Out must point to at least four floats.
+	*/
+	static void pnoise4(const float* x, const float* y, int px, int py, float* Out);
+
+	/** Sum of 2D periodic noise octaves (1, 2, 4 ... below octaves), each scaled by 1 / octave,
+	* for four samples at once. Octave frequencies are x * px * octave and y * py * octave.
+	*/
+	static void pnoiseOctaves4(const float* x, const float* y, int octaves, int px, int py, float* Out);
+
 	//---------------------------------------------------------------------
 	/** 3D float Perlin noise.
 	*/
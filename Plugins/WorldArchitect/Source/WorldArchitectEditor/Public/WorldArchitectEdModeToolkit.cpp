@@ -17,6 +17,8 @@
 #include "WALandscapeGraphFactory.h"
 #include "LandscapeGraphEditor/WALandscapeGraphSchema.h"
 #include "LandscapeGraphEditor/WALandscapeGraphEdNode_Output.h"
+#include "Async/ParallelFor.h"
+#include "WANoise.h"
 
 // Noise1234
 // Author: Stefan Gustavson (stegu@itn.liu.se)
@@ -729,37 +731,46 @@ FReply FWorldArchitectEdModeToolkit::OnGenerateNoise()
 	{
 		FIntRect bounds = Landscapes[0]->GetBoundingRect();
 
-		int32 numHeights = (bounds.Width() + 1)*(bounds.Height() + 1);
-		TArray<uint16> Data; 
-		Data.Init(0, numHeights); 
-		TArray<float> DataFloat;
-		DataFloat.Init(0, numHeights);
-		TArray<float> DataFloat2;
-		DataFloat2.Init(0, numHeights);
-		TArray<float> DataFloat3;
-		DataFloat3.Init(0, numHeights);
-
 		int32 cols = bounds.Width() + 1, rows = bounds.Height() + 1;
 		int32 octaves = 16, px = 4, py = 4;
 		float amplitude = 20000.f;
-		//for (int i = 0; i < Data.Num(); i++) 
-		//{
-		//	float nx = (i % cols) / (float)cols; //normalized col
-		//	float ny = (i / cols) / (float)rows; //normalized row
-		//	Data[i] = FMath::Clamp<uint16>(PerlinNoise2D(nx, ny, amplitude, octaves, px, py), 0, 32768);
-		//}
-		for (int i = 0; i < DataFloat.Num(); i++)
-		{
-			float nx = (i % cols) / (float)cols; //normalized col
-			float ny = (i / cols) / (float)rows; //normalized row
-			DataFloat[i] = PerlinNoise2DFloat(nx, ny, amplitude, octaves, px, py);
-			DataFloat2[i] = PerlinNoise2DFloat(nx, ny, amplitude, 4, 12, 12);
-			DataFloat3[i] = DataFloat[i] * DataFloat2[i];
-		}
-		for (int i = 0; i < Data.Num(); i++)
+
+		TArray<uint16> Data;
+		Data.SetNumUninitialized(cols * rows);
+		uint16* HeightData = Data.GetData();
+		//every row is written by single task and every sample is computed on it's own,
+		//so result is the same no matter how rows are split between threads.
+		ParallelFor(rows, [&](int32 Row)
 		{
-			Data[i] = (USHRT_MAX / 2.f) + (DataFloat3[i] * amplitude);
-		}
+			MS_ALIGN(16) float nx[4] GCC_ALIGN(16);
+			MS_ALIGN(16) float ny[4] GCC_ALIGN(16);
+			MS_ALIGN(16) float Base[4] GCC_ALIGN(16);
+			MS_ALIGN(16) float Detail[4] GCC_ALIGN(16);
+
+			const float RowY = Row / (float)rows; //normalized row
+			for (int32 Lane = 0; Lane < 4; Lane++)
+			{
+				ny[Lane] = RowY;
+			}
+			for (int32 Col = 0; Col < cols; Col += 4)
+			{
+				//lanes past last column repeat it, they are computed but not stored.
+				const int32 Lanes = FMath::Min(4, cols - Col);
+				for (int32 Lane = 0; Lane < 4; Lane++)
+				{
+					nx[Lane] = FMath::Min(Col + Lane, cols - 1) / (float)cols; //normalized col
+				}
+				FNoise::pnoiseOctaves4(nx, ny, octaves, px, py, Base);
+				FNoise::pnoiseOctaves4(nx, ny, 4, 12, 12, Detail);
+
+				uint16* RowData = HeightData + Row * cols + Col;
+				for (int32 Lane = 0; Lane < Lanes; Lane++)
+				{
+					const float Combined = Base[Lane] * Detail[Lane];
+					RowData[Lane] = (USHRT_MAX / 2.f) + (Combined * amplitude);
+				}
+			}
+		});
 		ULandscapeInfo::RecreateLandscapeInfo(GetEditorMode()->GetWorld(), 1);
 		LandscapeEditorUtils::SetHeightmapData(Landscapes[0], Data);
 		ULandscapeInfo::RecreateLandscapeInfo(GetEditorMode()->GetWorld(), 1);
@@ -815,15 +826,10 @@ FReply FWorldArchitectEdModeToolkit::OnGenerateLandscape()
 	if(!LandscapeGraph.IsValid())
 		return FReply::Unhandled();
 
-	//LandscapeGraph->GenerateLandscape();
-	if (!LandscapeGraph->Schema)
-		return FReply::Unhandled();
-
-	if (!LandscapeGraph->Schema->Output)
+	if (!LandscapeGraph->LandscapeOutput)
 		return FReply::Unhandled();
 
-	TArray<uint16> Out;
-	LandscapeGraph->Schema->Output->GenerateHeightMap(Out);
+	LandscapeGraph->GenerateLandscape();
 	return FReply::Handled();
 }
 void FWorldArchitectEdModeToolkit::OnAssetSelected(const FAssetData& InAssetData)
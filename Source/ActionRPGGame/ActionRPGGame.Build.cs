@@ -29,7 +29,8 @@ public class ActionRPGGame : ModuleRules
             "ActorSequence",
             "JsonUObject",
             "InventoryFramework",
-            "OnlineSubsystem"
+            "OnlineSubsystem",
+            "AIModule"
         });
 
         if (Target.Type == TargetRules.TargetType.Editor)
@@ -2,6 +2,9 @@
 
 #include "ARAICharacter.h"
 #include "AREnemySpawner.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 
 // Sets default values
 AARAICharacter::AARAICharacter()
@@ -22,6 +25,45 @@ void AARAICharacter::OnSpawned(class AAREnemySpawner* InSpawnedBy)
 {
 	SpawnedBy = InSpawnedBy;
 }
+void AARAICharacter::OnReturnedToPool()
+{
+	SpawnedBy = nullptr;
+	//controller stays possessed, so it does not need to be spawned again.
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		AIController->StopMovement();
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->StopLogic(TEXT("Returned to pool"));
+		}
+	}
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	EffectsComponent->ResetEffects();
+	Abilities->ResetAttributes();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	Abilities->SetComponentTickEnabled(false);
+}
+void AARAICharacter::OnTakenFromPool()
+{
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	Abilities->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->RestartLogic();
+		}
+	}
+}
 // Called every frame
 void AARAICharacter::Tick(float DeltaTime)
 {
@@ -38,8 +80,12 @@ void AARAICharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 
 void AARAICharacter::Kill()
 {
-	if(SpawnedBy)
+	//spawner decides if character goes back to pool or is destroyed.
+	if (SpawnedBy)
+	{
 		SpawnedBy->OnEnemyKilled(this);
+		return;
+	}
 
 	Destroy();
 }
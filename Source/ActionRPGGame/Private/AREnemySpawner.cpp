@@ -14,15 +14,76 @@ AAREnemySpawner::AAREnemySpawner()
 	BatchSpawn = 1;
 	TimeBetweenSpawns = 0.3;
 	MinRespawn = 4;
+	PoolWarmUp = 0;
+	MaxPooled = 7;
 }
 
 // Called when the game starts or when spawned
 void AAREnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
+	WarmUpPool();
 	SetupSpawner();
 }
 
+void AAREnemySpawner::WarmUpPool()
+{
+	if (Role != ROLE_Authority || !EnemyClass)
+		return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 WarmUpNum = FMath::Min(PoolWarmUp, MaxPooled);
+	PooledEnemies.Reserve(WarmUpNum);
+	for (int32 Idx = 0; Idx < WarmUpNum; Idx++)
+	{
+		AARAICharacter* Enemy = GetWorld()->SpawnActor<AARAICharacter>(EnemyClass, GetActorTransform(), SpawnParams);
+		if (!Enemy)
+			continue;
+		Enemy->OnReturnedToPool();
+		PooledEnemies.Add(Enemy);
+	}
+}
+
+AARAICharacter* AAREnemySpawner::AcquireEnemy(const FTransform& InTransform)
+{
+	while (PooledEnemies.Num() > 0)
+	{
+		AARAICharacter* Enemy = PooledEnemies.Pop(false);
+		if (!Enemy || Enemy->IsPendingKill())
+			continue;
+
+		Enemy->SetActorTransform(InTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		Enemy->OnTakenFromPool();
+		return Enemy;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AARAICharacter>(EnemyClass, InTransform, SpawnParams);
+}
+
+void AAREnemySpawner::ReleaseKilledEnemies()
+{
+	for (AARAICharacter* Enemy : KilledEnemies)
+	{
+		if (!Enemy || Enemy->IsPendingKill())
+			continue;
+
+		if (PooledEnemies.Num() < MaxPooled)
+		{
+			Enemy->OnReturnedToPool();
+			PooledEnemies.Add(Enemy);
+		}
+		else
+		{
+			Enemy->Destroy();
+		}
+	}
+	KilledEnemies.Reset();
+}
+
 void AAREnemySpawner::SetupSpawner()
 {
 	if (Role == ROLE_Authority)
@@ -42,10 +103,16 @@ void AAREnemySpawner::Tick(float DeltaTime)
 
 void AAREnemySpawner::OnEnemyKilled(AARAICharacter* InEnemy)
 {
-	if (SpawnedEnemies.Num() > 0)
+	//enemy can be killed more than once, before it's released.
+	if (SpawnedEnemies.Remove(InEnemy) == 0)
+		return;
+
+	if (KilledEnemies.Num() == 0)
 	{
-		SpawnedEnemies.Remove(InEnemy);
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &AAREnemySpawner::ReleaseKilledEnemies);
 	}
+	KilledEnemies.Add(InEnemy);
+
 	if (SpawnedEnemies.Num() < MinRespawn)
 	{
 		SetupSpawner();
@@ -65,10 +132,6 @@ void AAREnemySpawner::HandleSpawn()
 		return;
 	}
 
-
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	
 	for (int32 Idx = 0; Idx < BatchSpawn; Idx++)
 	{
 		FTransform Transform;
@@ -76,7 +139,9 @@ void AAREnemySpawner::HandleSpawn()
 		Transform.SetLocation(SpawnPos);
 		Transform.SetScale3D(FVector(1));
 
-		AARAICharacter* Enemy = GetWorld()->SpawnActor<AARAICharacter>(EnemyClass, Transform, SpawnParams);
+		AARAICharacter* Enemy = AcquireEnemy(Transform);
+		if (!Enemy)
+			continue;
 		Enemy->OnSpawned(this);
 		SpawnedEnemies.Add(Enemy);
 	}
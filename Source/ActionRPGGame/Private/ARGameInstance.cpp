@@ -59,14 +59,31 @@ void UARGameInstance::Init()
 	}
 
 #if WITH_AGONES
-	if (IAgones::Get().AgonesSDK->Connect())
+	//sdk calls are made on agones worker thread, results come back on game thread.
+	IAgones::Get().Connect(FAgonesCompleteDelegate::CreateUObject(this, &UARGameInstance::OnAgonesConnected));
+#endif
+}
+#if WITH_AGONES
+void UARGameInstance::OnAgonesConnected(bool bConnected)
+{
+	if (!bConnected)
 	{
-		grpc::Status statuc = IAgones::Get().AgonesSDK->Ready();
-		FTimerDelegate HealthCheckDel = FTimerDelegate::CreateUObject(this, &UARGameInstance::HealthCheck);
-		TimerManager->SetTimer(HealthCheckHandle, HealthCheckDel, 1, true, 1);
+		UE_LOG(LogTemp, Warning, TEXT("UARGameInstance - Could not connect to Agones sidecar."));
+		return;
 	}
-#endif
+	IAgones::Get().Ready(FAgonesCompleteDelegate::CreateUObject(this, &UARGameInstance::OnAgonesReady));
+	FTimerDelegate HealthCheckDel = FTimerDelegate::CreateUObject(this, &UARGameInstance::HealthCheck);
+	TimerManager->SetTimer(HealthCheckHandle, HealthCheckDel, 1, true, 1);
 }
+
+void UARGameInstance::OnAgonesReady(bool bReady)
+{
+	if (!bReady)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UARGameInstance - Agones Ready failed."));
+	}
+}
+#endif
 #if WITH_EDITOR
 
 /* Called to actually start the game when doing Play/Simulate In Editor */
@@ -97,6 +114,6 @@ void UARGameInstance::TestGSRequest()
 void UARGameInstance::HealthCheck()
 {
 #if WITH_AGONES
-	IAgones::Get().AgonesSDK->Health();
+	IAgones::Get().Health();
 #endif
 }
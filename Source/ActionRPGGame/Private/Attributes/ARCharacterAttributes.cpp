@@ -8,16 +8,24 @@ UARCharacterAttributes::UARCharacterAttributes(const FObjectInitializer& ObjectI
 
 }
 
-void UARCharacterAttributes::GetLifetimeReplicatedProps(TArray< class FLifetimeProperty > & OutLifetimeProps) const
+void UARCharacterAttributes::GetQuantizedAttributes(TArray<FAFQuantizedAttribute>& OutAttributes) const
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(UARCharacterAttributes, Health);
-	DOREPLIFETIME(UARCharacterAttributes, Shield);
-	DOREPLIFETIME(UARCharacterAttributes, Armor);
-	DOREPLIFETIME(UARCharacterAttributes, Energy);
-	DOREPLIFETIME(UARCharacterAttributes, Stamina);
-	DOREPLIFETIME(UARCharacterAttributes, Ammo);
-	DOREPLIFETIME(UARCharacterAttributes, MachineGunAmmo);
+	Super::GetQuantizedAttributes(OutAttributes);
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Health), 0.1f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Shield), 0.1f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Armor), 0.1f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Energy), 0.1f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Stamina), 0.1f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Ammo), 1.0f));
+	OutAttributes.Add(FAFQuantizedAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, MachineGunAmmo), 1.0f));
+}
+
+void UARCharacterAttributes::PostQuantizedAttributesReceived(const TArray<int32>& InChangedAttributes)
+{
+	if (InChangedAttributes.Contains(GetAttributeIndex(FGAAttribute(GET_MEMBER_NAME_CHECKED(UARCharacterAttributes, Health)))))
+	{
+		OnRep_Health();
+	}
 }
 
 void UARCharacterAttributes::OnRep_Health()
@@ -21,6 +21,8 @@ AARHUD::AARHUD(const FObjectInitializer& ObjectInitializer)
 {
 	UIInventoryComponent = ObjectInitializer.CreateDefaultSubobject<UARUIInventoryComponent>(this, TEXT("UIInventoryComponent"));
 	DistanceScaleEnemyBar = 1000.0f;
+	EnemyTraceInterval = 0;
+	LastEnemyTraceTime = 0;
 	HUDFloatingCombatTextClass = UARHUDFloatingCombatText::StaticClass();
 
 }
@@ -110,6 +112,27 @@ float AARHUD::ComputeBoundsScreenSize(AActor* InTarget)
 }
 void AARHUD::SetEnemyHitResult()
 {
+	UWorld* World = GetWorld();
+	if (EnemyTraceHandle.IsValid())
+	{
+		FTraceDatum TraceData;
+		if (World->QueryTraceData(EnemyTraceHandle, TraceData))
+		{
+			EnemyHitResult = TraceData.OutHits.Num() > 0 ? TraceData.OutHits[0] : FHitResult();
+		}
+		else if (World->IsTraceHandleValid(EnemyTraceHandle, false))
+		{
+			//not finished yet, keep using last result.
+			return;
+		}
+		EnemyTraceHandle = FTraceHandle();
+	}
+
+	const float CurrentTime = World->GetTimeSeconds();
+	if (EnemyTraceInterval > 0 && CurrentTime - LastEnemyTraceTime < EnemyTraceInterval)
+		return;
+	LastEnemyTraceTime = CurrentTime;
+
 	FVector Start = ARCharacter->GetFollowCamera()->GetComponentLocation();
 	FVector Forward = ARCharacter->GetFollowCamera()->GetForwardVector();
 	FVector End = (Forward * 10000.0) + Start;
@@ -118,8 +141,7 @@ void AARHUD::SetEnemyHitResult()
 	Params.AddIgnoredActor(ARCharacter);
 	Params.bTraceComplex = false;
 	Params.OwnerTag = TEXT("HUDLineTrace");
-	//make async ?
-	GetWorld()->LineTraceSingleByChannel(EnemyHitResult, Start, End, CollisionChannel, Params);
+	EnemyTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, CollisionChannel, Params);
 }
 void AARHUD::UpdateEnemyBarInfo()
 {
@@ -80,17 +80,14 @@ bool UARItemWeapon::SpawnAbility()
 		return true;
 
 	AARCharacter* Character = nullptr;
-	if (UIFInventoryComponent* InventoryComp = Cast<UIFInventoryComponent>(GetOuter()))
+	if(UIFEquipmentComponent* EquipComp = Cast<UIFEquipmentComponent>(GetOuter()))
 	{
-		AARPlayerController* PC = Cast<AARPlayerController>(InventoryComp->GetOwner());
-		if (!PC)
-			return bSpawned;
-
-		Character = Cast<AARCharacter>(PC->GetPawn());
+		Character = Cast<AARCharacter>(EquipComp->GetOwner());
 	}
-	else if(UIFEquipmentComponent* EquipComp = Cast<UIFEquipmentComponent>(GetOuter()))
+	//inventory items are outered to inventory component on server, but to owning actor on client.
+	else if (AARPlayerController* PC = Cast<AARPlayerController>(GetOwningActor()))
 	{
-		Character = Cast<AARCharacter>(EquipComp->GetOwner());
+		Character = Cast<AARCharacter>(PC->GetPawn());
 	}
 	
 	if (!Character)
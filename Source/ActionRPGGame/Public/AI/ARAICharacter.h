@@ -36,6 +36,14 @@ protected:
 
 	virtual void OnSpawned(class AAREnemySpawner* InSpawnedBy);
 
+	/*
+		Called by spawner when character is put back into pool, instead of being destroyed.
+		Hides character, stops AI and clears attributes and effects, so it's ready for reuse.
+	*/
+	virtual void OnReturnedToPool();
+	/* Called by spawner when pooled character is placed back into world. */
+	virtual void OnTakenFromPool();
+
 	
 public:
 	virtual void Kill();
@@ -29,8 +29,31 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Enemy")
 		int32 MinRespawn;
 
+	/*
+		Number of enemies spawned when spawner begins play and kept deactivated until needed.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Enemy|Pool")
+		int32 PoolWarmUp;
+
+	/*
+		Maximum number of killed enemies kept for reuse. Enemies killed above this limit are destroyed.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Enemy|Pool")
+		int32 MaxPooled;
+
 	TSet<AARAICharacter*> SpawnedEnemies;
 
+	/* Deactivated enemies ready for reuse. */
+	UPROPERTY(Transient)
+		TArray<AARAICharacter*> PooledEnemies;
+
+	/*
+		Enemies killed during this frame. They are returned to pool on next tick, since
+		they are usually killed in middle of applying effect.
+	*/
+	UPROPERTY(Transient)
+		TArray<AARAICharacter*> KilledEnemies;
+
 	FTimerHandle SpawnerHandle;
 
 public:	
@@ -43,6 +66,11 @@ protected:
 
 	void SetupSpawner();
 
+	void WarmUpPool();
+	/* Takes enemy from pool and moves it to InTransform, or spawns new one if pool is empty. */
+	AARAICharacter* AcquireEnemy(const FTransform& InTransform);
+	void ReleaseKilledEnemies();
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
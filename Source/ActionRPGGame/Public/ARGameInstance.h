@@ -60,6 +60,9 @@ public:
 protected:
 #if WITH_AGONES
 	FTimerHandle HealthCheckHandle;
+
+	void OnAgonesConnected(bool bConnected);
+	void OnAgonesReady(bool bReady);
 #endif
 	UFUNCTION()
 		void HealthCheck();
@@ -15,20 +15,20 @@ class ACTIONRPGGAME_API UARCharacterAttributes : public UGAAttributesBase
 	GENERATED_BODY()
 
 public:
-	UPROPERTY(EditAnywhere, ReplicatedUsing=OnRep_Health, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Health;
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Shield;
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Armor;
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Energy;
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Stamina;
 
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase Ammo;
-	UPROPERTY(EditAnywhere, Replicated, Category = "Base")
+	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase MachineGunAmmo;
 	UPROPERTY(EditAnywhere, Category = "Base")
 		FAFAttributeBase ShotgunAmmo;
@@ -38,6 +38,9 @@ public:
 
 	UARCharacterAttributes(const FObjectInitializer& ObjectInitializer);
 
+	virtual void GetQuantizedAttributes(TArray<FAFQuantizedAttribute>& OutAttributes) const override;
+	virtual void PostQuantizedAttributesReceived(const TArray<int32>& InChangedAttributes) override;
+
 	UFUNCTION()
 		void OnRep_Health();
 
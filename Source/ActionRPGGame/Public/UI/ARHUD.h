@@ -24,6 +24,11 @@ protected:
 		TEnumAsByte<ETraceTypeQuery> EnemyChannel;
 	UPROPERTY(EditAnywhere, Category = "Enemy Info")
 		float DistanceScaleEnemyBar;
+	/*
+		Minimum time between enemy traces, in seconds. 0 traces every frame.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Enemy Info")
+		float EnemyTraceInterval;
 
 	UPROPERTY(BlueprintReadOnly, Category = "Enemy Info")
 		class UARHUDEnemyHealthBar* HUDEnemyHealthBar;
@@ -45,6 +50,9 @@ protected:
 		class AARPlayerController* ARPC;
 
 	FHitResult EnemyHitResult;
+	/* Async trace in flight. Result is consumed one frame after it has been requested. */
+	FTraceHandle EnemyTraceHandle;
+	float LastEnemyTraceTime;
 public:
 	AARHUD(const FObjectInitializer& ObjectInitializer);
 